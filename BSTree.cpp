@@ -1,485 +1,2971 @@
-// BSTree.cpp		Author: Sam Hoover
-// contains the declarations for the BSTree class
-//
-#ifndef BSTREE_CPP
-#define BSTREE_CPP
-#include "BSTree.h"
-
-// BSTree::Node default constructor
-// preconditions:	none
-// postconditions:	creates a node with m_item, m_left, and m_right 
-//					equal to nullptr, and m_itemCount equal to 0.
-//
-BSTree::Node::Node() : m_item(nullptr), m_itemCount(0), m_left(nullptr), m_right(nullptr) {}
-
-// BSTree::Node constructor(TreeData *data)
-// preconditions:	none
-// postconditions:	Creates a node with m_left and m_right are set
-//					equal to nullptr. If data is not nullptr, a node 
-//					with m_item equal to data & m_itemCount equal to 1.
-//					If data is nullptr then m_item, m_left, and m_right 
-//					are set equal to nullptr, and m_itemCount to 0.
-//
-BSTree::Node::Node(TreeData *data) : m_left(nullptr), m_right(nullptr) { 
-	if(data != nullptr)  {
-		m_item = data;
-		m_itemCount = 1;
-	} else {
-		m_item = nullptr;
-		m_itemCount = 0;
-	}
-}
-
-// BSTree::Node copy constructor (deep copy)
-// preconditions:	none
-// postconditions:	this becomes an identical copy of node, creating
-//					new data
-//
-BSTree::Node::Node(const Node &node) : m_item(new TreeData(*node.m_item)),
-									   m_itemCount(node.m_itemCount), 
-									   m_left(nullptr), 
-									   m_right(nullptr) {}
-
-// BSTree default constructor
-// preconditions:	none
-// postconsitions:	Creates a tree of size zero (m_root equal to nullptr)
-//
-BSTree::BSTree() : m_root(nullptr) {}
-
-// BSTree constructor(TreeData *data)
-// preconditions:	none
-// postconditions:	If data is not a nullptr, then m_root is set to a new
-//					node with m_item equal to data and m_itemCount equal
-//					to one. If data equals nullptr, m_root is set to
-//					nullptr.
-//
-BSTree::BSTree(TreeData *data) {
-	if(data != nullptr) {
-		m_root = new Node(data);
-	} else {
-		m_root = nullptr;
-	}
-}
-
-// copy constructor (deep copy)
-// preconditions:	tree must be a valid BSTree object (must not reference
-//					a dereferenced nullptr)
-// postconditions:	this becomes an identical node-by-node copy of tree,
-//					creating new Nodes and new TreeDatas.
-//
-BSTree::BSTree(const BSTree &tree) {
-	copyNode(m_root, tree.m_root);
-}
-
-// copyNode: copy constructor helper (deep copy)
-// preconditions:	this not equal to nullptr.
-// postconditions:	to becomes an identical copy of from, copying all
-//					decendants. 
-//
-void BSTree::copyNode(Node *&to, Node *from) {
-	if(from == nullptr) {
-		to = nullptr;
-	} else {
-		to = new Node(*from);
-		copyNode(to->m_left, from->m_left);
-		copyNode(to->m_right, from->m_right);
-	}
-}
-
-// destructor
-// preconditions:	none
-// postconditions:	All nodes removed and deleted, m_root set to nullptr
-//
-BSTree::~BSTree() {
-	makeEmpty();
-}
-
-// insert
-// Inserts a pointer to a TreeData object into the tree. If a node  
-// containing the object already exists in the tree, the object's 
-// m_itemCount in incremented by one. For the tree and all subtrees nodes
-// are inserted with the formula: 
-//			node < root = insert left
-//			node >= root = insert right
-// preconditions:	this not equal to nullptr.
-// postconditions:	If data does not already exist in the tree, then a new
-//					node with m_item equal to data is inserted into the
-//					tree. If the data already exists, then m_itemCount is
-//					incremented by one.
-//
-bool BSTree::insert(TreeData *data) {
-	return(insert(data, m_root));
-}
-
-// insert helper
-// Inserts a pointer to a TreeData object into the tree. If a node  
-// containing the object already exists in the tree, the object's 
-// m_itemCount in incremented by one.
-// preconditions:	node->m_item must be a valid TreeData object not equal
-//					to nullptr; this not equal to nullptr.
-// postconditions:	If data does not already exist in the tree, then a new
-//					node with m_item equal to data is inserted into the
-//					tree. If the data already exists, then m_itemCount is
-//					incremented by one.
-//
-bool BSTree::insert(TreeData *data, Node *&node) {
-	if(node == nullptr) {
-		node = new Node(data);
-	} else {
-		if(*data == *node->m_item) {
-			node->m_itemCount++;
-			return(false);
-		}
-		if(*data < *node->m_item) {
-			insert(data, node->m_left);
-		} else {
-			insert(data, node->m_right);
-		}
-	}
-	return(true);
-}
-
-// remove
-// Removes a TreeData object equal to data from the tree. If there is only
-// one TreeData object, the node containing that object is removed and
-// deleted.
-// preconditions:	data must be a valid TreeData object (must not reference
-//					a dereferenced nullptr); this not equal to nullptr.
-// postconditions:	If data is not found, then false is returned. If data
-//					is found and m_itemCount > 1 then m_itemCount is 
-//					decremented by one; if m_itemCount == 1 then the node
-//					is removed from the tree and deleted.
-//
-bool BSTree::remove(const TreeData &data) {
-	return(remove(data, m_root));
-}
-
-// remove helper
-// Removes a TreeData object equal to data from the tree. If there is only
-// one TreeData object, the node containing that object is removed and
-// deleted.
-// preconditions:	node->m_item must be a valid TreeData object not equal
-//					to nullptr; this not equal to nullptr.
-// postconditions:	If data is not found, then false is returned. If data
-//					is found and m_itemCount > 1 then m_itemCount is 
-//					decremented by one; if m_itemCount == 1 then the node
-//					is removed from the tree and deleted.
-//
-bool BSTree::remove(const TreeData &data, Node *&node) {
-	if(node == nullptr) {
-		return(false);
-	} else if(data == *node->m_item) {
-		if(node->m_itemCount > MIN_ITEM_COUNT) {
-			node->m_itemCount--;
-		} else {
-			deleteNode(node);
-		}
-		return(true);
-	} else if(data < *node->m_item) {
-		return(remove(data, node->m_left));
-	} else {
-		return(remove(data, node->m_right));
-	}
-
-	return(false);
-}
-
-// deleteNode: remove helper
-// Deletes a Node with m_item equal to data from the tree.
-// preconditions:	node must be a valid BSTree::Node object not equal to
-//					nullptr; this not equal to nullptr.
-// postconditions:	node is deleted and set to nullptr.
-//
-void BSTree::deleteNode(Node *&node) {
-	if(node->m_left == nullptr && node->m_right == nullptr) {
-		delete node->m_item;
-		node->m_item = nullptr;
-		delete node;
-		node = nullptr;
-	} else if(node->m_left == nullptr) {
-		Node *temp = node;
-		node = node->m_right;
-		delete temp->m_item; 
-		temp->m_item = nullptr;
-		delete temp;
-		temp = nullptr;
-	} else if(node->m_right == nullptr) {
-		Node *temp = node;
-		node = node->m_left;
-		delete temp->m_item;
-		temp->m_item = nullptr;
-		delete temp;
-		temp = nullptr;
-	} else {
-		delete node->m_item;
-		node->m_item = deleteSmallest(node->m_right);
-	}
-}
-
-// deleteSmallest: remove helper
-// Finds and deletes the Node with the smallest m_item from the tree.
-// preconditions:	node must be a valid BSTree::Node object not equal to
-//					nullptr; this not equal to nullptr.
-// postconditions:	node is deleted and set to nullptr.
-//
-TreeData* BSTree::deleteSmallest(Node *&node) {
-	if(node->m_left == nullptr) {
-		TreeData *item = node->m_item;
-		Node *temp = node;
-		node = node->m_right;
-		delete temp;
-		temp = nullptr;
-		return(item);
-	} else {
-		return(deleteSmallest(node->m_left));
-	}
-}
-
-// makeEmpty
-// Removes and deletes all nodes from the tree, and set m_root equal to
-// nullptr.
-// preconditions:	this not equal to nullptr.
-// postconditions:	All nodes removed and deleted, m_root set to nullptr
-//
-void BSTree::makeEmpty() {
-	if(!isEmpty()) {
-		makeEmpty(m_root);
-		m_root = nullptr;
-	}
-}
-
-// makeEmpty helper
-// Removes and deletes all nodes from the tree, and sets m_root equal to
-// nullptr.
-// preconditions:	this not equal to nullptr
-// postconditions:	All nodes removed and deleted, m_root set to nullptr
-//
-void BSTree::makeEmpty(Node *node) {
-	if(node != nullptr) {
-		makeEmpty(node->m_left);
-		makeEmpty(node->m_right);
-		delete node->m_item;
-		node->m_item = nullptr;
-		delete node;
-		node = nullptr;
-	}
-}
-
-// retrieve
-// Searches the tree for data, if found, a const pointer to that object is
-// returned, otherwise false is returned.
-// preconditions:	data must be a valid TreeData object (must not reference
-//					a dereferenced nullptr); this not equal to nullptr.
-// postconditions:	If data is found in the tree, a const pointer to the
-//					is returned. If data is not found them nullptr is
-//					returned.
-//
-const TreeData* BSTree::retrieve(const TreeData &data) const {
-	Node* temp = m_root;
-	while(temp != nullptr) {
-		if(data == *temp->m_item) {
-			return(temp->m_item);
-		} else if(data < *temp->m_item) {
-			temp = temp->m_left;
-		} else {
-			temp = temp->m_right;
-		}
-	}
-	return(nullptr);
-}
-
-// depth
-// Finds the depth of a node with m_item equal to data. Depth of m_root is 
-// equal to zero.
-// preconditions:	data must be a valid TreeData object (must not reference
-//					a dereferenced nullptr); this not equal to nullptr.
-// postconditions:	If data is found in the tree, the depth of the node
-//					containing data is returned. If data is not found then
-//					-1 is returned.
-//
-int BSTree::depth(const TreeData &data) const {
-	int dep = 0;
-	Node* temp = m_root;
-	while(temp != nullptr) {
-		if(data == *temp->m_item) {
-			return(dep);
-		} else if(data < *temp->m_item) {
-			dep++;
-			temp = temp->m_left;
-		} else {
-			dep++;
-			temp = temp->m_right;
-		}
-	}
-	return(VALUE_NOT_FOUND);
-}
-
-// descendants
-// Finds the number of descendants of the node containing data.
-// preconditions:	data must be a valid TreeData object (must not reference
-//					a dereferenced nullptr); this not equal to nullptr.
-// postconditions:	If data is found, the number of descendants are of the
-//					node containing data are counted and returned. If data
-//					is not found, -1 is returned.
-//
-int BSTree::descendants(const TreeData &data) const {
-	const Node* temp = findNode(data);
-	if(temp == nullptr) {
-		return(VALUE_NOT_FOUND);
-	}
-
-	int des = 0;
-	des = descendants(des, temp);
-	return(des);
-}
-
-// descendants helper
-// Finds the number of descendants of the node containing data.
-// preconditions:	data must be a valid TreeData object (must not reference
-//					a dereferenced nullptr); this not equal to nullptr.
-// postconditions:	If data is found, the number of descendants are of the
-//					node containing data are counted and returned. If data
-//					is not found, -1 is returned.
-//
-int BSTree::descendants(int &count, const Node *node) const {
-	if(node != nullptr) {
-		count++;
-		descendants(count, node->m_left);
-		descendants(count, node->m_right);
-	} else {
-		return(-1);
-	}
-	// inital root node is counted, so must decrease couny by one
-	return(count - 1);
-}
-
-// findNode: descendants helper
-// finds a Node with m_item equal to data and retunrs a constant pointer to
-// the Node. If no match is found, nullptr is returned.
-// preconditions:	data must be a valid TreeData object (must not reference
-//					a dereferenced nullptr); this not equal to nullptr.
-// postconditions:	if data is found, then a constant pointer to the Node 
-//					containing data is returned, else false is returned.
-//
-const BSTree::Node* BSTree::findNode(const TreeData &data) const {
-	Node* temp = m_root;
-	while(temp != nullptr) {
-		if(data == *temp->m_item) {
-			return(temp);
-		} else if(data < *temp->m_item) {
-			temp = temp->m_left;
-		} else {
-			temp = temp->m_right;
-		}
-	}
-	return(nullptr);
-}
-
-// isEmpty
-// Returns true is tree is empty, else false
-// preconditions:	this not equal to nullptr.
-// postconditions:	If m_root equals nullptr true is returned, else false
-//
-bool BSTree::isEmpty() const {
-	if(m_root == nullptr) {
-		return(true);
-	}
-	return(false);
-}
-
-// assignment
-// Sets this equal to tree. Performs a deep copy.
-// preconditions:	tree must be a valid BSTree object (must not reference
-//					a dereferenced nullptr); this not equal to nullptr.
-// postconditions:	this becomes an identical node-by-node copy of tree,
-//					creating new Nodes and new TreeDatas.
-//
-const BSTree& BSTree::operator=(const BSTree &tree) {
-	if(this != &tree) {
-		makeEmpty();
-		copyNode(m_root, tree.m_root);
-	}
-	return(*this);
-}
-
-// equality
-// Node-by-node comparison of this and tree. Returns true only if the 
-// trees have the same data (including m_itemCount) and structure
-// preconditions:	tree must be a valid BSTree object (must not reference
-//					a dereferenced nullptr); this not equal to nullptr.
-// postconditions:	If this and tree have same data and structure then true
-//					is returned, else false is returned.
-//
-bool BSTree::operator==(const BSTree &tree) const {
-	if(this == &tree) {
-		return(true);
-	}
-	return(compareNode(m_root, tree.m_root));
-}
-
-// compareNode: equality helper
-// Node-by-node comparison of this and tree. Returns true only if the 
-// trees have the same data (including m_itemCount) and structure
-// preconditions:	this not equal to nullptr
-// postconditions:	If self and other have same data and structure then true
-//					is returned, else false is returned.
-//
-bool BSTree::compareNode(Node *self, Node *other) const {
-	if(self != nullptr && other != nullptr) {
-		if(*self->m_item == *other->m_item && self->m_itemCount == other->m_itemCount) {
-			bool l_retVal = compareNode(self->m_left, other->m_left);
-			bool r_retVal = compareNode(self->m_right, other->m_right);
-			
-			// logical iff
-			if((l_retVal && r_retVal) || (!l_retVal && !r_retVal)) {
-				return(true);
-			}
-		}
-	} else if(self == nullptr && other == nullptr) {
-		return(true);
-	}
-	return(false);
-}
-
-// inequality
-// Node-by-node comparison of this and tree. Returns true only if the 
-// trees do not have the same data (including m_itemCount) and structure
-// preconditions:	tree must be a valid BSTree object (must not reference
-//					a dereferenced nullptr); this not equal to nullptr.
-// postconditions:	If this and tree do not have same data and structure
-//					then true is returned, else false is returned.
-//
-bool BSTree::operator!=(const BSTree &tree) const {
-	if(!(*this == tree)) {
-		return(true);
-	}
-	return(false);
-}
-
-// print: output helper
-// Prints the contents of the tree to sout.
-// preconditions:	none
-// postconditions:	the contents of this are printed to sout. Each line
-//					contains a Node in the format: "m_item m_itemCount"
-//
-void BSTree::print(ostream &sout, Node *node) const {
-	if(node != nullptr) {
-		print(sout, node->m_left);
-		sout << *node->m_item << " " << node->m_itemCount << endl;
-		print(sout, node->m_right);
-	}
-}
-
-// output
-// Prints the contents of the tree to the ostream
-// preconditions:	tree must be a valid BSTree object (must not reference
-//					a dereferenced nullptr); this not equal to nullptr.
-// postconditions:	the contents of this are printed to the ostream Each
-//					line contains a Node in the format: 
-//						"m_item m_itemCount"
-//
-ostream& operator<<(ostream &sout, const BSTree &tree) {
-	tree.print(sout, tree.m_root);
-	return(sout);
-}
+// BSTree.cpp		Author: Sam Hoover
+// contains the definitions for the BasicBSTree class template. This file is
+// included at the bottom of BSTree.h and needs no separate compilation
+//
+#ifndef BSTREE_CPP
+#define BSTREE_CPP
+#include "BSTree.h"
+
+// BasicBSTree::Node default constructor
+// preconditions:	none
+// postconditions:	creates a node with a default m_item, m_left and
+//					m_right equal to nullptr, m_itemCount, m_height and
+//					m_weight equal to 0, and m_size equal to 1.
+//
+template<typename Key, typename Compare>
+BasicBSTree<Key, Compare>::Node::Node() : m_item(), m_itemCount(0), m_left(nullptr), m_right(nullptr), m_height(0), m_size(1), m_weight(0),
+									   m_hash(nodeHash(m_item, 0, nullptr, nullptr)) {}
+
+// BasicBSTree::Node constructor(const Key &data)
+// preconditions:	none
+// postconditions:	Creates a node with m_item equal to data, m_itemCount
+//					equal to 1, and m_left and m_right equal to nullptr.
+//
+template<typename Key, typename Compare>
+BasicBSTree<Key, Compare>::Node::Node(const Key &data) : m_item(data), m_itemCount(1), m_left(nullptr), m_right(nullptr), m_height(0), m_size(1), m_weight(1),
+									   m_hash(nodeHash(m_item, 1, nullptr, nullptr)) {}
+
+// BasicBSTree::Node copy constructor (deep copy)
+// preconditions:	none
+// postconditions:	this becomes an identical copy of node, with
+//					m_left and m_right equal to nullptr
+//
+template<typename Key, typename Compare>
+BasicBSTree<Key, Compare>::Node::Node(const Node &node) : m_item(node.m_item),
+									   m_itemCount(node.m_itemCount), 
+									   m_left(nullptr), 
+									   m_right(nullptr),
+									   m_height(node.m_height),
+									   m_size(node.m_size),
+									   m_weight(node.m_weight),
+									   m_hash(node.m_hash) {}
+
+// NodeHandle default constructor
+// preconditions:	none
+// postconditions:	creates an empty handle
+//
+template<typename Key, typename Compare>
+BasicBSTree<Key, Compare>::NodeHandle::NodeHandle() : m_node(nullptr) {}
+
+// NodeHandle constructor(Node *node, const shared_ptr<MemoryPool> &pool)
+// preconditions:	node was carved from pool and is not in any tree.
+// postconditions:	creates a handle owning node
+//
+template<typename Key, typename Compare>
+BasicBSTree<Key, Compare>::NodeHandle::NodeHandle(Node *node, const shared_ptr<MemoryPool> &pool) :
+		m_node(node), m_pool(pool) {}
+
+// NodeHandle move constructor
+// preconditions:	none
+// postconditions:	this takes over handle's node; handle is empty
+//
+template<typename Key, typename Compare>
+BasicBSTree<Key, Compare>::NodeHandle::NodeHandle(NodeHandle &&handle) : m_node(handle.m_node),
+		m_pool(std::move(handle.m_pool)) {
+	handle.m_node = nullptr;
+}
+
+// NodeHandle move assignment
+// preconditions:	none
+// postconditions:	any node held by this is deleted, then this takes over
+//					handle's node; handle is empty
+//
+template<typename Key, typename Compare>
+typename BasicBSTree<Key, Compare>::NodeHandle&
+BasicBSTree<Key, Compare>::NodeHandle::operator=(NodeHandle &&handle) {
+	if(this != &handle) {
+		if(m_node != nullptr) {
+			m_node->~Node();
+			m_pool->deallocate(m_node);
+		}
+		m_node = handle.m_node;
+		m_pool = std::move(handle.m_pool);
+		handle.m_node = nullptr;
+	}
+	return(*this);
+}
+
+// NodeHandle destructor
+// preconditions:	none
+// postconditions:	any node still held is deleted
+//
+template<typename Key, typename Compare>
+BasicBSTree<Key, Compare>::NodeHandle::~NodeHandle() {
+	if(m_node != nullptr) {
+		m_node->~Node();
+		m_pool->deallocate(m_node);
+		m_node = nullptr;
+	}
+}
+
+// NodeHandle isEmpty
+// preconditions:	none
+// postconditions:	true is returned if no node is held
+//
+template<typename Key, typename Compare>
+bool BasicBSTree<Key, Compare>::NodeHandle::isEmpty() const {
+	return(m_node == nullptr);
+}
+
+// NodeHandle getKey
+// preconditions:	this must not be empty.
+// postconditions:	the key of the held node is returned
+//
+template<typename Key, typename Compare>
+const Key& BasicBSTree<Key, Compare>::NodeHandle::getKey() const {
+	return(m_node->m_item);
+}
+
+// NodeHandle getCount
+// preconditions:	this must not be empty.
+// postconditions:	the m_itemCount of the held node is returned
+//
+template<typename Key, typename Compare>
+int BasicBSTree<Key, Compare>::NodeHandle::getCount() const {
+	return(m_node->m_itemCount);
+}
+
+// BasicBSTree default constructor
+// preconditions:	none
+// postconsitions:	Creates a tree of size zero (m_root equal to nullptr)
+//
+template<typename Key, typename Compare>
+BasicBSTree<Key, Compare>::BasicBSTree() : m_root(nullptr), m_policy(UNBALANCED), m_pool(make_shared<MemoryPool>(sizeof(Node))) {}
+
+// BasicBSTree constructor(BalancePolicy policy)
+// preconditions:	none
+// postconditions:	Creates a tree of size zero (m_root equal to nullptr)
+//					that rebalances itself according to policy.
+//
+template<typename Key, typename Compare>
+BasicBSTree<Key, Compare>::BasicBSTree(BalancePolicy policy) : m_root(nullptr), m_policy(policy), m_pool(make_shared<MemoryPool>(sizeof(Node))) {}
+
+// BasicBSTree constructor(Key *data, BalancePolicy policy)
+// preconditions:	none
+// postconditions:	If data is not a nullptr, then m_root is set to a new
+//					node holding a copy of *data with m_itemCount equal
+//					to one; data is left to the caller. If data equals
+//					nullptr, m_root is set to nullptr. The tree
+//					rebalances according to policy.
+//
+template<typename Key, typename Compare>
+BasicBSTree<Key, Compare>::BasicBSTree(Key *data, BalancePolicy policy) : m_policy(policy), m_pool(make_shared<MemoryPool>(sizeof(Node))) {
+	if(data != nullptr) {
+		m_root = newNode(*data);
+	} else {
+		m_root = nullptr;
+	}
+}
+
+// constructor(InputIt begin, InputIt end, BalancePolicy policy)
+// Bulk-builds a height-balanced tree from sorted input in linear time.
+// preconditions:	[begin, end) must be sorted in ascending order by
+//					Compare; equal keys must be adjacent.
+// postconditions:	this holds every key in [begin, end), with runs of
+//					equal keys folded into one node's m_itemCount. The
+//					tree rebalances according to policy afterwards.
+//
+template<typename Key, typename Compare>
+template<typename InputIt>
+BasicBSTree<Key, Compare>::BasicBSTree(InputIt begin, InputIt end, BalancePolicy policy) : m_root(nullptr), m_policy(policy), m_pool(make_shared<MemoryPool>(sizeof(Node))) {
+	assignSorted(begin, end);
+}
+
+// copy constructor (deep copy)
+// preconditions:	tree must be a valid BSTree object (must not reference
+//					a dereferenced nullptr)
+// postconditions:	this becomes an identical node-by-node copy of tree,
+//					creating new Nodes and new Keys, and uses the
+//					same BalancePolicy as tree.
+//
+template<typename Key, typename Compare>
+BasicBSTree<Key, Compare>::BasicBSTree(const BasicBSTree &tree) : m_policy(tree.m_policy), m_pool(make_shared<MemoryPool>(sizeof(Node))), m_compare(tree.m_compare) {
+	copyNode(m_root, tree.m_root);
+}
+
+// move constructor
+// Takes over the nodes and pool of tree without copying or allocating
+// anything, so containers of trees move them instead of copying them.
+// preconditions:	tree must be a valid BSTree object (must not reference
+//					a dereferenced nullptr)
+// postconditions:	this holds what tree held, with its BalancePolicy; tree
+//					is left empty, with no pool until it next needs one.
+//
+template<typename Key, typename Compare>
+BasicBSTree<Key, Compare>::BasicBSTree(BasicBSTree &&tree) noexcept : m_root(nullptr), m_policy(tree.m_policy),
+		m_compare(tree.m_compare) {
+	swap(tree);
+}
+
+// copyNode: copy constructor helper (deep copy)
+// Copies every node under from into one block taken from m_pool, placing
+// each copy at its preorder index. Large subtrees are copied by other
+// threads.
+// preconditions:	this not equal to nullptr.
+// postconditions:	to becomes an identical copy of from, copying all
+//					decendants. 
+//
+template<typename Key, typename Compare>
+void BasicBSTree<Key, Compare>::copyNode(Node *&to, Node *from) {
+	if(from == nullptr) {
+		to = nullptr;
+		return;
+	}
+	char *block = static_cast<char*>(pool().allocateBulk(size(from)));
+	countAllocations(size(from));
+	copySubtree(&to, from, block, pool().getBlockSize(), 0, spawnDepth());
+}
+
+// copySubtree: copyNode helper
+// Copies the subtree under from into block, starting at preorder index
+// index. In preorder a node's left subtree follows it directly and its
+// right subtree follows the left, so m_size gives every copy its slot and
+// the threads never share an allocator. Runs iteratively; when spawn > 0
+// the left side of a large node is copied by another thread.
+// preconditions:	block has room for size(from) nodes of blockSize bytes
+//					from index on.
+// postconditions:	*link points to an identical copy of from's subtree.
+//
+template<typename Key, typename Compare>
+void BasicBSTree<Key, Compare>::copySubtree(Node **link, const Node *from, char *block, size_t blockSize,
+		int index, int spawn) {
+	struct Frame {
+		Node **m_link;
+		const Node *m_source;
+		int m_index;
+		int m_spawn;
+	};
+
+	vector<future<void> > tasks;
+	vector<Frame> stack;
+	Frame first = { link, from, index, spawn };
+	stack.push_back(first);
+	while(!stack.empty()) {
+		Frame frame = stack.back();
+		stack.pop_back();
+		if(frame.m_source == nullptr) {
+			*frame.m_link = nullptr;
+			continue;
+		}
+		Node *node = new(block + frame.m_index * blockSize) Node(*frame.m_source);
+		*frame.m_link = node;
+
+		Frame left = { &node->m_left, frame.m_source->m_left, frame.m_index + 1, frame.m_spawn - 1 };
+		Frame right = { &node->m_right, frame.m_source->m_right,
+				frame.m_index + 1 + size(frame.m_source->m_left), frame.m_spawn - 1 };
+		stack.push_back(right);
+		if(frame.m_spawn > 0 && size(left.m_source) >= COPY_PARALLEL_GRAIN &&
+		   size(right.m_source) >= COPY_PARALLEL_GRAIN) {
+			tasks.push_back(async(launch::async, &BasicBSTree::copySubtree, left.m_link, left.m_source,
+					block, blockSize, left.m_index, left.m_spawn));
+		} else {
+			stack.push_back(left);
+		}
+	}
+	for(size_t i = 0; i < tasks.size(); i++) {
+		tasks[i].get();
+	}
+}
+
+// unionWith
+// Adds every key of tree to this tree. Built from split and join, so the
+// work is O(m log(n/m + 1)) for m keys in the smaller tree and n in the
+// larger; merging a small tree into a large one costs time in proportion
+// to the small one. Independent halves run on separate threads.
+// preconditions:	tree must be a valid BasicBSTree object (must not
+//					reference a dereferenced nullptr); this not equal to
+//					nullptr.
+// postconditions:	this holds every key of both trees. A key held by both
+//					gets the counts combined by policy; a key held by one
+//					keeps its count. tree is unchanged.
+//
+template<typename Key, typename Compare>
+void BasicBSTree<Key, Compare>::unionWith(const BasicBSTree &tree, CountPolicy policy) {
+	applySetOperation(tree, SET_UNION, policy);
+}
+
+// intersectWith
+// Keeps only the keys of this tree that tree also holds, with the same
+// split/join structure and cost as unionWith.
+// preconditions:	tree must be a valid BasicBSTree object (must not
+//					reference a dereferenced nullptr); this not equal to
+//					nullptr.
+// postconditions:	this holds the keys found in both trees, with the counts
+//					combined by policy. tree is unchanged.
+//
+template<typename Key, typename Compare>
+void BasicBSTree<Key, Compare>::intersectWith(const BasicBSTree &tree, CountPolicy policy) {
+	applySetOperation(tree, SET_INTERSECTION, policy);
+}
+
+// differenceWith
+// Takes the keys of tree away from this tree, with the same split/join
+// structure and cost as unionWith.
+// preconditions:	tree must be a valid BasicBSTree object (must not
+//					reference a dereferenced nullptr); this not equal to
+//					nullptr.
+// postconditions:	a key held by both trees gets the counts combined by
+//					policy, and is removed if that leaves less than
+//					MIN_ITEM_COUNT. Other keys of this tree are unchanged.
+//					tree is unchanged.
+//
+template<typename Key, typename Compare>
+void BasicBSTree<Key, Compare>::differenceWith(const BasicBSTree &tree, CountPolicy policy) {
+	applySetOperation(tree, SET_DIFFERENCE, policy);
+}
+
+// applyDelta
+// Makes the changes of a delta from diff, in O(k log n) for k entries.
+// Every entry is checked against the tree before any is made, so a delta
+// taken against some other tree leaves this one alone. The tree ends up
+// with the keys and counts of the tree the delta was taken towards, but its
+// shape may differ, so operator== between the two can still be false.
+// preconditions:	this not equal to nullptr.
+// postconditions:	If the keys of delta are in ascending order, each
+//					DELTA_INSERT key is absent from the tree, every other
+//					key is present, and no inserted or changed count is
+//					below MIN_ITEM_COUNT, the changes are made and true is
+//					returned. Otherwise false is returned and the tree is
+//					unchanged.
+//
+template<typename Key, typename Compare>
+bool BasicBSTree<Key, Compare>::applyDelta(const vector<DeltaEntry> &delta) {
+	for(size_t i = 0; i < delta.size(); i++) {
+		const DeltaEntry &entry = delta[i];
+		if(i > 0 && !isLess(delta[i - 1].m_key, entry.m_key)) {
+			return(false);
+		}
+		bool found = findNode(entry.m_key) != nullptr;
+		if(entry.m_kind == DELTA_INSERT ? found : !found) {
+			return(false);
+		}
+		if(entry.m_kind != DELTA_REMOVE && entry.m_count < MIN_ITEM_COUNT) {
+			return(false);
+		}
+	}
+
+	for(size_t i = 0; i < delta.size(); i++) {
+		const DeltaEntry &entry = delta[i];
+		if(entry.m_kind == DELTA_INSERT) {
+			Node *item = new(pool().allocate()) Node(entry.m_key);
+			countAllocations(1);
+			item->m_itemCount = entry.m_count;
+			update(item);
+			insert(item, m_root);
+		} else {
+			setCount(entry.m_key, entry.m_kind == DELTA_REMOVE ? 0 : entry.m_count);
+		}
+	}
+	return(true);
+}
+
+// spawnDepth: parallel helper
+// preconditions:	none
+// postconditions:	the number of levels of two-way splitting needed to
+//					give every hardware thread a task is returned.
+//
+template<typename Key, typename Compare>
+int BasicBSTree<Key, Compare>::spawnDepth() {
+	int depth = 0;
+	for(unsigned threads = thread::hardware_concurrency(); threads > 1; threads /= 2) {
+		depth++;
+	}
+	return(depth);
+}
+
+// destructor
+// preconditions:	none
+// postconditions:	All nodes removed and deleted, m_root set to nullptr
+//
+template<typename Key, typename Compare>
+BasicBSTree<Key, Compare>::~BasicBSTree() {
+	makeEmpty();
+}
+
+// insert(const Key &data)
+// Inserts a copy of data into the tree. If a node containing an equal object
+// already exists in the tree, its m_itemCount is incremented by one. For the
+// tree and all subtrees nodes are inserted with the formula:
+//			node < root = insert left
+//			node >= root = insert right
+// preconditions:	data must be a valid Key object (must not reference
+//					a dereferenced nullptr); this not equal to nullptr.
+// postconditions:	If data does not already exist in the tree, then a new
+//					node with m_item equal to data is inserted and true is
+//					returned. If the data already exists, then m_itemCount
+//					is incremented by one and false is returned.
+//
+template<typename Key, typename Compare>
+bool BasicBSTree<Key, Compare>::insert(const Key &data) {
+	return(insert(newNode(data), m_root));
+}
+
+// insert(Key *data)
+// Deprecated: use insert(const Key&) or emplace. Kept for callers of the
+// original pointer interface, with one change in ownership. The original
+// tree kept data itself and deleted it on remove; this tree stores a copy
+// of *data and never takes data. The caller still owns data and must delete
+// it, whatever is returned, and a pointer from retrieve refers to the
+// tree's copy rather than to data.
+// preconditions:	data must be a valid Key object not equal to
+//					nullptr; this not equal to nullptr.
+// postconditions:	the same as insert(*data); data is left to the caller.
+//
+template<typename Key, typename Compare>
+bool BasicBSTree<Key, Compare>::insert(Key *data) {
+	return(insert(*data));
+}
+
+// insert helper
+// Links a node that is in no tree into the tree. If a node containing an
+// equal m_item already exists in the tree, that node's m_itemCount is
+// raised by item's and item is returned to the pool.
+// preconditions:	item must be a leaf in no tree, carved from m_pool or a
+//					pool in m_foreignPools; this not equal to nullptr.
+// postconditions:	If item->m_item does not already exist in the tree, then
+//					item is linked into the tree. If it already exists, then
+//					m_itemCount is raised by item->m_itemCount and item is
+//					freed.
+//
+template<typename Key, typename Compare>
+bool BasicBSTree<Key, Compare>::insert(Node *item, Node *&node) {
+	OperationTally tally(this, STAT_INSERT);
+	vector<Node**> path;
+	Node **link = &node;
+	while(*link != nullptr) {
+		tally.visit();
+		if(isEqual(item->m_item, (*link)->m_item)) {
+			(*link)->m_itemCount += item->m_itemCount;
+			freeNode(item);
+			path.push_back(link);
+			retrace(path);
+			return(false);
+		}
+		path.push_back(link);
+		if(isLess(item->m_item, (*link)->m_item)) {
+			link = &(*link)->m_left;
+		} else {
+			link = &(*link)->m_right;
+		}
+	}
+	*link = item;
+	retrace(path);
+	return(true);
+}
+
+// emplace
+// Constructs a Key from args directly inside a new node and inserts it into
+// the tree, following the same rules as insert. No separate Key is
+// allocated by the caller.
+// preconditions:	args must be valid arguments to a Key constructor;
+//					this not equal to nullptr.
+// postconditions:	If the constructed item does not already exist in the
+//					tree, a node holding it is inserted and true is 
+//					returned. Otherwise the matching node's m_itemCount is
+//					incremented by one and false is returned.
+//
+template<typename Key, typename Compare>
+template<typename... Args>
+bool BasicBSTree<Key, Compare>::emplace(Args&&... args) {
+	Node *item = new(pool().allocate()) Node(Key(std::forward<Args>(args)...));
+	countAllocations(1);
+	return(insert(item, m_root));
+}
+
+// remove
+// Removes a Key object equal to data from the tree. If there is only
+// one Key object, the node containing that object is removed and
+// deleted.
+// preconditions:	data must be a valid Key object (must not reference
+//					a dereferenced nullptr); this not equal to nullptr.
+// postconditions:	If data is not found, then false is returned. If data
+//					is found and m_itemCount > 1 then m_itemCount is 
+//					decremented by one; if m_itemCount == 1 then the node
+//					is removed from the tree and deleted.
+//
+template<typename Key, typename Compare>
+bool BasicBSTree<Key, Compare>::remove(const Key &data) {
+	return(remove(data, m_root));
+}
+
+// remove helper
+// Removes a Key object equal to data from the tree. If there is only
+// one Key object, the node containing that object is removed and
+// deleted.
+// preconditions:	node->m_item must be a valid Key object not equal
+//					to nullptr; this not equal to nullptr.
+// postconditions:	If data is not found, then false is returned. If data
+//					is found and m_itemCount > 1 then m_itemCount is 
+//					decremented by one; if m_itemCount == 1 then the node
+//					is removed from the tree and deleted.
+//
+template<typename Key, typename Compare>
+bool BasicBSTree<Key, Compare>::remove(const Key &data, Node *&node) {
+	OperationTally tally(this, STAT_REMOVE);
+	vector<Node**> path;
+	Node **link = &node;
+	while(*link != nullptr && !isEqual(data, (*link)->m_item)) {
+		tally.visit();
+		path.push_back(link);
+		if(isLess(data, (*link)->m_item)) {
+			link = &(*link)->m_left;
+		} else {
+			link = &(*link)->m_right;
+		}
+	}
+	if(*link == nullptr) {
+		return(false);
+	}
+	tally.visit();
+
+	if((*link)->m_itemCount > MIN_ITEM_COUNT) {
+		(*link)->m_itemCount--;
+		path.push_back(link);
+	} else {
+		deleteNode(*link);
+	}
+	retrace(path);
+	return(true);
+}
+
+// deleteNode: remove helper
+// Deletes a Node with m_item equal to data from the tree.
+// preconditions:	node must be a valid BSTree::Node object not equal to
+//					nullptr; this not equal to nullptr.
+// postconditions:	node is deleted and set to nullptr.
+//
+template<typename Key, typename Compare>
+void BasicBSTree<Key, Compare>::deleteNode(Node *&node) {
+	if(node->m_left == nullptr && node->m_right == nullptr) {
+		freeNode(node);
+		node = nullptr;
+	} else if(node->m_left == nullptr) {
+		Node *temp = node;
+		node = node->m_right;
+		freeNode(temp);
+		temp = nullptr;
+	} else if(node->m_right == nullptr) {
+		Node *temp = node;
+		node = node->m_left;
+		freeNode(temp);
+		temp = nullptr;
+	} else {
+		node->m_item = deleteSmallest(node->m_right, node->m_itemCount);
+		rebalance(node);
+	}
+}
+
+// deleteSmallest: remove helper
+// Finds and deletes the Node with the smallest m_item from the tree, then
+// rebalances the nodes on the path to it.
+// preconditions:	node must be a valid BSTree::Node object not equal to
+//					nullptr; this not equal to nullptr.
+// postconditions:	the smallest node is deleted and replaced by its right
+//					child. A copy of its m_item is returned and its
+//					m_itemCount is stored in count.
+//
+template<typename Key, typename Compare>
+Key BasicBSTree<Key, Compare>::deleteSmallest(Node *&node, int &count) {
+	vector<Node**> path;
+	Node **link = &node;
+	while((*link)->m_left != nullptr) {
+		path.push_back(link);
+		link = &(*link)->m_left;
+	}
+
+	Node *temp = *link;
+	Key item = temp->m_item;
+	count = temp->m_itemCount;
+	*link = temp->m_right;
+	freeNode(temp);
+	temp = nullptr;
+	retrace(path);
+	return(item);
+}
+
+// retrace: insert/remove helper
+// Rebalances every node on path, deepest first, after the tree below the
+// last entry of path has changed shape.
+// preconditions:	path must hold the links from an ancestor down to the
+//					changed subtree, in root-to-leaf order.
+// postconditions:	every node on path has been passed to rebalance.
+//
+template<typename Key, typename Compare>
+void BasicBSTree<Key, Compare>::retrace(const vector<Node**> &path) {
+	for(size_t i = path.size(); i > 0; i--) {
+		rebalance(*path[i - 1]);
+	}
+}
+
+// height: balance helper
+// Returns the height of node.
+// preconditions:	none
+// postconditions:	If node is nullptr -1 is returned, else m_height.
+//
+template<typename Key, typename Compare>
+int BasicBSTree<Key, Compare>::height(const Node *node) {
+	if(node == nullptr) {
+		return(-1);
+	}
+	return(node->m_height);
+}
+
+// update: balance helper
+// Recomputes the height, size, weight and hash of node from its children.
+// preconditions:	node must be a valid BSTree::Node object not equal to
+//					nullptr; the fields of its children must be correct.
+// postconditions:	node->m_height is one greater than the height of its
+//					taller child; m_size and m_weight total the subtree;
+//					m_hash covers the subtree.
+//
+template<typename Key, typename Compare>
+void BasicBSTree<Key, Compare>::update(Node *node) {
+	int l_height = height(node->m_left);
+	int r_height = height(node->m_right);
+	node->m_height = (l_height > r_height ? l_height : r_height) + 1;
+	node->m_size = size(node->m_left) + size(node->m_right) + 1;
+	node->m_weight = weight(node->m_left) + weight(node->m_right) + node->m_itemCount;
+	node->m_hash = nodeHash(node->m_item, node->m_itemCount, node->m_left, node->m_right);
+}
+
+// size: order statistic helper
+// Returns the number of nodes in the subtree rooted at node.
+// preconditions:	none
+// postconditions:	If node is nullptr 0 is returned, else m_size.
+//
+template<typename Key, typename Compare>
+int BasicBSTree<Key, Compare>::size(const Node *node) {
+	if(node == nullptr) {
+		return(0);
+	}
+	return(node->m_size);
+}
+
+// weight: order statistic helper
+// Returns the sum of m_itemCount over the subtree rooted at node.
+// preconditions:	none
+// postconditions:	If node is nullptr 0 is returned, else m_weight.
+//
+template<typename Key, typename Compare>
+int BasicBSTree<Key, Compare>::weight(const Node *node) {
+	if(node == nullptr) {
+		return(0);
+	}
+	return(node->m_weight);
+}
+
+// subtreeHash: hash helper
+// Returns the hash of the subtree rooted at node.
+// preconditions:	none
+// postconditions:	If node is nullptr EMPTY_HASH is returned, else m_hash.
+//
+template<typename Key, typename Compare>
+uint64_t BasicBSTree<Key, Compare>::subtreeHash(const Node *node) {
+	if(node == nullptr) {
+		return(EMPTY_HASH);
+	}
+	return(node->m_hash);
+}
+
+// nodeHash: hash helper
+// Combines a node's key and count with the hashes of its children in one
+// mixing step. The children are scrambled differently before they are
+// combined, so mirror images hash apart.
+// preconditions:	none
+// postconditions:	the hash of a node holding item itemCount times above
+//					left and right is returned
+//
+template<typename Key, typename Compare>
+uint64_t BasicBSTree<Key, Compare>::nodeHash(const Key &item, int itemCount, const Node *left, const Node *right) {
+	uint64_t r_hash = subtreeHash(right);
+	return(mixHash(keyHash(item) ^ static_cast<uint64_t>(itemCount) * 0x9e3779b97f4a7c15ULL ^
+			subtreeHash(left) * 0xc2b2ae3d27d4eb4fULL ^ ((r_hash << 29) | (r_hash >> 35))));
+}
+
+// keyHash: hash helper
+// Hashes a key with KeyTraits when hashesKeys() is true, else returns 0.
+// preconditions:	none
+// postconditions:	the hash of key is returned
+//
+template<typename Key, typename Compare>
+uint64_t BasicBSTree<Key, Compare>::keyHash(const Key &key) {
+	if(hashesKeys()) {
+		return(KeyTraits<Key>::hash(key));
+	}
+	return(0);
+}
+
+// hashesKeys: hash helper
+// Keys are hashed only when KeyTraits hashes Key and Compare is known to
+// treat keys as equal exactly when KeyTraits does; under any other Compare
+// keys equal by Compare may hash differently.
+// preconditions:	none
+// postconditions:	true is returned if keys count towards node hashes
+//
+template<typename Key, typename Compare>
+bool BasicBSTree<Key, Compare>::hashesKeys() {
+	return(KeyTraits<Key>::HASHED && (is_same<Compare, less<Key> >::value || is_same<Compare, greater<Key> >::value));
+}
+
+// mixHash: hash helper
+// Scrambles every bit of value into every bit of the result (the
+// finalizer of SplitMix64).
+// preconditions:	none
+// postconditions:	the mixed value is returned
+//
+template<typename Key, typename Compare>
+uint64_t BasicBSTree<Key, Compare>::mixHash(uint64_t value) {
+	value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+	return(value ^ (value >> 31));
+}
+
+// rotateLeft: balance helper
+// Rotates the subtree rooted at node to the left, making node's right
+// child the new root of the subtree.
+// preconditions:	node and node->m_right must not be nullptr.
+// postconditions:	node points to the new subtree root; in-order sequence
+//					and heights are preserved/updated.
+//
+template<typename Key, typename Compare>
+void BasicBSTree<Key, Compare>::rotateLeft(Node *&node) {
+	Node *pivot = node->m_right;
+	node->m_right = pivot->m_left;
+	pivot->m_left = node;
+	update(node);
+	update(pivot);
+	node = pivot;
+}
+
+// rotateRight: balance helper
+// Rotates the subtree rooted at node to the right, making node's left
+// child the new root of the subtree.
+// preconditions:	node and node->m_left must not be nullptr.
+// postconditions:	node points to the new subtree root; in-order sequence
+//					and heights are preserved/updated.
+//
+template<typename Key, typename Compare>
+void BasicBSTree<Key, Compare>::rotateRight(Node *&node) {
+	Node *pivot = node->m_left;
+	node->m_left = pivot->m_right;
+	pivot->m_right = node;
+	update(node);
+	update(pivot);
+	node = pivot;
+}
+
+// rebalance: insert/remove helper
+// Updates the height of node and, if m_policy is AVL, performs the single
+// or double rotation needed to restore the AVL property at node.
+// preconditions:	the subtrees of node must already be balanced.
+// postconditions:	node's height is correct. If m_policy is AVL the heights
+//					of node's children differ by at most one.
+//
+template<typename Key, typename Compare>
+void BasicBSTree<Key, Compare>::rebalance(Node *&node) {
+	update(node);
+	if(m_policy != AVL) {
+		return;
+	}
+
+	int balance = height(node->m_left) - height(node->m_right);
+	if(balance > 1) {
+		// left-right case is reduced to left-left first
+		if(height(node->m_left->m_left) < height(node->m_left->m_right)) {
+			rotateLeft(node->m_left);
+		}
+		rotateRight(node);
+	} else if(balance < -1) {
+		// right-left case is reduced to right-right first
+		if(height(node->m_right->m_right) < height(node->m_right->m_left)) {
+			rotateRight(node->m_right);
+		}
+		rotateLeft(node);
+	}
+}
+
+// makeEmpty
+// Removes and deletes all nodes from the tree, and set m_root equal to
+// nullptr. Nodes hold their items inline, so unless another tree or handle
+// shares the pool, the whole tree is released with its pool in O(chunks).
+// Nodes taken in from other trees are returned to their own pools.
+// preconditions:	this not equal to nullptr.
+// postconditions:	All nodes removed and deleted, m_root set to nullptr
+//
+template<typename Key, typename Compare>
+void BasicBSTree<Key, Compare>::makeEmpty() {
+	// nodes must be destroyed one by one if their keys need it, if other
+	// trees or handles still own nodes carved from m_pool, or if some nodes
+	// belong to other pools
+	bool shared = m_pool.use_count() > 1;
+	countFrees(size());
+	vector<Node*> garbage;
+	if(shared || !m_foreignPools.empty() || !is_trivially_destructible<Key>::value) {
+		discardSubtree(m_root, garbage);
+	}
+	m_root = nullptr;
+	for(size_t i = 0; i < garbage.size(); i++) {
+		const shared_ptr<MemoryPool> &pool = poolOf(garbage[i]);
+		if(shared || pool != m_pool) {
+			pool->deallocate(garbage[i]);
+		}
+	}
+	if(!shared && m_pool) {
+		m_pool->release();
+	}
+	m_foreignPools.clear();
+}
+
+// adoptPool: node handle helper
+// preconditions:	pool not equal to nullptr.
+// postconditions:	if pool is not m_pool, it is in m_foreignPools
+//
+template<typename Key, typename Compare>
+void BasicBSTree<Key, Compare>::adoptPool(const shared_ptr<MemoryPool> &pool) {
+	if(pool == m_pool) {
+		return;
+	}
+	for(size_t i = 0; i < m_foreignPools.size(); i++) {
+		if(m_foreignPools[i] == pool) {
+			return;
+		}
+	}
+	m_foreignPools.push_back(pool);
+}
+
+// newNode: node allocation helper
+// Builds a Node holding a copy of data in a block taken from m_pool.
+// preconditions:	this not equal to nullptr.
+// postconditions:	a pointer to the new Node is returned.
+//
+template<typename Key, typename Compare>
+typename BasicBSTree<Key, Compare>::Node* BasicBSTree<Key, Compare>::newNode(const Key &data) {
+	countAllocations(1);
+	return(new(pool().allocate()) Node(data));
+}
+
+// pool: node allocation helper
+// A tree that was moved from has no pool; it gets a new one the first time
+// it allocates a node.
+// preconditions:	this not equal to nullptr.
+// postconditions:	m_pool, created if it was nullptr, is returned.
+//
+template<typename Key, typename Compare>
+MemoryPool& BasicBSTree<Key, Compare>::pool() {
+	if(!m_pool) {
+		m_pool = make_shared<MemoryPool>(sizeof(Node));
+	}
+	return(*m_pool);
+}
+
+// poolOf: node allocation helper
+// Finds the pool node was carved from: m_pool unless the tree has taken in
+// nodes from other trees, in which case the pools are searched.
+// preconditions:	node is in this tree, or was until just now.
+// postconditions:	the pool among m_pool and m_foreignPools that owns node
+//					is returned.
+//
+template<typename Key, typename Compare>
+const shared_ptr<MemoryPool>& BasicBSTree<Key, Compare>::poolOf(const Node *node) const {
+	if(m_foreignPools.empty() || (m_pool && m_pool->owns(node))) {
+		return(m_pool);
+	}
+	for(size_t i = 0; i < m_foreignPools.size(); i++) {
+		if(m_foreignPools[i]->owns(node)) {
+			return(m_foreignPools[i]);
+		}
+	}
+	return(m_pool);
+}
+
+// freeNode: node allocation helper
+// Destroys node and returns its block to the pool it was carved from.
+// preconditions:	node must be in this tree, or have been until just now.
+// postconditions:	node's memory is back on its pool's free list.
+//
+template<typename Key, typename Compare>
+void BasicBSTree<Key, Compare>::freeNode(Node *node) {
+	countFrees(1);
+	node->~Node();
+	poolOf(node)->deallocate(node);
+}
+
+// assignSorted
+// Replaces the contents of the tree with the keys in [begin, end), built
+// directly into a height-balanced shape in one linear pass. All of the
+// nodes are allocated in a single block.
+// preconditions:	[begin, end) must be sorted in ascending order by
+//					Compare; equal keys must be adjacent.
+// postconditions:	this holds every key in [begin, end), with runs of
+//					equal keys folded into one node's m_itemCount. The
+//					depth of the tree is floor(log2(n)).
+//
+template<typename Key, typename Compare>
+template<typename InputIt>
+void BasicBSTree<Key, Compare>::assignSorted(InputIt begin, InputIt end) {
+	makeEmpty();
+
+	// fold runs of equal keys before sizing the block
+	vector<Key> keys;
+	vector<int> counts;
+	for(; begin != end; ++begin) {
+		if(!keys.empty() && isEqual(keys.back(), *begin)) {
+			counts.back()++;
+		} else {
+			keys.push_back(*begin);
+			counts.push_back(MIN_ITEM_COUNT);
+		}
+	}
+	if(keys.empty()) {
+		return;
+	}
+
+	char *block = static_cast<char*>(pool().allocateBulk(keys.size()));
+	countAllocations(keys.size());
+	vector<Node*> nodes(keys.size());
+	for(size_t i = 0; i < keys.size(); i++) {
+		nodes[i] = new(block + i * pool().getBlockSize()) Node(keys[i]);
+		nodes[i]->m_itemCount = counts[i];
+	}
+	m_root = buildBalanced(nodes, 0, static_cast<int>(nodes.size()) - 1);
+}
+
+// rebuild
+// Relinks the existing nodes of the tree into a height-balanced shape in
+// linear time. No nodes are allocated, freed, or copied.
+// preconditions:	this not equal to nullptr.
+// postconditions:	the tree holds the same keys and counts, and its depth
+//					is floor(log2(n)).
+//
+template<typename Key, typename Compare>
+void BasicBSTree<Key, Compare>::rebuild() {
+	rebuildSubtree(m_root);
+}
+
+// extract
+// Unlinks the node holding data from the tree and hands it over, with its
+// m_itemCount, without freeing or copying it. A node with two children is
+// replaced by its in-order successor node itself, so no key is copied.
+// preconditions:	data must be a valid Key object (must not reference
+//					a dereferenced nullptr); this not equal to nullptr.
+// postconditions:	If data is found, its node is removed from the tree and
+//					returned in a handle; otherwise an empty handle is
+//					returned.
+//
+template<typename Key, typename Compare>
+typename BasicBSTree<Key, Compare>::NodeHandle BasicBSTree<Key, Compare>::extract(const Key &data) {
+	vector<Node**> path;
+	Node **link = &m_root;
+	while(*link != nullptr && !isEqual(data, (*link)->m_item)) {
+		path.push_back(link);
+		link = isLess(data, (*link)->m_item) ? &(*link)->m_left : &(*link)->m_right;
+	}
+	Node *node = *link;
+	if(node == nullptr) {
+		return(NodeHandle());
+	}
+
+	if(node->m_left == nullptr) {
+		*link = node->m_right;
+	} else if(node->m_right == nullptr) {
+		*link = node->m_left;
+	} else {
+		vector<Node**> below;
+		Node **successor = &node->m_right;
+		while((*successor)->m_left != nullptr) {
+			below.push_back(successor);
+			successor = &(*successor)->m_left;
+		}
+		Node *next = *successor;
+		*successor = next->m_right;
+		next->m_left = node->m_left;
+		next->m_right = node->m_right;
+		*link = next;
+		path.push_back(link);
+		// the first link below hung from node and now hangs from next
+		if(!below.empty()) {
+			below[0] = &next->m_right;
+		}
+		path.insert(path.end(), below.begin(), below.end());
+	}
+	retrace(path);
+
+	node->m_left = nullptr;
+	node->m_right = nullptr;
+	update(node);
+	return(NodeHandle(node, poolOf(node)));
+}
+
+// insert(NodeHandle &&handle)
+// Links the node held by handle into the tree. No allocation, free or Key
+// copy takes place unless the key is already present.
+// preconditions:	handle came from extract on a tree with the same Key and
+//					Compare; this not equal to nullptr.
+// postconditions:	If handle is empty, false is returned. If its key is not
+//					in the tree, the node is linked in with its m_itemCount
+//					and true is returned. Otherwise the existing m_itemCount
+//					is raised by the handle's count, the handle's node is
+//					freed and false is returned. handle is left empty.
+//
+template<typename Key, typename Compare>
+bool BasicBSTree<Key, Compare>::insert(NodeHandle &&handle) {
+	if(handle.m_node == nullptr) {
+		return(false);
+	}
+	adoptPool(handle.m_pool);
+	Node *item = handle.m_node;
+	handle.m_node = nullptr;
+	handle.m_pool.reset();
+	return(insert(item, m_root));
+}
+
+// swap
+// Exchanges the contents, BalancePolicy and pool of this and tree in
+// constant time.
+// preconditions:	tree must be a valid BSTree object (must not reference a
+//					dereferenced nullptr)
+// postconditions:	this holds what tree held and tree what this held.
+//
+template<typename Key, typename Compare>
+void BasicBSTree<Key, Compare>::swap(BasicBSTree &tree) noexcept {
+	std::swap(m_root, tree.m_root);
+	std::swap(m_policy, tree.m_policy);
+	m_pool.swap(tree.m_pool);
+	m_foreignPools.swap(tree.m_foreignPools);
+	std::swap(m_compare, tree.m_compare);
+}
+
+// insertBatch
+// Inserts every key in [begin, end), with the same result as calling
+// insert on each one. The batch is sorted and equal keys are folded into
+// counts, then merged into the tree in one descent that splits the batch
+// at each node it passes. A run of keys that reaches an empty link is
+// built there as a balanced subtree, so sorted batches do not degrade
+// the tree. Large disjoint subtrees are merged on separate threads.
+// preconditions:	InputIt dereferences to Key; this not equal to nullptr.
+// postconditions:	every key is in the tree with its count raised by its
+//					number of occurrences in the batch. The number of new
+//					nodes and of count increments is returned.
+//
+template<typename Key, typename Compare>
+template<typename InputIt>
+InsertBatchResult BasicBSTree<Key, Compare>::insertBatch(InputIt begin, InputIt end) {
+	InsertBatchResult result = { 0, 0 };
+	vector<Key> batch(begin, end);
+	if(batch.empty()) {
+		return(result);
+	}
+	sort(batch.begin(), batch.end(), m_compare);
+
+	vector<Key> keys;
+	vector<int> counts;
+	for(size_t i = 0; i < batch.size(); i++) {
+		if(!keys.empty() && isEqual(keys.back(), batch[i])) {
+			counts.back()++;
+		} else {
+			keys.push_back(batch[i]);
+			counts.push_back(MIN_ITEM_COUNT);
+		}
+	}
+
+	// every key gets a block up front so the threads never share the pool;
+	// the blocks of keys that only bump a count are handed back afterwards
+	char *block = static_cast<char*>(pool().allocateBulk(keys.size()));
+	countAllocations(keys.size());
+	vector<Node*> nodes(keys.size());
+	for(size_t i = 0; i < keys.size(); i++) {
+		nodes[i] = reinterpret_cast<Node*>(block + i * pool().getBlockSize());
+	}
+	vector<char> used(keys.size(), 0);
+
+	result = mergeBatch(&m_root, keys, counts, nodes, used, 0, static_cast<int>(keys.size()), spawnDepth());
+
+	for(size_t i = 0; i < keys.size(); i++) {
+		if(!used[i]) {
+			pool().deallocate(nodes[i]);
+			countFrees(1);
+		}
+	}
+	return(result);
+}
+
+// loadSnapshot
+// Replaces the contents of the tree with a snapshot written by
+// saveSnapshot. The file is memory mapped and checked against its header
+// and checksum, and its key tag must be KeyTraits<Key>::KEY_TAG. One
+// linear pass checks the shape and that the keys are in order under
+// m_compare, then every node is built in another into a single block, with
+// the saved shape and policy.
+// preconditions:	KeyTraits<Key> must encode keys; this not equal to
+//					nullptr.
+// postconditions:	If the file is a valid snapshot for this Key type whose
+//					keys are in order under this tree's Compare, the tree
+//					becomes identical to the saved tree and true is
+//					returned. Otherwise false is returned and the tree is
+//					unchanged.
+//
+template<typename Key, typename Compare>
+bool BasicBSTree<Key, Compare>::loadSnapshot(const string &path) {
+	MappedFile file;
+	if(!file.open(path) || file.getSize() < sizeof(SnapshotHeader)) {
+		return(false);
+	}
+	SnapshotHeader header;
+	memcpy(&header, file.getData(), sizeof(header));
+	if(memcmp(header.m_magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0 ||
+	   header.m_version != SNAPSHOT_VERSION ||
+	   header.m_byteOrder != SNAPSHOT_BYTE_ORDER ||
+	   header.m_keySize != KeyTraits<Key>::ENCODED_SIZE ||
+	   header.m_keyTag != KeyTraits<Key>::KEY_TAG ||
+	   header.m_policy > AVL ||
+	   header.m_nodeCount > file.getSize() ||
+	   header.payloadSize() != file.getSize() - sizeof(header)) {
+		return(false);
+	}
+	const char *payload = file.getData() + sizeof(header);
+	if(SnapshotHeader::checksum(payload, header.payloadSize()) != header.m_checksum) {
+		return(false);
+	}
+
+	const size_t count = header.m_nodeCount;
+	const size_t keySize = header.m_keySize;
+	const char *keys = payload;
+	const char *counts = keys + count * keySize;
+	const unsigned char *shape = reinterpret_cast<const unsigned char*>(counts + count * sizeof(int32_t));
+
+	// a preorder shape is valid when every node fills an open child link
+	// and no link is left open at the end. Each open link carries the
+	// indices of the nodes bounding it (count for none), so a key out of
+	// order under m_compare, as from a tree saved with another Compare, is
+	// caught in the same pass
+	vector<pair<size_t, size_t> > open;
+	if(count > 0) {
+		open.push_back(make_pair(count, count));
+	}
+	for(size_t i = 0; i < count; i++) {
+		int32_t itemCount;
+		memcpy(&itemCount, counts + i * sizeof(int32_t), sizeof(int32_t));
+		if(open.empty() || itemCount < MIN_ITEM_COUNT) {
+			return(false);
+		}
+		const size_t low = open.back().first;
+		const size_t high = open.back().second;
+		open.pop_back();
+		const Key key = KeyTraits<Key>::decode(keys + i * keySize);
+		if((low != count && !isLess(KeyTraits<Key>::decode(keys + low * keySize), key)) ||
+		   (high != count && !isLess(key, KeyTraits<Key>::decode(keys + high * keySize)))) {
+			return(false);
+		}
+		if(shape[i] & SNAPSHOT_HAS_RIGHT) {
+			open.push_back(make_pair(i, high));
+		}
+		if(shape[i] & SNAPSHOT_HAS_LEFT) {
+			open.push_back(make_pair(low, i));
+		}
+	}
+	if(!open.empty()) {
+		return(false);
+	}
+
+	makeEmpty();
+	m_policy = static_cast<BalancePolicy>(header.m_policy);
+	if(count == 0) {
+		return(true);
+	}
+
+	char *block = static_cast<char*>(pool().allocateBulk(count));
+	countAllocations(count);
+	vector<Node*> nodes(count);
+	vector<Node**> links;
+	links.push_back(&m_root);
+	for(size_t i = 0; i < count; i++) {
+		Node *node = new(block + i * pool().getBlockSize()) Node(KeyTraits<Key>::decode(keys + i * keySize));
+		int32_t itemCount;
+		memcpy(&itemCount, counts + i * sizeof(int32_t), sizeof(int32_t));
+		node->m_itemCount = itemCount;
+		nodes[i] = node;
+
+		*links.back() = node;
+		links.pop_back();
+		// the left subtree follows immediately in preorder, so it is filled first
+		if(shape[i] & SNAPSHOT_HAS_RIGHT) {
+			links.push_back(&node->m_right);
+		}
+		if(shape[i] & SNAPSHOT_HAS_LEFT) {
+			links.push_back(&node->m_left);
+		}
+	}
+	// children follow their parent in preorder, so a reverse pass sees every
+	// child before the node above it
+	for(size_t i = count; i > 0; i--) {
+		update(nodes[i - 1]);
+	}
+	return(true);
+}
+
+// buildBalanced: assignSorted/rebuild helper
+// Links nodes[low..high] into a height-balanced subtree, taking the middle
+// node as the root of each range.
+// preconditions:	nodes must be in ascending order; low and high must be
+//					valid indices into nodes or low > high.
+// postconditions:	the root of the subtree is returned (nullptr for an
+//					empty range) with correct heights throughout.
+//
+template<typename Key, typename Compare>
+typename BasicBSTree<Key, Compare>::Node* BasicBSTree<Key, Compare>::buildBalanced(const vector<Node*> &nodes, int low, int high) {
+	if(low > high) {
+		return(nullptr);
+	}
+	int mid = low + (high - low) / 2;
+	Node *node = nodes[mid];
+	node->m_left = buildBalanced(nodes, low, mid - 1);
+	node->m_right = buildBalanced(nodes, mid + 1, high);
+	update(node);
+	return(node);
+}
+
+// rebuildSubtree: rebuild/insertBatch helper
+// Relinks the nodes under node into a height-balanced subtree.
+// preconditions:	none
+// postconditions:	node points to the root of the balanced subtree, which
+//					holds the same nodes with correct heights throughout.
+//
+template<typename Key, typename Compare>
+void BasicBSTree<Key, Compare>::rebuildSubtree(Node *&node) {
+	// collect the nodes in order with an explicit stack so a degenerate
+	// tree cannot overflow the call stack
+	vector<Node*> nodes;
+	vector<Node*> stack;
+	Node *current = node;
+	while(current != nullptr || !stack.empty()) {
+		while(current != nullptr) {
+			stack.push_back(current);
+			current = current->m_left;
+		}
+		current = stack.back();
+		stack.pop_back();
+		nodes.push_back(current);
+		current = current->m_right;
+	}
+	node = buildBalanced(nodes, 0, static_cast<int>(nodes.size()) - 1);
+}
+
+// mergeBatch: insertBatch helper
+// Merges keys[low..high) into the subtree at link. Runs iteratively; when
+// spawn > 0 the left part of a large split is merged by another thread.
+// The node for keys[i], if one is needed, is built in nodes[i], and used[i]
+// is then set. Each node is finished after both of its sides, so under AVL
+// a side that grew by one level is fixed by rebalance and a side that grew
+// by more is rebuilt.
+// preconditions:	keys is sorted without repeats, counts holds their
+//					counts, and nodes[i] is an unused block for each i; no
+//					other thread touches the subtree at link.
+// postconditions:	every key in the range is in the subtree, which is
+//					balanced if m_policy is AVL. The number of new nodes and
+//					count increments is returned.
+//
+template<typename Key, typename Compare>
+InsertBatchResult BasicBSTree<Key, Compare>::mergeBatch(Node **link, const vector<Key> &keys,
+		const vector<int> &counts, const vector<Node*> &nodes, vector<char> &used, int low, int high,
+		int spawn) {
+	struct Frame {
+		Node **m_link;
+		int m_low;
+		int m_high;
+		int m_spawn;
+		bool m_split;
+		future<InsertBatchResult> m_left;
+	};
+
+	InsertBatchResult result = { 0, 0 };
+	vector<Frame> stack;
+	stack.push_back(Frame());
+	stack.back().m_link = link;
+	stack.back().m_low = low;
+	stack.back().m_high = high;
+	stack.back().m_spawn = spawn;
+	stack.back().m_split = false;
+
+	while(!stack.empty()) {
+		Frame &frame = stack.back();
+		Node *node = *frame.m_link;
+
+		if(frame.m_split) {
+			if(frame.m_left.valid()) {
+				InsertBatchResult left = frame.m_left.get();
+				result.m_created += left.m_created;
+				result.m_incremented += left.m_incremented;
+			}
+			int balance = height(node->m_left) - height(node->m_right);
+			if(m_policy == AVL && (balance > 2 || balance < -2)) {
+				rebuildSubtree(*frame.m_link);
+			} else {
+				rebalance(*frame.m_link);
+			}
+			stack.pop_back();
+			continue;
+		}
+
+		if(node == nullptr) {
+			// nothing is below here, so the whole run becomes a new subtree
+			for(int i = frame.m_low; i < frame.m_high; i++) {
+				new(nodes[i]) Node(keys[i]);
+				nodes[i]->m_itemCount = counts[i];
+				used[i] = 1;
+				result.m_created++;
+				result.m_incremented += counts[i] - MIN_ITEM_COUNT;
+			}
+			*frame.m_link = buildBalanced(nodes, frame.m_low, frame.m_high - 1);
+			stack.pop_back();
+			continue;
+		}
+
+		// keys[low..mid) go left; a key equal to node's lands at mid
+		int mid = static_cast<int>(lower_bound(keys.begin() + frame.m_low, keys.begin() + frame.m_high,
+				node->m_item, m_compare) - keys.begin());
+		int right = mid;
+		if(mid < frame.m_high && isEqual(keys[mid], node->m_item)) {
+			node->m_itemCount += counts[mid];
+			result.m_incremented += counts[mid];
+			right = mid + 1;
+		}
+
+		Frame leftFrame;
+		leftFrame.m_link = &node->m_left;
+		leftFrame.m_low = frame.m_low;
+		leftFrame.m_high = mid;
+		leftFrame.m_spawn = frame.m_spawn - 1;
+		leftFrame.m_split = false;
+		Frame rightFrame;
+		rightFrame.m_link = &node->m_right;
+		rightFrame.m_low = right;
+		rightFrame.m_high = frame.m_high;
+		rightFrame.m_spawn = frame.m_spawn - 1;
+		rightFrame.m_split = false;
+		frame.m_split = true;
+
+		bool parallel = frame.m_spawn > 0 && mid - frame.m_low >= BATCH_PARALLEL_GRAIN &&
+				frame.m_high - right >= BATCH_PARALLEL_GRAIN;
+		if(parallel) {
+			frame.m_left = async(launch::async, &BasicBSTree::mergeBatch, this, leftFrame.m_link,
+					cref(keys), cref(counts), cref(nodes), ref(used), leftFrame.m_low, leftFrame.m_high,
+					leftFrame.m_spawn);
+		}
+		// frame is invalidated by the pushes below
+		if(rightFrame.m_low < rightFrame.m_high) {
+			stack.push_back(std::move(rightFrame));
+		}
+		if(!parallel && leftFrame.m_low < leftFrame.m_high) {
+			stack.push_back(std::move(leftFrame));
+		}
+	}
+	return(result);
+}
+
+// applySetOperation: unionWith/intersectWith/differenceWith helper
+// Runs setNodes over the whole tree and returns unused or freed blocks to
+// m_pool. A tree that is this tree, or much deeper than a balanced tree,
+// is first copied and rebuilt so the recursion stays shallow. So is any
+// tree that is not AVL when this one is: setNodes copies its subtrees whole
+// and join needs them balanced.
+// preconditions:	tree must be a valid BasicBSTree object.
+// postconditions:	this holds the result of the operation.
+//
+template<typename Key, typename Compare>
+void BasicBSTree<Key, Compare>::applySetOperation(const BasicBSTree &tree, SetOperation operation,
+		CountPolicy policy) {
+	int count = size(tree.m_root);
+	int limit = 2;
+	for(int n = count; n > 1; n /= 2) {
+		limit += 2;
+	}
+	const BasicBSTree *source = &tree;
+	BasicBSTree balanced;
+	if(source == this || height(tree.m_root) > limit || (m_policy == AVL && tree.m_policy != AVL)) {
+		balanced = tree;
+		balanced.rebuild();
+		source = &balanced;
+	}
+
+	// a union may need a node for any key of the other tree, so each gets a
+	// block up front at its preorder index and the threads never share the
+	// pool; the blocks that are not needed are handed back afterwards
+	SetContext context = { operation, policy, nullptr, pool().getBlockSize(), nullptr };
+	vector<char> used;
+	if(operation == SET_UNION && count > 0) {
+		context.m_block = static_cast<char*>(pool().allocateBulk(count));
+		countAllocations(count);
+		used.assign(count, 0);
+		context.m_used = &used;
+	}
+
+	vector<Node*> garbage;
+	m_root = setNodes(m_root, source->m_root, 0, spawnDepth(), context, garbage);
+	for(size_t i = 0; i < garbage.size(); i++) {
+		poolOf(garbage[i])->deallocate(garbage[i]);
+	}
+	countFrees(garbage.size());
+	for(size_t i = 0; i < used.size(); i++) {
+		if(!used[i]) {
+			pool().deallocate(context.m_block + i * context.m_blockSize);
+			countFrees(1);
+		}
+	}
+}
+
+// setNodes: set operation helper
+// Splits mine at the root key of theirs, applies the operation to each side
+// against theirs' children, and joins the results. Nodes taken out of the
+// tree are destroyed and added to garbage for the caller to return to
+// m_pool.
+// preconditions:	index is the preorder index of theirs in the other tree;
+//					no other thread touches mine.
+// postconditions:	the root of the combined subtree is returned.
+//
+template<typename Key, typename Compare>
+typename BasicBSTree<Key, Compare>::Node* BasicBSTree<Key, Compare>::setNodes(Node *mine, const Node *theirs,
+		int index, int spawn, const SetContext &context, vector<Node*> &garbage) {
+	if(theirs == nullptr) {
+		if(context.m_operation == SET_INTERSECTION) {
+			discardSubtree(mine, garbage);
+			return(nullptr);
+		}
+		return(mine);
+	}
+	if(mine == nullptr) {
+		if(context.m_operation != SET_UNION) {
+			return(nullptr);
+		}
+		Node *copy = nullptr;
+		copySubtree(&copy, theirs, context.m_block, context.m_blockSize, index, 0);
+		for(int i = index; i < index + size(theirs); i++) {
+			(*context.m_used)[i] = 1;
+		}
+		return(copy);
+	}
+
+	Node *left = nullptr;
+	Node *match = nullptr;
+	Node *right = nullptr;
+	split(mine, theirs->m_item, left, match, right);
+
+	int leftIndex = index + 1;
+	int rightIndex = index + 1 + size(theirs->m_left);
+	if(spawn > 0 && size(theirs->m_left) >= SET_PARALLEL_GRAIN && size(theirs->m_right) >= SET_PARALLEL_GRAIN) {
+		vector<Node*> leftGarbage;
+		future<Node*> task = async(launch::async, &BasicBSTree::setNodes, this, left, theirs->m_left,
+				leftIndex, spawn - 1, cref(context), ref(leftGarbage));
+		right = setNodes(right, theirs->m_right, rightIndex, spawn - 1, context, garbage);
+		left = task.get();
+		garbage.insert(garbage.end(), leftGarbage.begin(), leftGarbage.end());
+	} else {
+		left = setNodes(left, theirs->m_left, leftIndex, spawn, context, garbage);
+		right = setNodes(right, theirs->m_right, rightIndex, spawn, context, garbage);
+	}
+
+	Node *middle = nullptr;
+	if(match != nullptr) {
+		match->m_itemCount = combineCounts(match->m_itemCount, theirs->m_itemCount, context.m_policy);
+		if(match->m_itemCount >= MIN_ITEM_COUNT) {
+			middle = match;
+		} else {
+			match->~Node();
+			garbage.push_back(match);
+		}
+	} else if(context.m_operation == SET_UNION) {
+		middle = new(context.m_block + index * context.m_blockSize) Node(*theirs);
+		(*context.m_used)[index] = 1;
+	}
+	return(middle != nullptr ? join(left, middle, right) : joinTwo(left, right));
+}
+
+// combineCounts: set operation helper
+// preconditions:	none
+// postconditions:	mine and theirs combined by policy are returned
+//
+template<typename Key, typename Compare>
+int BasicBSTree<Key, Compare>::combineCounts(int mine, int theirs, CountPolicy policy) {
+	switch(policy) {
+	case COUNT_MIN:
+		return(mine < theirs ? mine : theirs);
+	case COUNT_MAX:
+		return(mine > theirs ? mine : theirs);
+	case COUNT_SUBTRACT:
+		return(mine - theirs);
+	default:
+		return(mine + theirs);
+	}
+}
+
+// discardSubtree: set operation helper
+// preconditions:	none
+// postconditions:	every node under node is destroyed and added to garbage
+//
+template<typename Key, typename Compare>
+void BasicBSTree<Key, Compare>::discardSubtree(Node *node, vector<Node*> &garbage) {
+	vector<Node*> stack;
+	if(node != nullptr) {
+		stack.push_back(node);
+	}
+	while(!stack.empty()) {
+		node = stack.back();
+		stack.pop_back();
+		if(node->m_left != nullptr) {
+			stack.push_back(node->m_left);
+		}
+		if(node->m_right != nullptr) {
+			stack.push_back(node->m_right);
+		}
+		node->~Node();
+		garbage.push_back(node);
+	}
+}
+
+// split: set operation helper
+// Divides the subtree under node into the keys ordered before data and the
+// keys ordered after it, detaching the node equal to data. Under AVL each
+// piece is rebuilt with join on the way back up, which keeps it balanced;
+// otherwise the pieces are linked directly in one iterative pass down.
+// preconditions:	none
+// postconditions:	left and right hold the smaller and larger keys, and are
+//					balanced if m_policy is AVL. match is the node equal to
+//					data with no children, or nullptr.
+//
+template<typename Key, typename Compare>
+void BasicBSTree<Key, Compare>::split(Node *node, const Key &data, Node *&left, Node *&match, Node *&right) {
+	if(m_policy == AVL) {
+		if(node == nullptr) {
+			left = nullptr;
+			match = nullptr;
+			right = nullptr;
+		} else if(isLess(data, node->m_item)) {
+			Node *rest = nullptr;
+			split(node->m_left, data, left, match, rest);
+			right = join(rest, node, node->m_right);
+		} else if(isLess(node->m_item, data)) {
+			Node *rest = nullptr;
+			split(node->m_right, data, rest, match, right);
+			left = join(node->m_left, node, rest);
+		} else {
+			left = node->m_left;
+			right = node->m_right;
+			match = node;
+			match->m_left = nullptr;
+			match->m_right = nullptr;
+			update(match);
+		}
+		return;
+	}
+
+	left = nullptr;
+	match = nullptr;
+	right = nullptr;
+	Node **leftTail = &left;
+	Node **rightTail = &right;
+	vector<Node*> leftPath;
+	vector<Node*> rightPath;
+	while(node != nullptr) {
+		if(isLess(data, node->m_item)) {
+			*rightTail = node;
+			rightPath.push_back(node);
+			rightTail = &node->m_left;
+			node = node->m_left;
+		} else if(isLess(node->m_item, data)) {
+			*leftTail = node;
+			leftPath.push_back(node);
+			leftTail = &node->m_right;
+			node = node->m_right;
+		} else {
+			match = node;
+			node = nullptr;
+		}
+	}
+	*leftTail = match != nullptr ? match->m_left : nullptr;
+	*rightTail = match != nullptr ? match->m_right : nullptr;
+	if(match != nullptr) {
+		match->m_left = nullptr;
+		match->m_right = nullptr;
+		update(match);
+	}
+	for(size_t i = leftPath.size(); i > 0; i--) {
+		update(leftPath[i - 1]);
+	}
+	for(size_t i = rightPath.size(); i > 0; i--) {
+		update(rightPath[i - 1]);
+	}
+}
+
+// join: set operation helper
+// Links middle between two subtrees whose keys are all smaller and all
+// larger than middle's. Under AVL the shorter subtree is hung at the
+// matching height on the taller one's spine and rebalanced upward.
+// preconditions:	middle not equal to nullptr; left and right are balanced
+//					if m_policy is AVL.
+// postconditions:	the root of the joined subtree is returned.
+//
+template<typename Key, typename Compare>
+typename BasicBSTree<Key, Compare>::Node* BasicBSTree<Key, Compare>::join(Node *left, Node *middle, Node *right) {
+	if(m_policy == AVL) {
+		if(height(left) > height(right) + 1) {
+			return(joinRight(left, middle, right));
+		}
+		if(height(right) > height(left) + 1) {
+			return(joinLeft(left, middle, right));
+		}
+	}
+	middle->m_left = left;
+	middle->m_right = right;
+	update(middle);
+	return(middle);
+}
+
+// joinRight: join helper
+// Walks down the right spine of left to a subtree no more than one level
+// taller than right, joins there, and rebalances each spine node on the
+// way back up.
+// preconditions:	left is taller than right by more than one.
+// postconditions:	the root of the joined, balanced subtree is returned.
+//
+template<typename Key, typename Compare>
+typename BasicBSTree<Key, Compare>::Node* BasicBSTree<Key, Compare>::joinRight(Node *left, Node *middle, Node *right) {
+	if(height(left->m_right) <= height(right) + 1) {
+		middle->m_left = left->m_right;
+		middle->m_right = right;
+		update(middle);
+		left->m_right = middle;
+	} else {
+		left->m_right = joinRight(left->m_right, middle, right);
+	}
+	rebalance(left);
+	return(left);
+}
+
+// joinLeft: join helper
+// The mirror image of joinRight, walking down the left spine of right.
+// preconditions:	right is taller than left by more than one.
+// postconditions:	the root of the joined, balanced subtree is returned.
+//
+template<typename Key, typename Compare>
+typename BasicBSTree<Key, Compare>::Node* BasicBSTree<Key, Compare>::joinLeft(Node *left, Node *middle, Node *right) {
+	if(height(right->m_left) <= height(left) + 1) {
+		middle->m_left = left;
+		middle->m_right = right->m_left;
+		update(middle);
+		right->m_left = middle;
+	} else {
+		right->m_left = joinLeft(left, middle, right->m_left);
+	}
+	rebalance(right);
+	return(right);
+}
+
+// joinTwo: set operation helper
+// Links two subtrees whose keys are all smaller and all larger
+// respectively, with no middle key. Under AVL the largest node of left is
+// taken out and used as the middle of join; otherwise right is hung below
+// the largest node of left.
+// preconditions:	left and right are balanced if m_policy is AVL.
+// postconditions:	the root of the joined subtree is returned.
+//
+template<typename Key, typename Compare>
+typename BasicBSTree<Key, Compare>::Node* BasicBSTree<Key, Compare>::joinTwo(Node *left, Node *right) {
+	if(left == nullptr) {
+		return(right);
+	}
+	if(right == nullptr) {
+		return(left);
+	}
+	if(m_policy == AVL) {
+		Node *largest = nullptr;
+		left = removeLargest(left, largest);
+		return(join(left, largest, right));
+	}
+
+	vector<Node*> path;
+	Node *node = left;
+	while(node->m_right != nullptr) {
+		path.push_back(node);
+		node = node->m_right;
+	}
+	node->m_right = right;
+	update(node);
+	for(size_t i = path.size(); i > 0; i--) {
+		update(path[i - 1]);
+	}
+	return(left);
+}
+
+// removeLargest: joinTwo helper
+// preconditions:	node not equal to nullptr; m_policy is AVL.
+// postconditions:	the largest node is detached into largest and the root
+//					of the remaining, balanced subtree is returned.
+//
+template<typename Key, typename Compare>
+typename BasicBSTree<Key, Compare>::Node* BasicBSTree<Key, Compare>::removeLargest(Node *node, Node *&largest) {
+	if(node->m_right == nullptr) {
+		largest = node;
+		Node *rest = node->m_left;
+		node->m_left = nullptr;
+		return(rest);
+	}
+	node->m_right = removeLargest(node->m_right, largest);
+	rebalance(node);
+	return(node);
+}
+
+// openFrame: diff helper
+// Replaces the whole subtree on top of frames with its right subtree, its
+// root alone and its left subtree, so the leftmost part is on top. Empty
+// subtrees are left out.
+// preconditions:	frames.back() is a whole subtree.
+// postconditions:	the subtree is opened one level
+//
+template<typename Key, typename Compare>
+void BasicBSTree<Key, Compare>::openFrame(vector<DiffFrame> &frames) {
+	const Node *node = frames.back().m_node;
+	frames.pop_back();
+	if(node->m_right != nullptr) {
+		DiffFrame right = {node->m_right, true};
+		frames.push_back(right);
+	}
+	DiffFrame middle = {node, false};
+	frames.push_back(middle);
+	if(node->m_left != nullptr) {
+		DiffFrame left = {node->m_left, true};
+		frames.push_back(left);
+	}
+}
+
+// isSameSubtree: diff helper
+// preconditions:	none
+// postconditions:	true is returned if self and other hold the same keys
+//					and counts in the same shape, judged by their hashes
+//					when keys are hashed and node by node otherwise
+//
+template<typename Key, typename Compare>
+bool BasicBSTree<Key, Compare>::isSameSubtree(const Node *self, const Node *other) const {
+	if(subtreeHash(self) != subtreeHash(other) || size(self) != size(other) || weight(self) != weight(other)) {
+		return(false);
+	}
+	return(hashesKeys() || compareNode(self, other));
+}
+
+// setCount: applyDelta helper
+// Sets the m_itemCount of the node holding data, removing the node if count
+// is below MIN_ITEM_COUNT, and rebalances the path to it.
+// preconditions:	this not equal to nullptr.
+// postconditions:	If data is found its count is count, or it is removed.
+//
+template<typename Key, typename Compare>
+void BasicBSTree<Key, Compare>::setCount(const Key &data, int count) {
+	vector<Node**> path;
+	Node **link = &m_root;
+	while(*link != nullptr && !isEqual(data, (*link)->m_item)) {
+		path.push_back(link);
+		link = isLess(data, (*link)->m_item) ? &(*link)->m_left : &(*link)->m_right;
+	}
+	if(*link == nullptr) {
+		return;
+	}
+
+	if(count < MIN_ITEM_COUNT) {
+		deleteNode(*link);
+	} else {
+		(*link)->m_itemCount = count;
+		path.push_back(link);
+	}
+	retrace(path);
+}
+
+// retrieve
+// Searches the tree for data, if found, a const pointer to that object is
+// returned, otherwise false is returned.
+// preconditions:	data must be a valid Key object (must not reference
+//					a dereferenced nullptr); this not equal to nullptr.
+// postconditions:	If data is found in the tree, a const pointer to the
+//					is returned. If data is not found them nullptr is
+//					returned.
+//
+template<typename Key, typename Compare>
+const Key* BasicBSTree<Key, Compare>::retrieve(const Key &data) const {
+	OperationTally tally(this, STAT_RETRIEVE);
+	Node* temp = m_root;
+	while(temp != nullptr) {
+		tally.visit();
+		if(isEqual(data, temp->m_item)) {
+			return(&temp->m_item);
+		} else if(isLess(data, temp->m_item)) {
+			temp = temp->m_left;
+		} else {
+			temp = temp->m_right;
+		}
+	}
+	return(nullptr);
+}
+
+// retrieveBatch
+// Searches the tree for every key in keys. The searches are run in groups
+// of LOOKUP_BATCH_GROUP that step down the tree one level at a time in turn,
+// and each prefetches the next node it will read, so the cache misses of a
+// whole group overlap instead of following one another.
+// preconditions:	this not equal to nullptr.
+// postconditions:	out holds one entry per key, in the same order: a const
+//					pointer to the matching key in the tree, or nullptr if
+//					the key is not found.
+//
+template<typename Key, typename Compare>
+void BasicBSTree<Key, Compare>::retrieveBatch(const vector<Key> &keys, vector<const Key*> &out) const {
+	vector<const Node*> nodes;
+	findBatch(keys, nodes, nullptr);
+	out.resize(keys.size());
+	for(size_t i = 0; i < nodes.size(); i++) {
+		out[i] = nodes[i] != nullptr ? &nodes[i]->m_item : nullptr;
+	}
+}
+
+// depthBatch
+// Finds the depth of every key in keys, overlapping the searches as
+// retrieveBatch does.
+// preconditions:	this not equal to nullptr.
+// postconditions:	out holds one entry per key, in the same order: the depth
+//					of its node, or -1 if the key is not found.
+//
+template<typename Key, typename Compare>
+void BasicBSTree<Key, Compare>::depthBatch(const vector<Key> &keys, vector<int> &out) const {
+	vector<const Node*> nodes;
+	findBatch(keys, nodes, &out);
+}
+
+// containsBatch
+// Tests every key in keys for membership, overlapping the searches as
+// retrieveBatch does.
+// preconditions:	this not equal to nullptr.
+// postconditions:	out holds one entry per key, in the same order: true if
+//					the key is in the tree, else false.
+//
+template<typename Key, typename Compare>
+void BasicBSTree<Key, Compare>::containsBatch(const vector<Key> &keys, vector<bool> &out) const {
+	vector<const Node*> nodes;
+	findBatch(keys, nodes, nullptr);
+	out.resize(keys.size());
+	for(size_t i = 0; i < nodes.size(); i++) {
+		out[i] = nodes[i] != nullptr;
+	}
+}
+
+// depth
+// Finds the depth of a node with m_item equal to data. Depth of m_root is 
+// equal to zero.
+// preconditions:	data must be a valid Key object (must not reference
+//					a dereferenced nullptr); this not equal to nullptr.
+// postconditions:	If data is found in the tree, the depth of the node
+//					containing data is returned. If data is not found then
+//					-1 is returned.
+//
+template<typename Key, typename Compare>
+int BasicBSTree<Key, Compare>::depth(const Key &data) const {
+	OperationTally tally(this, STAT_DEPTH);
+	int dep = 0;
+	Node* temp = m_root;
+	while(temp != nullptr) {
+		tally.visit();
+		if(isEqual(data, temp->m_item)) {
+			return(dep);
+		} else if(isLess(data, temp->m_item)) {
+			dep++;
+			temp = temp->m_left;
+		} else {
+			dep++;
+			temp = temp->m_right;
+		}
+	}
+	return(VALUE_NOT_FOUND);
+}
+
+// descendants
+// Finds the number of descendants of the node containing data. The count is
+// read from the node's m_size, so the cost is that of finding the node.
+// preconditions:	data must be a valid Key object (must not reference
+//					a dereferenced nullptr); this not equal to nullptr.
+// postconditions:	If data is found, the number of descendants are of the
+//					node containing data are counted and returned. If data
+//					is not found, -1 is returned.
+//
+template<typename Key, typename Compare>
+int BasicBSTree<Key, Compare>::descendants(const Key &data) const {
+	const Node* temp = findNode(data);
+	if(temp == nullptr) {
+		return(VALUE_NOT_FOUND);
+	}
+	// every node below temp is counted in its m_size
+	return(temp->m_size - 1);
+}
+
+// findNode: descendants helper
+// finds a Node with m_item equal to data and retunrs a constant pointer to
+// the Node. If no match is found, nullptr is returned.
+// preconditions:	data must be a valid Key object (must not reference
+//					a dereferenced nullptr); this not equal to nullptr.
+// postconditions:	if data is found, then a constant pointer to the Node 
+//					containing data is returned, else false is returned.
+//
+template<typename Key, typename Compare>
+const typename BasicBSTree<Key, Compare>::Node* BasicBSTree<Key, Compare>::findNode(const Key &data) const {
+	Node* temp = m_root;
+	while(temp != nullptr) {
+		if(isEqual(data, temp->m_item)) {
+			return(temp);
+		} else if(isLess(data, temp->m_item)) {
+			temp = temp->m_left;
+		} else {
+			temp = temp->m_right;
+		}
+	}
+	return(nullptr);
+}
+
+// size
+// Returns the number of distinct keys (nodes) in the tree.
+// preconditions:	this not equal to nullptr.
+// postconditions:	m_root's m_size is returned, or 0 for an empty tree.
+//
+template<typename Key, typename Compare>
+int BasicBSTree<Key, Compare>::size() const {
+	return(size(m_root));
+}
+
+// rank
+// Counts the distinct keys ordered before data. Runs in O(depth) using the
+// m_size kept in every node.
+// preconditions:	data must be a valid Key object (must not reference
+//					a dereferenced nullptr); this not equal to nullptr.
+// postconditions:	the number of nodes whose m_item is less than data is
+//					returned, whether or not data is in the tree.
+//
+template<typename Key, typename Compare>
+int BasicBSTree<Key, Compare>::rank(const Key &data) const {
+	int count = 0;
+	Node *temp = m_root;
+	while(temp != nullptr) {
+		if(isLess(temp->m_item, data)) {
+			count += size(temp->m_left) + 1;
+			temp = temp->m_right;
+		} else if(isEqual(data, temp->m_item)) {
+			return(count + size(temp->m_left));
+		} else {
+			temp = temp->m_left;
+		}
+	}
+	return(count);
+}
+
+// weightedRank
+// Counts the items ordered before data, including duplicates. Runs in
+// O(depth) using the m_weight kept in every node.
+// preconditions:	data must be a valid Key object (must not reference
+//					a dereferenced nullptr); this not equal to nullptr.
+// postconditions:	the sum of m_itemCount over nodes whose m_item is less
+//					than data is returned.
+//
+template<typename Key, typename Compare>
+int BasicBSTree<Key, Compare>::weightedRank(const Key &data) const {
+	int count = 0;
+	Node *temp = m_root;
+	while(temp != nullptr) {
+		if(isLess(temp->m_item, data)) {
+			count += weight(temp->m_left) + temp->m_itemCount;
+			temp = temp->m_right;
+		} else if(isEqual(data, temp->m_item)) {
+			return(count + weight(temp->m_left));
+		} else {
+			temp = temp->m_left;
+		}
+	}
+	return(count);
+}
+
+// select
+// Finds the key with the given rank (0 is the smallest). Runs in O(depth).
+// preconditions:	this not equal to nullptr.
+// postconditions:	If 0 <= index < size(), a const pointer to the key of
+//					that rank is returned, else nullptr is returned.
+//
+template<typename Key, typename Compare>
+const Key* BasicBSTree<Key, Compare>::select(int index) const {
+	if(index < 0 || index >= size(m_root)) {
+		return(nullptr);
+	}
+	Node *temp = m_root;
+	while(temp != nullptr) {
+		int leftSize = size(temp->m_left);
+		if(index < leftSize) {
+			temp = temp->m_left;
+		} else if(index == leftSize) {
+			return(&temp->m_item);
+		} else {
+			index -= leftSize + 1;
+			temp = temp->m_right;
+		}
+	}
+	return(nullptr);
+}
+
+// isEmpty
+// Returns true is tree is empty, else false
+// preconditions:	this not equal to nullptr.
+// postconditions:	If m_root equals nullptr true is returned, else false
+//
+template<typename Key, typename Compare>
+bool BasicBSTree<Key, Compare>::isEmpty() const {
+	if(m_root == nullptr) {
+		return(true);
+	}
+	return(false);
+}
+
+// freeze
+// Compiles the tree into a BasicFrozenIndex: an immutable copy of its keys
+// and counts in Eytzinger order, searched without pointers or branches on
+// keys. The tree is unchanged and may go on being modified; the index does
+// not follow. Runs in O(n).
+// preconditions:	this not equal to nullptr.
+// postconditions:	an index holding every key and count of the tree is
+//					returned
+//
+template<typename Key, typename Compare>
+BasicFrozenIndex<Key, Compare> BasicBSTree<Key, Compare>::freeze() const {
+	BasicFrozenIndex<Key, Compare> index;
+	index.build(begin(), size(), m_compare);
+	return(index);
+}
+
+// diff
+// Lists the changes that give this tree the keys and counts of tree, for
+// applyDelta. Both trees are walked in order side by side, and a pair of
+// subtrees with the same hash, size and weight is passed over whole without
+// being visited. Where the parts on top of the two walks differ, the larger
+// one is opened a level, so subtrees that rotations have moved line up
+// again a few levels further down.
+// preconditions:	tree must be a valid BasicBSTree object (must not
+//					reference a dereferenced nullptr); this not equal to
+//					nullptr.
+// postconditions:	one entry is returned for each key whose count differs
+//					between the trees (a missing key counting as 0), in
+//					ascending order. Both trees are unchanged.
+//
+template<typename Key, typename Compare>
+vector<typename BasicBSTree<Key, Compare>::DeltaEntry> BasicBSTree<Key, Compare>::diff(const BasicBSTree &tree) const {
+	vector<DeltaEntry> delta;
+	vector<DiffFrame> mine;
+	vector<DiffFrame> theirs;
+	if(m_root != nullptr && this != &tree) {
+		DiffFrame frame = {m_root, true};
+		mine.push_back(frame);
+	}
+	if(tree.m_root != nullptr && this != &tree) {
+		DiffFrame frame = {tree.m_root, true};
+		theirs.push_back(frame);
+	}
+
+	while(!mine.empty() && !theirs.empty()) {
+		const DiffFrame &lhs = mine.back();
+		const DiffFrame &rhs = theirs.back();
+		if(lhs.m_whole && rhs.m_whole && isSameSubtree(lhs.m_node, rhs.m_node)) {
+			mine.pop_back();
+			theirs.pop_back();
+			continue;
+		}
+		if(lhs.m_whole || rhs.m_whole) {
+			// open the larger part, or both if they are the same size
+			int l_size = lhs.m_whole ? size(lhs.m_node) : 1;
+			int r_size = rhs.m_whole ? size(rhs.m_node) : 1;
+			bool openMine = lhs.m_whole && l_size >= r_size;
+			bool openTheirs = rhs.m_whole && r_size >= l_size;
+			if(openMine) {
+				openFrame(mine);
+			}
+			if(openTheirs) {
+				openFrame(theirs);
+			}
+			continue;
+		}
+
+		const Node *self = lhs.m_node;
+		const Node *other = rhs.m_node;
+		if(isLess(self->m_item, other->m_item)) {
+			DeltaEntry entry = {DELTA_REMOVE, self->m_item, 0};
+			delta.push_back(entry);
+			mine.pop_back();
+		} else if(isLess(other->m_item, self->m_item)) {
+			DeltaEntry entry = {DELTA_INSERT, other->m_item, other->m_itemCount};
+			delta.push_back(entry);
+			theirs.pop_back();
+		} else {
+			if(self->m_itemCount != other->m_itemCount) {
+				DeltaEntry entry = {DELTA_COUNT, other->m_item, other->m_itemCount};
+				delta.push_back(entry);
+			}
+			mine.pop_back();
+			theirs.pop_back();
+		}
+	}
+
+	// whatever is left of one tree has no counterpart in the other
+	while(!mine.empty()) {
+		if(mine.back().m_whole) {
+			openFrame(mine);
+			continue;
+		}
+		DeltaEntry entry = {DELTA_REMOVE, mine.back().m_node->m_item, 0};
+		delta.push_back(entry);
+		mine.pop_back();
+	}
+	while(!theirs.empty()) {
+		if(theirs.back().m_whole) {
+			openFrame(theirs);
+			continue;
+		}
+		DeltaEntry entry = {DELTA_INSERT, theirs.back().m_node->m_item, theirs.back().m_node->m_itemCount};
+		delta.push_back(entry);
+		theirs.pop_back();
+	}
+	return(delta);
+}
+
+// getPolicy
+// Returns the BalancePolicy the tree was constructed with
+// preconditions:	this not equal to nullptr.
+// postconditions:	m_policy is returned
+//
+template<typename Key, typename Compare>
+BalancePolicy BasicBSTree<Key, Compare>::getPolicy() const {
+	return(m_policy);
+}
+
+// stats
+// Takes a snapshot of the tree's counters and shape for monitoring. The
+// counters are only kept when BSTREE_STATS is defined. The depth figures are
+// measured by walking the tree at the time of the call, in O(n), and are
+// always filled in.
+// preconditions:	this not equal to nullptr.
+// postconditions:	the current TreeStats of the tree are returned
+//
+template<typename Key, typename Compare>
+TreeStats BasicBSTree<Key, Compare>::stats() const {
+	TreeStats result;
+	OperationStats *operations[STAT_OPERATIONS] = { &result.m_insert, &result.m_remove,
+			&result.m_retrieve, &result.m_depth };
+#ifdef BSTREE_STATS
+	result.m_countersEnabled = true;
+	for(int i = 0; i < STAT_OPERATIONS; i++) {
+		operations[i]->m_calls = m_statCounters.m_calls[i].load(memory_order_relaxed);
+		operations[i]->m_comparisons = m_statCounters.m_comparisons[i].load(memory_order_relaxed);
+		operations[i]->m_nodesVisited = m_statCounters.m_nodesVisited[i].load(memory_order_relaxed);
+	}
+	result.m_allocations = m_statCounters.m_allocations.load(memory_order_relaxed);
+	result.m_frees = m_statCounters.m_frees.load(memory_order_relaxed);
+#else
+	result.m_countersEnabled = false;
+	for(int i = 0; i < STAT_OPERATIONS; i++) {
+		operations[i]->m_calls = 0;
+		operations[i]->m_comparisons = 0;
+		operations[i]->m_nodesVisited = 0;
+	}
+	result.m_allocations = 0;
+	result.m_frees = 0;
+#endif
+
+	long long depthTotal = 0;
+	vector<pair<const Node*, int> > stack;
+	if(m_root != nullptr) {
+		stack.push_back(make_pair(m_root, 0));
+	}
+	while(!stack.empty()) {
+		const Node *node = stack.back().first;
+		int dep = stack.back().second;
+		stack.pop_back();
+		if(static_cast<size_t>(dep) >= result.m_depthHistogram.size()) {
+			result.m_depthHistogram.resize(dep + 1, 0);
+		}
+		result.m_depthHistogram[dep]++;
+		depthTotal += dep;
+		if(node->m_left != nullptr) {
+			stack.push_back(make_pair(node->m_left, dep + 1));
+		}
+		if(node->m_right != nullptr) {
+			stack.push_back(make_pair(node->m_right, dep + 1));
+		}
+	}
+	result.m_maxDepth = static_cast<int>(result.m_depthHistogram.size()) - 1;
+	result.m_averageDepth = m_root == nullptr ? 0 : static_cast<double>(depthTotal) / size();
+	return(result);
+}
+
+// memoryFootprint
+// Returns the number of bytes the tree holds: the tree object and every
+// chunk of the pools its nodes are carved from. Memory that keys own
+// elsewhere, such as the text of a string, is not counted.
+// preconditions:	this not equal to nullptr.
+// postconditions:	the footprint in bytes is returned
+//
+template<typename Key, typename Compare>
+size_t BasicBSTree<Key, Compare>::memoryFootprint() const {
+	size_t bytes = sizeof(*this) + (m_pool ? m_pool->getReservedBytes() : 0);
+	bytes += m_foreignPools.capacity() * sizeof(shared_ptr<MemoryPool>);
+	for(size_t i = 0; i < m_foreignPools.size(); i++) {
+		bytes += m_foreignPools[i]->getReservedBytes();
+	}
+	return(bytes);
+}
+
+// hash
+// Returns the hash of the whole tree, kept up to date by every change. It
+// covers each key, its m_itemCount and the shape of the tree, so two trees
+// that are equal (operator==) always have the same hash, and trees with
+// different hashes are never equal. Keys only count towards it when
+// KeyTraits hashes Key and Compare is less<Key> or greater<Key>.
+// preconditions:	this not equal to nullptr.
+// postconditions:	the hash of the tree is returned
+//
+template<typename Key, typename Compare>
+uint64_t BasicBSTree<Key, Compare>::hash() const {
+	return(subtreeHash(m_root));
+}
+
+// assignment
+// Sets this equal to tree. Performs a deep copy.
+// preconditions:	tree must be a valid BSTree object (must not reference
+//					a dereferenced nullptr); this not equal to nullptr.
+// postconditions:	this becomes an identical node-by-node copy of tree,
+//					creating new Nodes and new Keys, and adopts the
+//					BalancePolicy of tree.
+//
+template<typename Key, typename Compare>
+const BasicBSTree<Key, Compare>& BasicBSTree<Key, Compare>::operator=(const BasicBSTree &tree) {
+	if(this != &tree) {
+		makeEmpty();
+		m_policy = tree.m_policy;
+		m_compare = tree.m_compare;
+		copyNode(m_root, tree.m_root);
+	}
+	return(*this);
+}
+
+// move assignment
+// Deletes the nodes of this, then takes over the nodes of tree without
+// copying or allocating any of them.
+// preconditions:	tree must be a valid BSTree object (must not reference a
+//					dereferenced nullptr)
+// postconditions:	this holds what tree held, with its BalancePolicy; tree
+//					is left empty.
+//
+template<typename Key, typename Compare>
+const BasicBSTree<Key, Compare>& BasicBSTree<Key, Compare>::operator=(BasicBSTree &&tree) noexcept {
+	if(this != &tree) {
+		makeEmpty();
+		swap(tree);
+	}
+	return(*this);
+}
+
+// equality
+// Node-by-node comparison of this and tree. Returns true only if the 
+// trees have the same data (including m_itemCount) and structure. Trees
+// whose hashes differ are told apart in O(1); the nodes are only walked
+// when the hashes match.
+// preconditions:	tree must be a valid BSTree object (must not reference
+//					a dereferenced nullptr); this not equal to nullptr.
+// postconditions:	If this and tree have same data and structure then true
+//					is returned, else false is returned.
+//
+template<typename Key, typename Compare>
+bool BasicBSTree<Key, Compare>::operator==(const BasicBSTree &tree) const {
+	if(this == &tree) {
+		return(true);
+	}
+	if(subtreeHash(m_root) != subtreeHash(tree.m_root)) {
+		return(false);
+	}
+	return(compareNode(m_root, tree.m_root));
+}
+
+// compareNode: equality helper
+// Node-by-node comparison of this and tree. Returns true only if the 
+// trees have the same data (including m_itemCount) and structure
+// preconditions:	this not equal to nullptr
+// postconditions:	If self and other have same data and structure then true
+//					is returned, else false is returned.
+//
+template<typename Key, typename Compare>
+bool BasicBSTree<Key, Compare>::compareNode(const Node *self, const Node *other) const {
+	vector<pair<const Node*, const Node*> > stack;
+	stack.push_back(make_pair(self, other));
+	while(!stack.empty()) {
+		const Node *lhs = stack.back().first;
+		const Node *rhs = stack.back().second;
+		stack.pop_back();
+		if(lhs == nullptr || rhs == nullptr) {
+			if(lhs != rhs) {
+				return(false);
+			}
+			continue;
+		}
+		if(!isEqual(lhs->m_item, rhs->m_item) || lhs->m_itemCount != rhs->m_itemCount) {
+			return(false);
+		}
+		stack.push_back(make_pair(lhs->m_right, rhs->m_right));
+		stack.push_back(make_pair(lhs->m_left, rhs->m_left));
+	}
+	return(true);
+}
+
+// inequality
+// Node-by-node comparison of this and tree. Returns true only if the 
+// trees do not have the same data (including m_itemCount) and structure.
+// Trees whose hashes differ are told apart in O(1).
+// preconditions:	tree must be a valid BSTree object (must not reference
+//					a dereferenced nullptr); this not equal to nullptr.
+// postconditions:	If this and tree do not have same data and structure
+//					then true is returned, else false is returned.
+//
+template<typename Key, typename Compare>
+bool BasicBSTree<Key, Compare>::operator!=(const BasicBSTree &tree) const {
+	if(!(*this == tree)) {
+		return(true);
+	}
+	return(false);
+}
+
+// write(ostream &sout)
+// Prints the contents of the tree to sout in the same format as
+// operator<<, but formats into a large buffer and hands it to sout in big
+// chunks. Keys are formatted with KeyTraits and counts without iostream
+// formatting.
+// preconditions:	this not equal to nullptr.
+// postconditions:	the contents of this are written to sout. Each line
+//					contains a Node in the format: "m_item m_itemCount".
+//					false is returned if sout failed.
+//
+template<typename Key, typename Compare>
+bool BasicBSTree<Key, Compare>::write(ostream &sout) const {
+	OutputBuffer out(sout);
+	write(out);
+	return(out.flush());
+}
+
+// write(int fd)
+// Prints the contents of the tree to the file descriptor fd in the same
+// format as operator<<, using large write calls.
+// preconditions:	fd must be open for writing; this not equal to nullptr.
+// postconditions:	the contents of this are written to fd. false is
+//					returned if a write failed.
+//
+template<typename Key, typename Compare>
+bool BasicBSTree<Key, Compare>::write(int fd) const {
+	OutputBuffer out(fd);
+	write(out);
+	return(out.flush());
+}
+
+// write: output helper
+// Formats every node in order into out.
+// preconditions:	none
+// postconditions:	each node is appended to out as "m_item m_itemCount\n"
+//
+template<typename Key, typename Compare>
+void BasicBSTree<Key, Compare>::write(OutputBuffer &out) const {
+	vector<const Node*> stack;
+	const Node *node = m_root;
+	while(node != nullptr || !stack.empty()) {
+		while(node != nullptr) {
+			stack.push_back(node);
+			node = node->m_left;
+		}
+		node = stack.back();
+		stack.pop_back();
+		KeyTraits<Key>::format(out, node->m_item);
+		out.append(' ');
+		out.appendInt(node->m_itemCount);
+		out.append('\n');
+		node = node->m_right;
+	}
+}
+
+// saveSnapshot
+// Writes the tree to path in a compact binary form: a SnapshotHeader
+// followed by the keys, counts and shape of every node in preorder. No
+// pointers are stored, and loadSnapshot restores the exact structure.
+// preconditions:	KeyTraits<Key> must encode keys; this not equal to
+//					nullptr.
+// postconditions:	true is returned if the whole snapshot was written.
+//
+template<typename Key, typename Compare>
+bool BasicBSTree<Key, Compare>::saveSnapshot(const string &path) const {
+	SnapshotHeader header = SnapshotHeader();
+	memcpy(header.m_magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+	header.m_version = SNAPSHOT_VERSION;
+	header.m_byteOrder = SNAPSHOT_BYTE_ORDER;
+	header.m_keySize = KeyTraits<Key>::ENCODED_SIZE;
+	header.m_keyTag = KeyTraits<Key>::KEY_TAG;
+	header.m_policy = m_policy;
+	header.m_nodeCount = size(m_root);
+
+	const size_t count = header.m_nodeCount;
+	const size_t keySize = header.m_keySize;
+	vector<char> payload(header.payloadSize());
+	char *keys = payload.data();
+	char *counts = keys + count * keySize;
+	char *shape = counts + count * sizeof(int32_t);
+
+	size_t i = 0;
+	vector<const Node*> stack;
+	if(m_root != nullptr) {
+		stack.push_back(m_root);
+	}
+	while(!stack.empty()) {
+		const Node *node = stack.back();
+		stack.pop_back();
+		KeyTraits<Key>::encode(node->m_item, keys + i * keySize);
+		int32_t itemCount = node->m_itemCount;
+		memcpy(counts + i * sizeof(int32_t), &itemCount, sizeof(int32_t));
+		shape[i] = 0;
+		if(node->m_right != nullptr) {
+			shape[i] |= SNAPSHOT_HAS_RIGHT;
+			stack.push_back(node->m_right);
+		}
+		if(node->m_left != nullptr) {
+			shape[i] |= SNAPSHOT_HAS_LEFT;
+			stack.push_back(node->m_left);
+		}
+		i++;
+	}
+	header.m_checksum = SnapshotHeader::checksum(payload.data(), payload.size());
+
+	ofstream file(path.c_str(), ios::binary | ios::trunc);
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	file.write(payload.data(), payload.size());
+	file.close();
+	return(!file.fail());
+}
+
+// findBatch: batch lookup helper
+// Runs the searches for keys in groups of LOOKUP_BATCH_GROUP, moving each
+// unfinished search of a group one level down per round and prefetching the
+// node it moves to. By the time a round comes back to a search, its node
+// has had the rest of the round to arrive in the cache.
+// preconditions:	none
+// postconditions:	nodes holds the node matching each key, or nullptr. If
+//					depths is not nullptr it holds the depth of each node,
+//					or -1.
+//
+template<typename Key, typename Compare>
+void BasicBSTree<Key, Compare>::findBatch(const vector<Key> &keys, vector<const Node*> &nodes,
+		vector<int> *depths) const {
+	nodes.assign(keys.size(), nullptr);
+	if(depths != nullptr) {
+		depths->assign(keys.size(), VALUE_NOT_FOUND);
+	}
+	const Node *cursor[LOOKUP_BATCH_GROUP];
+	int level[LOOKUP_BATCH_GROUP];
+	for(size_t first = 0; first < keys.size(); first += LOOKUP_BATCH_GROUP) {
+		int count = static_cast<int>(min(keys.size() - first, static_cast<size_t>(LOOKUP_BATCH_GROUP)));
+		int active = 0;
+		for(int i = 0; i < count; i++) {
+			cursor[i] = m_root;
+			level[i] = 0;
+			active += m_root != nullptr;
+		}
+		prefetch(m_root);
+
+		while(active > 0) {
+			for(int i = 0; i < count; i++) {
+				const Node *node = cursor[i];
+				if(node == nullptr) {
+					continue;
+				}
+				const Key &data = keys[first + i];
+				if(isLess(data, node->m_item)) {
+					node = node->m_left;
+				} else if(isLess(node->m_item, data)) {
+					node = node->m_right;
+				} else {
+					nodes[first + i] = node;
+					if(depths != nullptr) {
+						(*depths)[first + i] = level[i];
+					}
+					node = nullptr;
+				}
+				if(node == nullptr) {
+					active--;
+				} else {
+					prefetch(node);
+					level[i]++;
+				}
+				cursor[i] = node;
+			}
+		}
+	}
+}
+
+// prefetch: batch lookup helper
+// Hints the processor to start loading node. Has no effect on compilers
+// without a prefetch builtin.
+// preconditions:	none
+// postconditions:	none; node is never dereferenced
+//
+template<typename Key, typename Compare>
+void BasicBSTree<Key, Compare>::prefetch(const Node *node) {
+#if defined(__GNUC__)
+	__builtin_prefetch(node);
+#else
+	(void)node;
+#endif
+}
+
+// isLess: comparison helper
+// Orders two keys with m_compare.
+// preconditions:	none
+// postconditions:	true is returned if lhs is ordered before rhs.
+//
+template<typename Key, typename Compare>
+bool BasicBSTree<Key, Compare>::isLess(const Key &lhs, const Key &rhs) const {
+	countComparison();
+	return(m_compare(lhs, rhs));
+}
+
+// isEqual: comparison helper
+// Two keys are equal when neither is ordered before the other by m_compare.
+// preconditions:	none
+// postconditions:	true is returned if lhs and rhs are equivalent.
+//
+template<typename Key, typename Compare>
+bool BasicBSTree<Key, Compare>::isEqual(const Key &lhs, const Key &rhs) const {
+	countComparison();
+	if(m_compare(lhs, rhs)) {
+		return(false);
+	}
+	countComparison();
+	return(!m_compare(rhs, lhs));
+}
+
+// comparisonTally: instrumentation helper
+// Kept per thread so that lookups running at once in several threads never
+// write to the same counter; each OperationTally reads how far it moved.
+// preconditions:	none
+// postconditions:	the number of key comparisons the calling thread has
+//					made in trees of this type is returned
+//
+template<typename Key, typename Compare>
+long long& BasicBSTree<Key, Compare>::comparisonTally() {
+	static thread_local long long tally = 0;
+	return(tally);
+}
+
+// countComparison: instrumentation helper
+// preconditions:	none
+// postconditions:	one comparison is counted if BSTREE_STATS is defined
+//
+template<typename Key, typename Compare>
+void BasicBSTree<Key, Compare>::countComparison() {
+#ifdef BSTREE_STATS
+	comparisonTally()++;
+#endif
+}
+
+// countAllocations: instrumentation helper
+// preconditions:	none
+// postconditions:	count node allocations are counted if BSTREE_STATS is
+//					defined
+//
+template<typename Key, typename Compare>
+void BasicBSTree<Key, Compare>::countAllocations(size_t count) const {
+#ifdef BSTREE_STATS
+	m_statCounters.m_allocations.fetch_add(static_cast<long long>(count), memory_order_relaxed);
+#else
+	(void)count;
+#endif
+}
+
+// countFrees: instrumentation helper
+// preconditions:	none
+// postconditions:	count node frees are counted if BSTREE_STATS is defined
+//
+template<typename Key, typename Compare>
+void BasicBSTree<Key, Compare>::countFrees(size_t count) const {
+#ifdef BSTREE_STATS
+	m_statCounters.m_frees.fetch_add(static_cast<long long>(count), memory_order_relaxed);
+#else
+	(void)count;
+#endif
+}
+
+#ifdef BSTREE_STATS
+// StatCounters default constructor
+// preconditions:	none
+// postconditions:	every counter is 0
+//
+template<typename Key, typename Compare>
+BasicBSTree<Key, Compare>::StatCounters::StatCounters() : m_allocations(0), m_frees(0) {
+	for(int i = 0; i < STAT_OPERATIONS; i++) {
+		m_calls[i].store(0);
+		m_comparisons[i].store(0);
+		m_nodesVisited[i].store(0);
+	}
+}
+#endif
+
+// OperationTally constructor(const BasicBSTree *tree, StatOperation operation)
+// preconditions:	tree not equal to nullptr.
+// postconditions:	starts counting one call of operation on tree
+//
+template<typename Key, typename Compare>
+BasicBSTree<Key, Compare>::OperationTally::OperationTally(const BasicBSTree *tree, StatOperation operation) :
+		m_tree(tree), m_operation(operation), m_comparisons(0), m_visited(0) {
+#ifdef BSTREE_STATS
+	m_comparisons = comparisonTally();
+#endif
+}
+
+// OperationTally destructor
+// preconditions:	none
+// postconditions:	the call and what it counted are added to the tree's
+//					counters
+//
+template<typename Key, typename Compare>
+BasicBSTree<Key, Compare>::OperationTally::~OperationTally() {
+#ifdef BSTREE_STATS
+	StatCounters &counters = m_tree->m_statCounters;
+	counters.m_calls[m_operation].fetch_add(1, memory_order_relaxed);
+	counters.m_comparisons[m_operation].fetch_add(comparisonTally() - m_comparisons, memory_order_relaxed);
+	counters.m_nodesVisited[m_operation].fetch_add(m_visited, memory_order_relaxed);
+#endif
+}
+
+// OperationTally visit
+// preconditions:	none
+// postconditions:	one more node visit is counted
+//
+template<typename Key, typename Compare>
+void BasicBSTree<Key, Compare>::OperationTally::visit() {
+#ifdef BSTREE_STATS
+	m_visited++;
+#endif
+}
+
+// const_iterator default constructor
+// preconditions:	none
+// postconditions:	creates an iterator that refers to no tree
+//
+template<typename Key, typename Compare>
+BasicBSTree<Key, Compare>::const_iterator::const_iterator() : m_tree(nullptr) {}
+
+// const_iterator constructor(const BasicBSTree *tree)
+// preconditions:	none
+// postconditions:	creates an end iterator over tree
+//
+template<typename Key, typename Compare>
+BasicBSTree<Key, Compare>::const_iterator::const_iterator(const BasicBSTree *tree) : m_tree(tree) {}
+
+// const_iterator dereference
+// preconditions:	this must not be an end iterator.
+// postconditions:	the key of the current node is returned
+//
+template<typename Key, typename Compare>
+const Key& BasicBSTree<Key, Compare>::const_iterator::operator*() const {
+	return(m_path.back()->m_item);
+}
+
+// const_iterator member access
+// preconditions:	this must not be an end iterator.
+// postconditions:	a pointer to the key of the current node is returned
+//
+template<typename Key, typename Compare>
+const Key* BasicBSTree<Key, Compare>::const_iterator::operator->() const {
+	return(&m_path.back()->m_item);
+}
+
+// const_iterator getCount
+// Returns the number of occurrences of the current key.
+// preconditions:	this must not be an end iterator.
+// postconditions:	the current node's m_itemCount is returned
+//
+template<typename Key, typename Compare>
+int BasicBSTree<Key, Compare>::const_iterator::getCount() const {
+	return(m_path.back()->m_itemCount);
+}
+
+// const_iterator pre-increment
+// Moves to the next key in ascending order.
+// preconditions:	this must not be an end iterator.
+// postconditions:	this refers to the in-order successor, or is the end
+//					iterator if there is none. this is returned.
+//
+template<typename Key, typename Compare>
+typename BasicBSTree<Key, Compare>::const_iterator& BasicBSTree<Key, Compare>::const_iterator::operator++() {
+	const Node *node = m_path.back();
+	if(node->m_right != nullptr) {
+		pushLeftmost(node->m_right);
+		return(*this);
+	}
+	// climb until we leave a left subtree; that parent is the successor
+	m_path.pop_back();
+	while(!m_path.empty() && m_path.back()->m_right == node) {
+		node = m_path.back();
+		m_path.pop_back();
+	}
+	return(*this);
+}
+
+// const_iterator post-increment
+// preconditions:	this must not be an end iterator.
+// postconditions:	this is advanced; its old position is returned
+//
+template<typename Key, typename Compare>
+typename BasicBSTree<Key, Compare>::const_iterator BasicBSTree<Key, Compare>::const_iterator::operator++(int) {
+	const_iterator old = *this;
+	++(*this);
+	return(old);
+}
+
+// const_iterator pre-decrement
+// Moves to the previous key in ascending order. Decrementing the end
+// iterator moves to the largest key.
+// preconditions:	this must not refer to the smallest key.
+// postconditions:	this refers to the in-order predecessor. this is
+//					returned.
+//
+template<typename Key, typename Compare>
+typename BasicBSTree<Key, Compare>::const_iterator& BasicBSTree<Key, Compare>::const_iterator::operator--() {
+	if(m_path.empty()) {
+		pushRightmost(m_tree->m_root);
+		return(*this);
+	}
+	const Node *node = m_path.back();
+	if(node->m_left != nullptr) {
+		pushRightmost(node->m_left);
+		return(*this);
+	}
+	// climb until we leave a right subtree; that parent is the predecessor
+	m_path.pop_back();
+	while(!m_path.empty() && m_path.back()->m_left == node) {
+		node = m_path.back();
+		m_path.pop_back();
+	}
+	return(*this);
+}
+
+// const_iterator post-decrement
+// preconditions:	this must not refer to the smallest key.
+// postconditions:	this is moved back; its old position is returned
+//
+template<typename Key, typename Compare>
+typename BasicBSTree<Key, Compare>::const_iterator BasicBSTree<Key, Compare>::const_iterator::operator--(int) {
+	const_iterator old = *this;
+	--(*this);
+	return(old);
+}
+
+// const_iterator equality
+// preconditions:	other must iterate over the same tree.
+// postconditions:	true is returned if both refer to the same node or
+//					both are end iterators.
+//
+template<typename Key, typename Compare>
+bool BasicBSTree<Key, Compare>::const_iterator::operator==(const const_iterator &other) const {
+	if(m_path.empty() || other.m_path.empty()) {
+		return(m_path.empty() && other.m_path.empty());
+	}
+	return(m_path.back() == other.m_path.back());
+}
+
+// const_iterator inequality
+// preconditions:	other must iterate over the same tree.
+// postconditions:	true is returned if the iterators differ.
+//
+template<typename Key, typename Compare>
+bool BasicBSTree<Key, Compare>::const_iterator::operator!=(const const_iterator &other) const {
+	return(!(*this == other));
+}
+
+// const_iterator pushLeftmost: traversal helper
+// Descends from node to the smallest key below it, adding each node
+// to m_path.
+// preconditions:	none
+// postconditions:	m_path ends at the leftmost node under node, or is
+//					unchanged if node is nullptr.
+//
+template<typename Key, typename Compare>
+void BasicBSTree<Key, Compare>::const_iterator::pushLeftmost(const Node *node) {
+	while(node != nullptr) {
+		m_path.push_back(node);
+		node = node->m_left;
+	}
+}
+
+// const_iterator pushRightmost: traversal helper
+// Descends from node to the largest key below it, adding each node to
+// m_path.
+// preconditions:	none
+// postconditions:	m_path ends at the rightmost node under node, or is
+//					unchanged if node is nullptr.
+//
+template<typename Key, typename Compare>
+void BasicBSTree<Key, Compare>::const_iterator::pushRightmost(const Node *node) {
+	while(node != nullptr) {
+		m_path.push_back(node);
+		node = node->m_right;
+	}
+}
+
+// Range begin
+// preconditions:	none
+// postconditions:	m_begin is returned
+//
+template<typename Key, typename Compare>
+typename BasicBSTree<Key, Compare>::const_iterator BasicBSTree<Key, Compare>::Range::begin() const {
+	return(m_begin);
+}
+
+// Range end
+// preconditions:	none
+// postconditions:	m_end is returned
+//
+template<typename Key, typename Compare>
+typename BasicBSTree<Key, Compare>::const_iterator BasicBSTree<Key, Compare>::Range::end() const {
+	return(m_end);
+}
+
+// begin
+// preconditions:	this not equal to nullptr.
+// postconditions:	an iterator to the smallest key is returned, or end()
+//					if the tree is empty.
+//
+template<typename Key, typename Compare>
+typename BasicBSTree<Key, Compare>::const_iterator BasicBSTree<Key, Compare>::begin() const {
+	const_iterator it(this);
+	it.pushLeftmost(m_root);
+	return(it);
+}
+
+// end
+// preconditions:	this not equal to nullptr.
+// postconditions:	the iterator one past the largest key is returned.
+//
+template<typename Key, typename Compare>
+typename BasicBSTree<Key, Compare>::const_iterator BasicBSTree<Key, Compare>::end() const {
+	return(const_iterator(this));
+}
+
+// lowerBound
+// Seeks to the first key not ordered before data in O(depth).
+// preconditions:	data must be a valid Key object (must not reference
+//					a dereferenced nullptr); this not equal to nullptr.
+// postconditions:	an iterator to the smallest key >= data is returned, or
+//					end() if there is none.
+//
+template<typename Key, typename Compare>
+typename BasicBSTree<Key, Compare>::const_iterator BasicBSTree<Key, Compare>::lowerBound(const Key &data) const {
+	const_iterator it(this);
+	size_t found = 0;
+	const Node *temp = m_root;
+	while(temp != nullptr) {
+		it.m_path.push_back(temp);
+		if(isLess(temp->m_item, data)) {
+			temp = temp->m_right;
+		} else {
+			found = it.m_path.size();
+			temp = temp->m_left;
+		}
+	}
+	// the path above the last candidate is exactly the iterator's path
+	it.m_path.resize(found);
+	return(it);
+}
+
+// upperBound
+// Seeks to the first key ordered after data in O(depth).
+// preconditions:	data must be a valid Key object (must not reference
+//					a dereferenced nullptr); this not equal to nullptr.
+// postconditions:	an iterator to the smallest key > data is returned, or
+//					end() if there is none.
+//
+template<typename Key, typename Compare>
+typename BasicBSTree<Key, Compare>::const_iterator BasicBSTree<Key, Compare>::upperBound(const Key &data) const {
+	const_iterator it(this);
+	size_t found = 0;
+	const Node *temp = m_root;
+	while(temp != nullptr) {
+		it.m_path.push_back(temp);
+		if(isLess(data, temp->m_item)) {
+			found = it.m_path.size();
+			temp = temp->m_left;
+		} else {
+			temp = temp->m_right;
+		}
+	}
+	it.m_path.resize(found);
+	return(it);
+}
+
+// range
+// Returns a lazy view of the keys from low to high inclusive. Building the
+// view costs O(depth); visiting its k keys costs O(k) more, and stopping
+// early visits nothing further.
+// preconditions:	low must not be ordered after high; this not equal to
+//					nullptr.
+// postconditions:	a Range from lowerBound(low) to upperBound(high) is
+//					returned.
+//
+template<typename Key, typename Compare>
+typename BasicBSTree<Key, Compare>::Range BasicBSTree<Key, Compare>::range(const Key &low, const Key &high) const {
+	Range view;
+	view.m_begin = lowerBound(low);
+	view.m_end = upperBound(high);
+	return(view);
+}
+
+// print: output helper
+// Prints the contents of the tree to sout.
+// preconditions:	none
+// postconditions:	the contents of this are printed to sout. Each line
+//					contains a Node in the format: "m_item m_itemCount"
+//
+template<typename Key, typename Compare>
+void BasicBSTree<Key, Compare>::print(ostream &sout, Node *node) const {
+	vector<Node*> stack;
+	while(node != nullptr || !stack.empty()) {
+		while(node != nullptr) {
+			stack.push_back(node);
+			node = node->m_left;
+		}
+		node = stack.back();
+		stack.pop_back();
+		sout << node->m_item << " " << node->m_itemCount << '\n';
+		node = node->m_right;
+	}
+}
+
+// output
+// Prints the contents of the tree to the ostream
+// preconditions:	tree must be a valid BSTree object (must not reference
+//					a dereferenced nullptr); this not equal to nullptr.
+// postconditions:	the contents of this are printed to the ostream Each
+//					line contains a Node in the format: 
+//						"m_item m_itemCount"
+//
+template<typename Key, typename Compare>
+ostream& operator<<(ostream &sout, const BasicBSTree<Key, Compare> &tree) {
+	tree.print(sout, tree.m_root);
+	return(sout);
+}
+
+// swap
+// Exchanges the contents of two trees in constant time.
+// preconditions:	none
+// postconditions:	lhs holds what rhs held and rhs what lhs held
+//
+template<typename Key, typename Compare>
+void swap(BasicBSTree<Key, Compare> &lhs, BasicBSTree<Key, Compare> &rhs) noexcept {
+	lhs.swap(rhs);
+}
 #endif
\ No newline at end of file
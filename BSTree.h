@@ -1,351 +1,1694 @@
-// BSTree.h		Author: Sam Hoover
-// contains the declarations for the BSTree class
-//
-#ifndef BSTREE_H
-#define BSTREE_H
-#include <iostream>
-#include "TreeData.h"
-using namespace std;
-
-// MIN_ITEM_COUNT
-// the minimum number of a BSTree::Node object's m_itemCount
-//
-const int MIN_ITEM_COUNT = 1;
-
-// VALUE_NOT_FOUND
-// the value returned when a search for a dersired value was not met
-//
-const int VALUE_NOT_FOUND = -1;
-
-// BSTree
-// A binary search tree class used to store TreeData objects. TreeData objects
-// are stored in a Node containing, a pointer to the TreeData object (m_item), a
-// counter variable to track the number of occurrences of m_item (m_itemCount),
-// and pointers to left and right children (m_left, m_right).
-//
-// New nodes are inserted into the tree in the format:
-//			node < root = insert(root->left)
-//			node >= root = insert(root->right)
-// 
-// New nodes are only added to the tree if the data being inserted is unique
-// (not already in the tree). If the data is not unique, then the counter (
-// m_ItemCount) of the node matching data is incremented by one.
-//
-// Nodes are removed only if m_ItemCount is equal to one. If m-ItemCount is 
-// greater than one, m_ItemCount is decremented by one.
-//
-// BSTree requires the following operators to be overloaded in the TreeData 
-// class for proper functionality: operator==, operator!=, operator<, 
-// operator>, operator<=, operator>=, and operator<<.
-//
-class BSTree {
-	
-	// output
-	// Prints the contents of the tree to the ostream
-	// preconditions:	tree must be a valid BSTree object (must not reference
-	//					a dereferenced nullptr); this not equal to nullptr.
-	// postconditions:	the contents of this are printed to the ostream Each
-	//					line contains a Node in the format: 
-	//						"m_item m_itemCount"
-	//
-	friend ostream& operator<<(ostream &sout, const BSTree &tree);
-
-public:
-	// CONSTRUCTORS
-
-	// default constructor
-	// preconditions:	none
-	// postconsitions:	Creates a tree of size zero (m_root equal to nullptr)
-	//
-	BSTree();
-
-	// constructor(TreeData *data)
-	// preconditions:	none
-	// postconditions:	If data is not a nullptr, then m_root is set to a new
-	//					node with m_item equal to data and m_itemCount equal
-	//					to one. If data equals nullptr, m_root is set to
-	//					nullptr.
-	//
-	BSTree(TreeData *data);
-
-	// copy constructor (deep copy)
-	// preconditions:	tree must be a valid BSTree object (must not reference
-	//					a dereferenced nullptr)
-	// postconditions:	this becomes an identical node-by-node copy of tree,
-	//					creating new Nodes and new TreeDatas.
-	//
-	BSTree(const BSTree &tree);
-
-	// destructor
-	// preconditions:	none
-	// postconditions:	All nodes removed and deleted, m_root set to nullptr
-	//
-	~BSTree();
-
-	// MUTATORS
-
-	// insert
-	// Inserts a pointer to a TreeData object into the tree. If a node  
-	// containing the object already exists in the tree, the object's 
-	// m_itemCount in incremented by one. For the tree and all subtrees nodes
-	// are inserted with the formula: 
-	//			node < root = insert left
-	//			node >= root = insert right
-	// preconditions:	this not equal to nullptr.
-	// postconditions:	If data does not already exist in the tree, then a new
-	//					node with m_item equal to data is inserted into the
-	//					tree. If the data already exists, then m_itemCount is
-	//					incremented by one.
-	//
-	bool insert(TreeData *data);
-
-	// remove
-	// Removes a TreeData object equal to data from the tree. If there is only
-	// one TreeData object, the node containing that object is removed and
-	// deleted.
-	// preconditions:	data must be a valid TreeData object (must not reference
-	//					a dereferenced nullptr); this not equal to nullptr.
-	// postconditions:	If data is not found, then false is returned. If data
-	//					is found and m_itemCount > 1 then m_itemCount is 
-	//					decremented by one; if m_itemCount == 1 then the node
-	//					is removed from the tree and deleted.
-	//
-	bool remove(const TreeData &data);
-
-	// makeEmpty
-	// Removes and deletes all nodes from the tree, and set m_root equal to
-	// nullptr.
-	// preconditions:	this not equal to nullptr.
-	// postconditions:	All nodes removed and deleted, m_root set to nullptr
-	//
-	void makeEmpty();
-	
-	// ACCESSORS
-
-	// retrieve
-	// Searches the tree for data, if found, a const pointer to that object is
-	// returned, otherwise false is returned.
-	// preconditions:	data must be a valid TreeData object (must not reference
-	//					a dereferenced nullptr); this not equal to nullptr.
-	// postconditions:	If data is found in the tree, a const pointer to the
-	//					is returned. If data is not found them nullptr is
-	//					returned.
-	//
-	const TreeData* retrieve(const TreeData &data) const;
-
-	// depth
-	// Finds the depth of a node with m_item equal to data. Depth of m_root is 
-	// equal to zero.
-	// preconditions:	data must be a valid TreeData object (must not reference
-	//					a dereferenced nullptr); this not equal to nullptr.
-	// postconditions:	If data is found in the tree, the depth of the node
-	//					containing data is returned. If data is not found then
-	//					-1 is returned.
-	//
-	int depth(const TreeData &data) const;
-
-	// descendants
-	// Finds the number of descendants of the node containing data.
-	// preconditions:	data must be a valid TreeData object (must not reference
-	//					a dereferenced nullptr); this not equal to nullptr.
-	// postconditions:	If data is found, the number of descendants are of the
-	//					node containing data are counted and returned. If data
-	//					is not found, -1 is returned.
-	//
-	int descendants(const TreeData &data) const;
-
-	// isEmpty
-	// Returns true is tree is empty, else false
-	// preconditions:	this not equal to nullptr.
-	// postconditions:	If m_root equals nullptr true is returned, else false
-	//
-	bool isEmpty() const;
-
-	// OPERATORS
-
-	// assignment
-	// Sets this equal to tree. Performs a deep copy.
-	// preconditions:	tree must be a valid BSTree object (must not reference
-	//					a dereferenced nullptr); this not equal to nullptr.
-	// postconditions:	this becomes an identical node-by-node copy of tree,
-	//					creating new Nodes and new TreeDatas.
-	//
-	const BSTree& operator=(const BSTree &tree);
-
-	// equality
-	// Node-by-node comparison of this and tree. Returns true only if the 
-	// trees have the same data (including m_itemCount) and structure
-	// preconditions:	tree must be a valid BSTree object (must not reference
-	//					a dereferenced nullptr); this not equal to nullptr.
-	// postconditions:	If this and tree have same data and structure then true
-	//					is returned, else false is returned.
-	//
-	bool operator==(const BSTree &tree) const;
-
-	// inequality
-	// Node-by-node comparison of this and tree. Returns true only if the 
-	// trees do not have the same data (including m_itemCount) and structure
-	// preconditions:	tree must be a valid BSTree object (must not reference
-	//					a dereferenced nullptr); this not equal to nullptr.
-	// postconditions:	If this and tree do not have same data and structure
-	//					then true is returned, else false is returned.
-	//
-	bool operator!=(const BSTree &tree) const;
-
-private:
-	// DATA
-
-	// struct Node
-	// a node containing a pointer to a TreeData object, an item count, and
-	// pointers to left and right children
-	// 
-	struct Node {
-		// default constructor
-		// preconditions:	none
-		// postconditions:	creates a node with m_item, m_left, and m_right 
-		//					equal to nullptr, and m_itemCount equal to 0.
-		//
-		Node();
-
-		// constructor(TreeData *data)
-		// preconditions:	none
-		// postconditions:	Creates a node with m_left and m_right are set
-		//					equal to nullptr. If data is not nullptr, a node 
-		//					with m_item equal to data & m_itemCount equal to 1.
-		//					If data is nullptr then m_item, m_left, and m_right 
-		//					are set equal to nullptr, and m_itemCount to 0.
-		//
-		Node(TreeData *data);
-
-		// copy constructor (deep copy)
-		// preconditions:	node must be a valid BSTree::Node object (must not 
-		//					reference a dereferenced nullptr)
-		// postconditions:	this becomes an identical copy of node, creating
-		//					new data
-		//
-		Node(const Node &node);
-
-		// m_item
-		// a pointer to a TreeData object
-		//
-		TreeData *m_item;
-
-		// m_itemCount
-		// a counter for the number of occurences of m_item
-		//
-		int m_itemCount;
-
-		// m_left
-		// a pointer to left child
-		//
-		Node *m_left;
-
-		// m_right
-		// a pointer to wrathchild
-		//
-		Node *m_right;
-	};
-
-	// m_root
-	// a pointer to the root of the this
-	//
-	Node *m_root;
-
-	// HELPER FUNCTIONS
-
-	// copyNode: copy constructor helper (deep copy)
-	// preconditions:	this not equal to nullptr.
-	// postconditions:	to becomes an identical copy of from, copying all
-	//					decendants. 
-	//
-	void copyNode(Node *&to, Node *from);
-
-	// insert helper
-	// Inserts a pointer to a TreeData object into the tree. If a node  
-	// containing the object already exists in the tree, the object's 
-	// m_itemCount in incremented by one.
-	// preconditions:	node->m_item must be a valid TreeData object not equal
-	//					to nullptr; this not equal to nullptr.
-	// postconditions:	If data does not already exist in the tree, then a new
-	//					node with m_item equal to data is inserted into the
-	//					tree. If the data already exists, then m_itemCount is
-	//					incremented by one.
-	//
-	bool insert(TreeData *data, Node *&node);
-	
-	// remove helper
-	// Removes a TreeData object equal to data from the tree. If there is only
-	// one TreeData object, the node containing that object is removed and
-	// deleted.
-	// preconditions:	node->m_item must be a valid TreeData object not equal
-	//					to nullptr; this not equal to nullptr.
-	// postconditions:	If data is not found, then false is returned. If data
-	//					is found and m_itemCount > 1 then m_itemCount is 
-	//					decremented by one; if m_itemCount == 1 then the node
-	//					is removed from the tree and deleted.
-	//
-	bool remove(const TreeData &data, Node *&node);
-	
-	// deleteNode: remove helper
-	// Deletes a Node with m_item equal to data from the tree.
-	// preconditions:	node must be a valid BSTree::Node object not equal to
-	//					nullptr; this not equal to nullptr.
-	// postconditions:	node is deleted and set to nullptr.
-	//
-	void deleteNode(Node *&node);
-	
-	// deleteSmallest: remove helper
-	// Finds and deletes the Node with the smallest m_item from the tree.
-	// preconditions:	node must be a valid BSTree::Node object not equal to
-	//					nullptr; this not equal to nullptr.
-	// postconditions:	node is deleted and set to nullptr.
-	//
-	TreeData* deleteSmallest(Node *&node);
-	
-	// makeEmpty helper
-	// Removes and deletes all nodes from the tree, and sets m_root equal to
-	// nullptr.
-	// preconditions:	this not equal to nullptr
-	// postconditions:	All nodes removed and deleted, m_root set to nullptr
-	//
-	void makeEmpty(Node *node);
-
-	// compareNode: equality helper
-	// Node-by-node comparison of this and tree. Returns true only if the 
-	// trees have the same data (including m_itemCount) and structure
-	// preconditions:	this not equal to nullptr
-	// postconditions:	If self and other have same data and structure then true
-	//					is returned, else false is returned.
-	//
-	bool compareNode(Node *self, Node *other) const;
-	
-	// findNode: descendants helper
-	// finds a Node with m_item equal to data and retunrs a constant pointer to
-	// the Node. If no match is found, nullptr is returned.
-	// preconditions:	data must be a valid TreeData object (must not reference
-	//					a dereferenced nullptr); this not equal to nullptr.
-	// postconditions:	if data is found, then a constant pointer to the Node 
-	//					containing data is returned, else false is returned.
-	//
-	const Node* findNode(const TreeData &data) const;
-	
-	// descendants helper
-	// Finds the number of descendants of the node containing data.
-	// preconditions:	data must be a valid TreeData object (must not reference
-	//					a dereferenced nullptr); this not equal to nullptr.
-	// postconditions:	If data is found, the number of descendants are of the
-	//					node containing data are counted and returned. If data
-	//					is not found, -1 is returned.
-	//
-	int descendants(int &count, const Node *node) const;
-	
-	// print: output helper
-	// Prints the contents of the tree to sout.
-	// preconditions:	none
-	// postconditions:	the contents of this are printed to sout. Each line
-	//					contains a Node in the format: "m_item m_itemCount"
-	//
-	void print(ostream &sout, Node *node) const;
-};
-
+// BSTree.h		Author: Sam Hoover
+// contains the declarations for the BasicBSTree class template and the BSTree
+// type used to store Key objects
+//
+#ifndef BSTREE_H
+#define BSTREE_H
+#include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <future>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "TreeData.h"
+#include "KeyTraits.h"
+#include "MappedFile.h"
+#include "MemoryPool.h"
+#include "OutputBuffer.h"
+#include "SnapshotHeader.h"
+using namespace std;
+
+// BSTREE_STATS
+// Define BSTREE_STATS (for example with -DBSTREE_STATS) to make every
+// BasicBSTree count the comparisons and node visits of its insert, remove,
+// retrieve and depth calls and the nodes it allocates and frees, as
+// reported by stats(). Without it the counting code is compiled out and
+// costs nothing. It must be defined the same way in every translation unit
+// of a program.
+//
+
+// MIN_ITEM_COUNT
+// the minimum number of a BSTree::Node object's m_itemCount
+//
+const int MIN_ITEM_COUNT = 1;
+
+// VALUE_NOT_FOUND
+// the value returned when a search for a dersired value was not met
+//
+const int VALUE_NOT_FOUND = -1;
+
+// BalancePolicy
+// the rebalancing strategy a BSTree applies after each insert and remove.
+//		UNBALANCED:	nodes are never moved once inserted (original behavior)
+//		AVL:		subtrees are rotated so that the heights of any node's
+//					children never differ by more than one, keeping the
+//					depth of the tree logarithmic for any insertion order
+//
+enum BalancePolicy { UNBALANCED, AVL };
+
+// CountPolicy
+// how unionWith, intersectWith and differenceWith combine the counts of a
+// key held by both trees. A key whose combined count falls below
+// MIN_ITEM_COUNT is removed.
+//		COUNT_SUM:		this tree's count plus the other tree's
+//		COUNT_MIN:		the smaller of the two counts
+//		COUNT_MAX:		the larger of the two counts
+//		COUNT_SUBTRACT:	this tree's count minus the other tree's
+//
+enum CountPolicy { COUNT_SUM, COUNT_MIN, COUNT_MAX, COUNT_SUBTRACT };
+
+// DeltaKind
+// the change one entry of a delta from BSTree::diff makes
+//		DELTA_INSERT:	the key is added with the entry's count
+//		DELTA_REMOVE:	the key is removed, whatever its count
+//		DELTA_COUNT:	the key's count is set to the entry's count
+//
+enum DeltaKind { DELTA_INSERT, DELTA_REMOVE, DELTA_COUNT };
+
+// SET_PARALLEL_GRAIN
+// the smallest subtree of the other tree, in nodes, that a set operation
+// hands to another thread
+//
+const int SET_PARALLEL_GRAIN = 4096;
+
+// BATCH_PARALLEL_GRAIN
+// the smallest number of batch keys insertBatch hands to another thread
+//
+const int BATCH_PARALLEL_GRAIN = 8192;
+
+// COPY_PARALLEL_GRAIN
+// the smallest subtree, in nodes, that a deep copy hands to another thread
+//
+const int COPY_PARALLEL_GRAIN = 16384;
+
+// LOOKUP_BATCH_GROUP
+// the number of searches retrieveBatch, depthBatch and containsBatch advance
+// side by side
+//
+const int LOOKUP_BATCH_GROUP = 16;
+
+// EMPTY_HASH
+// the hash of an empty subtree, and so of an empty tree
+//
+const uint64_t EMPTY_HASH = 0x6a09e667f3bcc909ULL;
+
+// InsertBatchResult
+// the outcome of a BSTree::insertBatch call
+//		m_created:		the number of keys that were not in the tree and now
+//						have a node of their own (insert would have returned
+//						true)
+//		m_incremented:	the number of keys that only incremented a count
+//						(insert would have returned false)
+//
+struct InsertBatchResult {
+	int m_created;
+	int m_incremented;
+};
+
+// OperationStats
+// the counters BasicBSTree::stats reports for one kind of operation
+//		m_calls:		the number of calls made
+//		m_comparisons:	the number of key comparisons the calls made
+//		m_nodesVisited:	the number of nodes the calls read on their way
+//						down the tree
+//
+struct OperationStats {
+	long long m_calls;
+	long long m_comparisons;
+	long long m_nodesVisited;
+};
+
+// TreeStats
+// a snapshot returned by BasicBSTree::stats
+//		m_countersEnabled:	true if BSTREE_STATS was defined; if not, every
+//							counter (the fields down to m_frees) is 0
+//		m_insert, m_remove, m_retrieve, m_depth:
+//							the counters of insert (and emplace), remove,
+//							retrieve and depth since the tree was created
+//		m_allocations:		the number of nodes allocated
+//		m_frees:			the number of nodes freed
+//		m_maxDepth:			the depth of the deepest node, or -1 if the
+//							tree is empty
+//		m_averageDepth:		the mean depth of the nodes, or 0 if the tree
+//							is empty
+//		m_depthHistogram:	the number of nodes at each depth, indexed by
+//							depth
+//
+struct TreeStats {
+	bool m_countersEnabled;
+	OperationStats m_insert;
+	OperationStats m_remove;
+	OperationStats m_retrieve;
+	OperationStats m_depth;
+	long long m_allocations;
+	long long m_frees;
+	int m_maxDepth;
+	double m_averageDepth;
+	vector<long long> m_depthHistogram;
+};
+
+// BasicFrozenIndex
+// the read-only index made by BasicBSTree::freeze, declared in FrozenIndex.h
+//
+template<typename Key, typename Compare>
+class BasicFrozenIndex;
+
+// BasicBSTree
+// A binary search tree class template used to store Key objects ordered by
+// Compare. Key objects are stored in a Node containing, the Key object itself
+// (m_item), a counter variable to track the number of occurrences of m_item
+// (m_itemCount), and pointers to left and right children (m_left, m_right).
+// Keeping m_item inline means a search reads the key from the same cache line
+// as the child pointers.
+//
+// Every node also records the number of nodes (m_size) and the total of
+// m_itemCount (m_weight) in its subtree. These are kept current by every
+// insert, remove and rotation, and they let descendants, rank, weightedRank
+// and select run in O(depth) without walking subtrees.
+//
+// New nodes are inserted into the tree in the format:
+//			node < root = insert(root->left)
+//			node >= root = insert(root->right)
+// 
+// New nodes are only added to the tree if the data being inserted is unique
+// (not already in the tree). If the data is not unique, then the counter (
+// m_ItemCount) of the node matching data is incremented by one.
+//
+// Nodes are removed only if m_ItemCount is equal to one. If m-ItemCount is 
+// greater than one, m_ItemCount is decremented by one.
+//
+// Nodes are allocated from a per-tree MemoryPool (m_pool) so the nodes of a
+// tree sit in contiguous chunks, removed nodes are recycled, and makeEmpty
+// releases all nodes at once. A node moved in from another tree with a
+// NodeHandle stays in the pool it was carved from, and is always freed back
+// into that pool (see poolOf), however many trees it has passed through.
+//
+// A BSTree constructed with the AVL BalancePolicy rotates nodes after every
+// insert and remove so the tree stays height-balanced. Sorted input then
+// produces a tree of logarithmic depth rather than a linked list.
+//
+// No operation recurses once per level of the tree. Walks that need to come
+// back up keep an explicit stack on the heap, so even a degenerate
+// UNBALANCED tree of millions of nodes cannot overflow the call stack.
+//
+// Key must be copy constructible, assignable, and printable with operator<<.
+// Compare must be a strict weak ordering on Key; two keys are considered equal
+// when neither is ordered before the other. The default, less<Key>, requires
+// operator< to be overloaded for Key.
+//
+template<typename Key, typename Compare = less<Key> >
+class BasicBSTree {
+	
+	// output
+	// Prints the contents of the tree to the ostream
+	// preconditions:	tree must be a valid BSTree object (must not reference
+	//					a dereferenced nullptr); this not equal to nullptr.
+	// postconditions:	the contents of this are printed to the ostream Each
+	//					line contains a Node in the format: 
+	//						"m_item m_itemCount"
+	//
+	template<typename K, typename C>
+	friend ostream& operator<<(ostream &sout, const BasicBSTree<K, C> &tree);
+
+	// struct Node
+	// declared here so the iterators can refer to it; defined under DATA
+	//
+	struct Node;
+
+public:
+	// NodeHandle
+	// Owns one node taken out of a tree by extract, together with its Key and
+	// m_itemCount. Passing the handle to insert on any tree with the same Key
+	// and Compare links the same node in again, so no allocation, free or Key
+	// copy takes place. The handle shares ownership of the pool its node came
+	// from, which keeps the node's memory valid after that tree is gone. A
+	// handle that is destroyed while it still holds a node deletes the node.
+	//
+	class NodeHandle {
+		friend class BasicBSTree;
+
+	public:
+		// default constructor
+		// preconditions:	none
+		// postconditions:	creates an empty handle
+		//
+		NodeHandle();
+
+		// move constructor
+		// preconditions:	none
+		// postconditions:	this takes over handle's node; handle is empty
+		//
+		NodeHandle(NodeHandle &&handle);
+
+		// move assignment
+		// preconditions:	none
+		// postconditions:	any node held by this is deleted, then this takes
+		//					over handle's node; handle is empty
+		//
+		NodeHandle& operator=(NodeHandle &&handle);
+
+		// destructor
+		// preconditions:	none
+		// postconditions:	any node still held is deleted
+		//
+		~NodeHandle();
+
+		// isEmpty
+		// preconditions:	none
+		// postconditions:	true is returned if no node is held
+		//
+		bool isEmpty() const;
+
+		// getKey
+		// preconditions:	this must not be empty.
+		// postconditions:	the key of the held node is returned
+		//
+		const Key& getKey() const;
+
+		// getCount
+		// preconditions:	this must not be empty.
+		// postconditions:	the m_itemCount of the held node is returned
+		//
+		int getCount() const;
+
+	private:
+		// constructor(Node *node, const shared_ptr<MemoryPool> &pool)
+		// preconditions:	node was carved from pool and is not in any tree.
+		// postconditions:	creates a handle owning node
+		//
+		NodeHandle(Node *node, const shared_ptr<MemoryPool> &pool);
+
+		// copying a handle is not supported
+		NodeHandle(const NodeHandle &handle);
+		NodeHandle& operator=(const NodeHandle &handle);
+
+		// m_node
+		// the node held, or nullptr
+		//
+		Node *m_node;
+
+		// m_pool
+		// the pool m_node was carved from
+		//
+		shared_ptr<MemoryPool> m_pool;
+	};
+
+	// DeltaEntry
+	// one change in a delta made by diff and applied by applyDelta
+	//		m_kind:		the change made
+	//		m_key:		the key changed
+	//		m_count:	the key's m_itemCount after the change, or 0 for
+	//					DELTA_REMOVE
+	//
+	struct DeltaEntry {
+		DeltaKind m_kind;
+		Key m_key;
+		int m_count;
+	};
+
+	// CONSTRUCTORS
+
+	// default constructor
+	// preconditions:	none
+	// postconsitions:	Creates a tree of size zero (m_root equal to nullptr)
+	//
+	BasicBSTree();
+
+	// constructor(BalancePolicy policy)
+	// preconditions:	none
+	// postconditions:	Creates a tree of size zero (m_root equal to nullptr)
+	//					that rebalances itself according to policy.
+	//
+	BasicBSTree(BalancePolicy policy);
+
+	// constructor(Key *data, BalancePolicy policy)
+	// preconditions:	none
+	// postconditions:	If data is not a nullptr, then m_root is set to a new
+	//					node holding a copy of *data with m_itemCount equal
+	//					to one; data is left to the caller. If data equals
+	//					nullptr, m_root is set to nullptr. The tree
+	//					rebalances according to policy.
+	//
+	BasicBSTree(Key *data, BalancePolicy policy = UNBALANCED);
+
+	// constructor(InputIt begin, InputIt end, BalancePolicy policy)
+	// Bulk-builds a height-balanced tree from sorted input in linear time.
+	// preconditions:	[begin, end) must be sorted in ascending order by
+	//					Compare; equal keys must be adjacent.
+	// postconditions:	this holds every key in [begin, end), with runs of
+	//					equal keys folded into one node's m_itemCount. The
+	//					tree rebalances according to policy afterwards.
+	//
+	template<typename InputIt>
+	BasicBSTree(InputIt begin, InputIt end, BalancePolicy policy = UNBALANCED);
+
+	// copy constructor (deep copy)
+	// preconditions:	tree must be a valid BSTree object (must not reference
+	//					a dereferenced nullptr)
+	// postconditions:	this becomes an identical node-by-node copy of tree,
+	//					creating new Nodes and new Keys, and uses the
+	//					same BalancePolicy as tree.
+	//
+	BasicBSTree(const BasicBSTree &tree);
+
+	// move constructor
+	// Takes over the nodes and pool of tree without copying or allocating
+	// anything, so containers of trees move them instead of copying them.
+	// preconditions:	tree must be a valid BSTree object (must not reference
+	//					a dereferenced nullptr)
+	// postconditions:	this holds what tree held, with its BalancePolicy;
+	//					tree is left empty, with no pool until it next needs
+	//					one.
+	//
+	BasicBSTree(BasicBSTree &&tree) noexcept;
+
+	// destructor
+	// preconditions:	none
+	// postconditions:	All nodes removed and deleted, m_root set to nullptr
+	//
+	~BasicBSTree();
+
+	// MUTATORS
+
+	// insert(const Key &data)
+	// Inserts a copy of data into the tree. If a node containing an equal object
+	// already exists in the tree, its m_itemCount is incremented by one. For the
+	// tree and all subtrees nodes are inserted with the formula:
+	//			node < root = insert left
+	//			node >= root = insert right
+	// preconditions:	data must be a valid Key object (must not reference
+	//					a dereferenced nullptr); this not equal to nullptr.
+	// postconditions:	If data does not already exist in the tree, then a new
+	//					node with m_item equal to data is inserted and true is
+	//					returned. If the data already exists, then m_itemCount
+	//					is incremented by one and false is returned.
+	//
+	bool insert(const Key &data);
+
+	// insert(Key *data)
+	// Deprecated: use insert(const Key&) or emplace. Kept for callers of the
+	// original pointer interface, with one change in ownership. The original
+	// tree kept data itself and deleted it on remove; this tree stores a copy
+	// of *data and never takes data. The caller still owns data and must delete
+	// it, whatever is returned, and a pointer from retrieve refers to the
+	// tree's copy rather than to data.
+	// preconditions:	data must be a valid Key object not equal to
+	//					nullptr; this not equal to nullptr.
+	// postconditions:	the same as insert(*data); data is left to the caller.
+	//
+	bool insert(Key *data);
+
+	// emplace
+	// Constructs a Key from args directly inside a new node and inserts
+	// it into the tree, following the same rules as insert. No separate
+	// Key is allocated by the caller.
+	// preconditions:	args must be valid arguments to a Key constructor;
+	//					this not equal to nullptr.
+	// postconditions:	If the constructed item does not already exist in the
+	//					tree, a node holding it is inserted and true is 
+	//					returned. Otherwise the matching node's m_itemCount is
+	//					incremented by one and false is returned.
+	//
+	template<typename... Args>
+	bool emplace(Args&&... args);
+
+	// remove
+	// Removes a Key object equal to data from the tree. If there is only
+	// one Key object, the node containing that object is removed and
+	// deleted.
+	// preconditions:	data must be a valid Key object (must not reference
+	//					a dereferenced nullptr); this not equal to nullptr.
+	// postconditions:	If data is not found, then false is returned. If data
+	//					is found and m_itemCount > 1 then m_itemCount is 
+	//					decremented by one; if m_itemCount == 1 then the node
+	//					is removed from the tree and deleted.
+	//
+	bool remove(const Key &data);
+
+	// makeEmpty
+	// Removes and deletes all nodes from the tree, and set m_root equal to
+	// nullptr. Nodes hold their items inline, so unless another tree or handle
+	// shares the pool, the whole tree is released with its pool in O(chunks).
+	// preconditions:	this not equal to nullptr.
+	// postconditions:	All nodes removed and deleted, m_root set to nullptr
+	//
+	void makeEmpty();
+
+	// assignSorted
+	// Replaces the contents of the tree with the keys in [begin, end), built
+	// directly into a height-balanced shape in one linear pass. All of the
+	// nodes are allocated in a single block.
+	// preconditions:	[begin, end) must be sorted in ascending order by
+	//					Compare; equal keys must be adjacent.
+	// postconditions:	this holds every key in [begin, end), with runs of
+	//					equal keys folded into one node's m_itemCount. The
+	//					depth of the tree is floor(log2(n)).
+	//
+	template<typename InputIt>
+	void assignSorted(InputIt begin, InputIt end);
+
+	// rebuild
+	// Relinks the existing nodes of the tree into a height-balanced shape in
+	// linear time. No nodes are allocated, freed, or copied.
+	// preconditions:	this not equal to nullptr.
+	// postconditions:	the tree holds the same keys and counts, and its depth
+	//					is floor(log2(n)).
+	//
+	void rebuild();
+
+	// extract
+	// Unlinks the node holding data from the tree and hands it over, with its
+	// m_itemCount, without freeing or copying it.
+	// preconditions:	data must be a valid Key object (must not reference
+	//					a dereferenced nullptr); this not equal to nullptr.
+	// postconditions:	If data is found, its node is removed from the tree
+	//					and returned in a handle; otherwise an empty handle is
+	//					returned.
+	//
+	NodeHandle extract(const Key &data);
+
+	// insert(NodeHandle &&handle)
+	// Links the node held by handle into the tree. No allocation, free or
+	// Key copy takes place unless the key is already present.
+	// preconditions:	handle came from extract on a tree with the same Key
+	//					and Compare; this not equal to nullptr.
+	// postconditions:	If handle is empty, false is returned. If its key is
+	//					not in the tree, the node is linked in with its
+	//					m_itemCount and true is returned. Otherwise the
+	//					existing m_itemCount is raised by the handle's count,
+	//					the handle's node is freed and false is returned.
+	//					handle is left empty.
+	//
+	bool insert(NodeHandle &&handle);
+
+	// swap
+	// Exchanges the contents, BalancePolicy and pool of this and tree in
+	// constant time.
+	// preconditions:	tree must be a valid BSTree object (must not reference
+	//					a dereferenced nullptr)
+	// postconditions:	this holds what tree held and tree what this held.
+	//
+	void swap(BasicBSTree &tree) noexcept;
+
+	// insertBatch
+	// Inserts every key in [begin, end), with the same result as calling
+	// insert on each one. The batch is sorted and equal keys are folded into
+	// counts, then merged into the tree in one descent that splits the batch
+	// at each node it passes. A run of keys that reaches an empty link is
+	// built there as a balanced subtree, so sorted batches do not degrade
+	// the tree. Large disjoint subtrees are merged on separate threads.
+	// preconditions:	InputIt dereferences to Key; this not equal to nullptr.
+	// postconditions:	every key is in the tree with its count raised by its
+	//					number of occurrences in the batch. The number of new
+	//					nodes and of count increments is returned.
+	//
+	template<typename InputIt>
+	InsertBatchResult insertBatch(InputIt begin, InputIt end);
+
+	// unionWith
+	// Adds every key of tree to this tree. Built from split and join, so the
+	// work is O(m log(n/m + 1)) for m keys in the smaller tree and n in the
+	// larger; merging a small tree into a large one costs time in proportion
+	// to the small one. Independent halves run on separate threads.
+	// preconditions:	tree must be a valid BasicBSTree object (must not
+	//					reference a dereferenced nullptr); this not equal to
+	//					nullptr.
+	// postconditions:	this holds every key of both trees. A key held by
+	//					both gets the counts combined by policy; a key held by
+	//					one keeps its count. tree is unchanged.
+	//
+	void unionWith(const BasicBSTree &tree, CountPolicy policy = COUNT_SUM);
+
+	// intersectWith
+	// Keeps only the keys of this tree that tree also holds, with the same
+	// split/join structure and cost as unionWith.
+	// preconditions:	tree must be a valid BasicBSTree object (must not
+	//					reference a dereferenced nullptr); this not equal to
+	//					nullptr.
+	// postconditions:	this holds the keys found in both trees, with the
+	//					counts combined by policy. tree is unchanged.
+	//
+	void intersectWith(const BasicBSTree &tree, CountPolicy policy = COUNT_MIN);
+
+	// differenceWith
+	// Takes the keys of tree away from this tree, with the same split/join
+	// structure and cost as unionWith.
+	// preconditions:	tree must be a valid BasicBSTree object (must not
+	//					reference a dereferenced nullptr); this not equal to
+	//					nullptr.
+	// postconditions:	a key held by both trees gets the counts combined by
+	//					policy, and is removed if that leaves less than
+	//					MIN_ITEM_COUNT. Other keys of this tree are unchanged.
+	//					tree is unchanged.
+	//
+	void differenceWith(const BasicBSTree &tree, CountPolicy policy = COUNT_SUBTRACT);
+
+	// applyDelta
+	// Makes the changes of a delta from diff, in O(k log n) for k entries.
+	// Every entry is checked against the tree before any is made, so a delta
+	// taken against some other tree leaves this one alone. The tree ends up
+	// with the keys and counts of the tree the delta was taken towards, but
+	// its shape may differ, so operator== between the two can still be false.
+	// preconditions:	this not equal to nullptr.
+	// postconditions:	If the keys of delta are in ascending order, each
+	//					DELTA_INSERT key is absent from the tree, every other
+	//					key is present, and no inserted or changed count is
+	//					below MIN_ITEM_COUNT, the changes are made and true is
+	//					returned. Otherwise false is returned and the tree is
+	//					unchanged.
+	//
+	bool applyDelta(const vector<DeltaEntry> &delta);
+
+	// loadSnapshot
+	// Replaces the contents of the tree with a snapshot written by
+	// saveSnapshot. The file is memory mapped and checked against its header
+	// and checksum, and its key tag must be KeyTraits<Key>::KEY_TAG. One
+	// linear pass checks the shape and that the keys are in order under
+	// m_compare, then every node is built in another into a single block,
+	// with the saved shape and policy.
+	// preconditions:	KeyTraits<Key> must encode keys; this not equal to
+	//					nullptr.
+	// postconditions:	If the file is a valid snapshot for this Key type whose
+	//					keys are in order under this tree's Compare, the tree
+	//					becomes identical to the saved tree and true is
+	//					returned. Otherwise false is returned and the tree is
+	//					unchanged.
+	//
+	bool loadSnapshot(const string &path);
+	
+	// ACCESSORS
+
+	// retrieve
+	// Searches the tree for data, if found, a const pointer to that object is
+	// returned, otherwise false is returned.
+	// preconditions:	data must be a valid Key object (must not reference
+	//					a dereferenced nullptr); this not equal to nullptr.
+	// postconditions:	If data is found in the tree, a const pointer to the
+	//					is returned. If data is not found them nullptr is
+	//					returned.
+	//
+	const Key* retrieve(const Key &data) const;
+
+	// retrieveBatch
+	// Searches the tree for every key in keys. The searches are run in
+	// groups of LOOKUP_BATCH_GROUP that step down the tree one level at a
+	// time in turn, and each prefetches the next node it will read, so the
+	// cache misses of a whole group overlap instead of following one another.
+	// preconditions:	this not equal to nullptr.
+	// postconditions:	out holds one entry per key, in the same order: a
+	//					const pointer to the matching key in the tree, or
+	//					nullptr if the key is not found.
+	//
+	void retrieveBatch(const vector<Key> &keys, vector<const Key*> &out) const;
+
+	// depthBatch
+	// Finds the depth of every key in keys, overlapping the searches as
+	// retrieveBatch does.
+	// preconditions:	this not equal to nullptr.
+	// postconditions:	out holds one entry per key, in the same order: the
+	//					depth of its node, or -1 if the key is not found.
+	//
+	void depthBatch(const vector<Key> &keys, vector<int> &out) const;
+
+	// containsBatch
+	// Tests every key in keys for membership, overlapping the searches as
+	// retrieveBatch does.
+	// preconditions:	this not equal to nullptr.
+	// postconditions:	out holds one entry per key, in the same order: true
+	//					if the key is in the tree, else false.
+	//
+	void containsBatch(const vector<Key> &keys, vector<bool> &out) const;
+
+	// depth
+	// Finds the depth of a node with m_item equal to data. Depth of m_root is 
+	// equal to zero.
+	// preconditions:	data must be a valid Key object (must not reference
+	//					a dereferenced nullptr); this not equal to nullptr.
+	// postconditions:	If data is found in the tree, the depth of the node
+	//					containing data is returned. If data is not found then
+	//					-1 is returned.
+	//
+	int depth(const Key &data) const;
+
+	// descendants
+	// Finds the number of descendants of the node containing data. The count is
+	// read from the node's m_size, so the cost is that of finding the node.
+	// preconditions:	data must be a valid Key object (must not reference
+	//					a dereferenced nullptr); this not equal to nullptr.
+	// postconditions:	If data is found, the number of descendants are of the
+	//					node containing data are counted and returned. If data
+	//					is not found, -1 is returned.
+	//
+	int descendants(const Key &data) const;
+
+	// size
+	// Returns the number of distinct keys (nodes) in the tree.
+	// preconditions:	this not equal to nullptr.
+	// postconditions:	m_root's m_size is returned, or 0 for an empty tree.
+	//
+	int size() const;
+
+	// rank
+	// Counts the distinct keys ordered before data. Runs in O(depth) using the
+	// m_size kept in every node.
+	// preconditions:	data must be a valid Key object (must not reference
+	//					a dereferenced nullptr); this not equal to nullptr.
+	// postconditions:	the number of nodes whose m_item is less than data is
+	//					returned, whether or not data is in the tree.
+	//
+	int rank(const Key &data) const;
+
+	// weightedRank
+	// Counts the items ordered before data, including duplicates. Runs in
+	// O(depth) using the m_weight kept in every node.
+	// preconditions:	data must be a valid Key object (must not reference
+	//					a dereferenced nullptr); this not equal to nullptr.
+	// postconditions:	the sum of m_itemCount over nodes whose m_item is less
+	//					than data is returned.
+	//
+	int weightedRank(const Key &data) const;
+
+	// select
+	// Finds the key with the given rank (0 is the smallest). Runs in O(depth).
+	// preconditions:	this not equal to nullptr.
+	// postconditions:	If 0 <= index < size(), a const pointer to the key of
+	//					that rank is returned, else nullptr is returned.
+	//
+	const Key* select(int index) const;
+
+	// isEmpty
+	// Returns true is tree is empty, else false
+	// preconditions:	this not equal to nullptr.
+	// postconditions:	If m_root equals nullptr true is returned, else false
+	//
+	bool isEmpty() const;
+
+	// write(ostream &sout)
+	// Prints the contents of the tree to sout in the same format as
+	// operator<<, but formats into a large buffer and hands it to sout in big
+	// chunks. Keys are formatted with KeyTraits and counts without iostream
+	// formatting.
+	// preconditions:	this not equal to nullptr.
+	// postconditions:	the contents of this are written to sout. Each line
+	//					contains a Node in the format: "m_item m_itemCount".
+	//					false is returned if sout failed.
+	//
+	bool write(ostream &sout) const;
+
+	// write(int fd)
+	// Prints the contents of the tree to the file descriptor fd in the same
+	// format as operator<<, using large write calls.
+	// preconditions:	fd must be open for writing; this not equal to nullptr.
+	// postconditions:	the contents of this are written to fd. false is
+	//					returned if a write failed.
+	//
+	bool write(int fd) const;
+
+	// saveSnapshot
+	// Writes the tree to path in a compact binary form: a SnapshotHeader
+	// followed by the keys, counts and shape of every node in preorder. No
+	// pointers are stored, and loadSnapshot restores the exact structure.
+	// preconditions:	KeyTraits<Key> must encode keys; this not equal to
+	//					nullptr.
+	// postconditions:	true is returned if the whole snapshot was written.
+	//
+	bool saveSnapshot(const string &path) const;
+
+	// freeze
+	// Compiles the tree into a BasicFrozenIndex: an immutable copy of its
+	// keys and counts in Eytzinger order, searched without pointers or
+	// branches on keys. The tree is unchanged and may go on being modified;
+	// the index does not follow. Runs in O(n).
+	// preconditions:	this not equal to nullptr.
+	// postconditions:	an index holding every key and count of the tree is
+	//					returned
+	//
+	BasicFrozenIndex<Key, Compare> freeze() const;
+
+	// diff
+	// Lists the changes that give this tree the keys and counts of tree, for
+	// applyDelta. Both trees are walked in order side by side, and a pair of
+	// subtrees with the same hash, size and weight is passed over whole
+	// without being visited. A copy of a tree that has since had k changes
+	// is compared in about O(k log n), as only the subtrees around changed
+	// or rotated nodes are opened; trees whose shapes are unrelated, as
+	// after rebuild, are walked in full. A pair of
+	// unequal subtrees with the same 64-bit hash would be missed. When
+	// Compare is not less<Key> or greater<Key>, or KeyTraits does not hash
+	// Key, subtrees are compared node by node before they are passed over.
+	// preconditions:	tree must be a valid BasicBSTree object (must not
+	//					reference a dereferenced nullptr); this not equal to
+	//					nullptr.
+	// postconditions:	one entry is returned for each key whose count differs
+	//					between the trees (a missing key counting as 0), in
+	//					ascending order. Both trees are unchanged.
+	//
+	vector<DeltaEntry> diff(const BasicBSTree &tree) const;
+
+	// getPolicy
+	// Returns the BalancePolicy the tree was constructed with
+	// preconditions:	this not equal to nullptr.
+	// postconditions:	m_policy is returned
+	//
+	BalancePolicy getPolicy() const;
+
+	// stats
+	// Takes a snapshot of the tree's counters and shape for monitoring. The
+	// counters are only kept when BSTREE_STATS is defined. The depth figures
+	// are measured by walking the tree at the time of the call, in O(n), and
+	// are always filled in.
+	// preconditions:	this not equal to nullptr.
+	// postconditions:	the current TreeStats of the tree are returned
+	//
+	TreeStats stats() const;
+
+	// memoryFootprint
+	// Returns the number of bytes the tree holds: the tree object and every
+	// chunk of the pools its nodes are carved from. Memory that keys own
+	// elsewhere, such as the text of a string, is not counted.
+	// preconditions:	this not equal to nullptr.
+	// postconditions:	the footprint in bytes is returned
+	//
+	size_t memoryFootprint() const;
+
+	// hash
+	// Returns the hash of the whole tree, kept up to date by every change.
+	// It covers each key, its m_itemCount and the shape of the tree, so two
+	// trees that are equal (operator==) always have the same hash, and trees
+	// with different hashes are never equal. Keys only count towards it when
+	// KeyTraits hashes Key and Compare is less<Key> or greater<Key>, whose
+	// notion of equal keys KeyTraits<Key>::hash follows. The value may
+	// differ between builds.
+	// preconditions:	this not equal to nullptr.
+	// postconditions:	the hash of the tree is returned
+	//
+	uint64_t hash() const;
+
+	// OPERATORS
+
+	// assignment
+	// Sets this equal to tree. Performs a deep copy.
+	// preconditions:	tree must be a valid BSTree object (must not reference
+	//					a dereferenced nullptr); this not equal to nullptr.
+	// postconditions:	this becomes an identical node-by-node copy of tree,
+	//					creating new Nodes and new Keys, and adopts the
+	//					BalancePolicy of tree.
+	//
+	const BasicBSTree& operator=(const BasicBSTree &tree);
+
+	// move assignment
+	// Deletes the nodes of this, then takes over the nodes of tree without
+	// copying or allocating any of them.
+	// preconditions:	tree must be a valid BSTree object (must not reference
+	//					a dereferenced nullptr)
+	// postconditions:	this holds what tree held, with its BalancePolicy;
+	//					tree is left empty.
+	//
+	const BasicBSTree& operator=(BasicBSTree &&tree) noexcept;
+
+	// equality
+	// Node-by-node comparison of this and tree. Returns true only if the 
+	// trees have the same data (including m_itemCount) and structure. Trees
+	// whose hashes differ are told apart in O(1); the nodes are only walked
+	// when the hashes match.
+	// preconditions:	tree must be a valid BSTree object (must not reference
+	//					a dereferenced nullptr); this not equal to nullptr.
+	// postconditions:	If this and tree have same data and structure then true
+	//					is returned, else false is returned.
+	//
+	bool operator==(const BasicBSTree &tree) const;
+
+	// inequality
+	// Node-by-node comparison of this and tree. Returns true only if the 
+	// trees do not have the same data (including m_itemCount) and structure.
+	// Trees whose hashes differ are told apart in O(1).
+	// preconditions:	tree must be a valid BSTree object (must not reference
+	//					a dereferenced nullptr); this not equal to nullptr.
+	// postconditions:	If this and tree do not have same data and structure
+	//					then true is returned, else false is returned.
+	//
+	bool operator!=(const BasicBSTree &tree) const;
+
+	// ITERATORS
+
+	// const_iterator
+	// A bidirectional iterator that visits the keys of the tree in ascending
+	// order. The iterator keeps the path from m_root to its current node
+	// (m_path), so stepping forward or backward costs O(1) amortized and never
+	// visits nodes outside the keys it passes over. An empty path is the end
+	// position. Any insert or remove on the tree invalidates its iterators.
+	//
+	class const_iterator {
+		friend class BasicBSTree;
+
+	public:
+		typedef bidirectional_iterator_tag iterator_category;
+		typedef Key value_type;
+		typedef ptrdiff_t difference_type;
+		typedef const Key* pointer;
+		typedef const Key& reference;
+
+		// default constructor
+		// preconditions:	none
+		// postconditions:	creates an iterator that refers to no tree
+		//
+		const_iterator();
+
+		// dereference
+		// preconditions:	this must not be an end iterator.
+		// postconditions:	the key of the current node is returned
+		//
+		reference operator*() const;
+
+		// member access
+		// preconditions:	this must not be an end iterator.
+		// postconditions:	a pointer to the key of the current node is returned
+		//
+		pointer operator->() const;
+
+		// getCount
+		// Returns the number of occurrences of the current key.
+		// preconditions:	this must not be an end iterator.
+		// postconditions:	the current node's m_itemCount is returned
+		//
+		int getCount() const;
+
+		// pre-increment
+		// Moves to the next key in ascending order.
+		// preconditions:	this must not be an end iterator.
+		// postconditions:	this refers to the in-order successor, or is the end
+		//					iterator if there is none. this is returned.
+		//
+		const_iterator& operator++();
+
+		// post-increment
+		// preconditions:	this must not be an end iterator.
+		// postconditions:	this is advanced; its old position is returned
+		//
+		const_iterator operator++(int);
+
+		// pre-decrement
+		// Moves to the previous key in ascending order. Decrementing the end
+		// iterator moves to the largest key.
+		// preconditions:	this must not refer to the smallest key.
+		// postconditions:	this refers to the in-order predecessor. this is
+		//					returned.
+		//
+		const_iterator& operator--();
+
+		// post-decrement
+		// preconditions:	this must not refer to the smallest key.
+		// postconditions:	this is moved back; its old position is returned
+		//
+		const_iterator operator--(int);
+
+		// equality
+		// preconditions:	other must iterate over the same tree.
+		// postconditions:	true is returned if both refer to the same node or
+		//					both are end iterators.
+		//
+		bool operator==(const const_iterator &other) const;
+
+		// inequality
+		// preconditions:	other must iterate over the same tree.
+		// postconditions:	true is returned if the iterators differ.
+		//
+		bool operator!=(const const_iterator &other) const;
+
+	private:
+		// constructor(const BasicBSTree *tree)
+		// preconditions:	none
+		// postconditions:	creates an end iterator over tree
+		//
+		const_iterator(const BasicBSTree *tree);
+
+		// pushLeftmost: traversal helper
+		// Descends from node to the smallest key below it, adding each node
+		// to m_path.
+		// preconditions:	none
+		// postconditions:	m_path ends at the leftmost node under node, or is
+		//					unchanged if node is nullptr.
+		//
+		void pushLeftmost(const Node *node);
+
+		// pushRightmost: traversal helper
+		// Descends from node to the largest key below it, adding each node to
+		// m_path.
+		// preconditions:	none
+		// postconditions:	m_path ends at the rightmost node under node, or is
+		//					unchanged if node is nullptr.
+		//
+		void pushRightmost(const Node *node);
+
+		// m_tree
+		// the tree being iterated
+		//
+		const BasicBSTree *m_tree;
+
+		// m_path
+		// the nodes from m_root down to the current node
+		//
+		vector<const Node*> m_path;
+	};
+
+	// Range
+	// A pair of iterators bounding a run of keys, usable in a range-based for
+	// loop. Nothing is visited until the range is iterated.
+	//
+	struct Range {
+		// begin
+		// preconditions:	none
+		// postconditions:	m_begin is returned
+		//
+		const_iterator begin() const;
+
+		// end
+		// preconditions:	none
+		// postconditions:	m_end is returned
+		//
+		const_iterator end() const;
+
+		// m_begin
+		// the first key in the range
+		//
+		const_iterator m_begin;
+
+		// m_end
+		// one past the last key in the range
+		//
+		const_iterator m_end;
+	};
+
+	// begin
+	// preconditions:	this not equal to nullptr.
+	// postconditions:	an iterator to the smallest key is returned, or end()
+	//					if the tree is empty.
+	//
+	const_iterator begin() const;
+
+	// end
+	// preconditions:	this not equal to nullptr.
+	// postconditions:	the iterator one past the largest key is returned.
+	//
+	const_iterator end() const;
+
+	// lowerBound
+	// Seeks to the first key not ordered before data in O(depth).
+	// preconditions:	data must be a valid Key object (must not reference
+	//					a dereferenced nullptr); this not equal to nullptr.
+	// postconditions:	an iterator to the smallest key >= data is returned, or
+	//					end() if there is none.
+	//
+	const_iterator lowerBound(const Key &data) const;
+
+	// upperBound
+	// Seeks to the first key ordered after data in O(depth).
+	// preconditions:	data must be a valid Key object (must not reference
+	//					a dereferenced nullptr); this not equal to nullptr.
+	// postconditions:	an iterator to the smallest key > data is returned, or
+	//					end() if there is none.
+	//
+	const_iterator upperBound(const Key &data) const;
+
+	// range
+	// Returns a lazy view of the keys from low to high inclusive. Building the
+	// view costs O(depth); visiting its k keys costs O(k) more, and stopping
+	// early visits nothing further.
+	// preconditions:	low must not be ordered after high; this not equal to
+	//					nullptr.
+	// postconditions:	a Range from lowerBound(low) to upperBound(high) is
+	//					returned.
+	//
+	Range range(const Key &low, const Key &high) const;
+
+private:
+	// DATA
+
+	// struct Node
+	// a node containing a Key object, an item count, and pointers to left
+	// and right children
+	// 
+	struct Node {
+		// default constructor
+		// preconditions:	none
+		// postconditions:	creates a node with a default m_item, m_left and
+		//					m_right equal to nullptr, m_itemCount, m_height and
+		//					m_weight equal to 0, and m_size equal to 1.
+		//
+		Node();
+
+		// constructor(const Key &data)
+		// preconditions:	none
+		// postconditions:	Creates a node with m_item equal to data, m_itemCount
+		//					equal to 1, and m_left and m_right equal to nullptr.
+		//
+		Node(const Key &data);
+
+		// copy constructor (deep copy)
+		// preconditions:	node must be a valid BasicBSTree::Node object (must not 
+		//					reference a dereferenced nullptr)
+		// postconditions:	this becomes an identical copy of node, with
+		//					m_left and m_right equal to nullptr
+		//
+		Node(const Node &node);
+
+		// m_item
+		// the Key object stored in this node
+		//
+		Key m_item;
+
+		// m_itemCount
+		// a counter for the number of occurences of m_item
+		//
+		int m_itemCount;
+
+		// m_left
+		// a pointer to left child
+		//
+		Node *m_left;
+
+		// m_right
+		// a pointer to wrathchild
+		//
+		Node *m_right;
+
+		// m_height
+		// the height of the subtree rooted at this node. A leaf has height 0
+		// and an empty subtree (nullptr) has height -1.
+		//
+		int m_height;
+
+		// m_size
+		// the number of nodes in the subtree rooted at this node
+		//
+		int m_size;
+
+		// m_weight
+		// the sum of m_itemCount over the subtree rooted at this node
+		//
+		int m_weight;
+
+		// m_hash
+		// the hash of m_item, m_itemCount and the hashes of both children
+		//
+		uint64_t m_hash;
+	};
+
+	// m_root
+	// a pointer to the root of the this
+	//
+	Node *m_root;
+
+	// m_policy
+	// the rebalancing strategy applied after each insert and remove
+	//
+	BalancePolicy m_policy;
+
+	// m_pool
+	// the slab allocator new Nodes of this tree are carved from. It is shared
+	// with any NodeHandle or tree holding a node carved from it, and is
+	// nullptr in a tree that was moved from until pool() is next called.
+	//
+	shared_ptr<MemoryPool> m_pool;
+
+	// m_foreignPools
+	// the pools of nodes this tree took in from other trees, kept alive for
+	// as long as such a node may be in this tree. A node is freed into the
+	// pool that owns() it, never into m_pool by default.
+	//
+	vector<shared_ptr<MemoryPool> > m_foreignPools;
+
+	// m_compare
+	// the ordering used to place and find keys
+	//
+	Compare m_compare;
+
+	// StatOperation
+	// the operations whose cost is counted when BSTREE_STATS is defined
+	//
+	enum StatOperation { STAT_INSERT, STAT_REMOVE, STAT_RETRIEVE, STAT_DEPTH, STAT_OPERATIONS };
+
+#ifdef BSTREE_STATS
+	// StatCounters
+	// the running totals behind stats(). They are atomic so that const
+	// lookups running in several threads at once can all add to them.
+	//
+	struct StatCounters {
+		// StatCounters default constructor
+		// preconditions:	none
+		// postconditions:	every counter is 0
+		//
+		StatCounters();
+
+		atomic<long long> m_calls[STAT_OPERATIONS];
+		atomic<long long> m_comparisons[STAT_OPERATIONS];
+		atomic<long long> m_nodesVisited[STAT_OPERATIONS];
+		atomic<long long> m_allocations;
+		atomic<long long> m_frees;
+	};
+
+	// m_statCounters
+	// the counters of this tree; they stay with the tree object when its
+	// contents are copied, moved or swapped
+	//
+	mutable StatCounters m_statCounters;
+#endif
+
+	// OperationTally: instrumentation helper
+	// Counts the comparisons and node visits of one operation while it runs
+	// and adds them to the tree's counters when it goes out of scope. Does
+	// nothing unless BSTREE_STATS is defined.
+	//
+	class OperationTally {
+	public:
+		// constructor(const BasicBSTree *tree, StatOperation operation)
+		// preconditions:	tree not equal to nullptr.
+		// postconditions:	starts counting one call of operation on tree
+		//
+		OperationTally(const BasicBSTree *tree, StatOperation operation);
+
+		// destructor
+		// preconditions:	none
+		// postconditions:	the call and what it counted are added to the
+		//					tree's counters
+		//
+		~OperationTally();
+
+		// visit
+		// preconditions:	none
+		// postconditions:	one more node visit is counted
+		//
+		void visit();
+
+	private:
+		const BasicBSTree *m_tree;
+		StatOperation m_operation;
+		long long m_comparisons;
+		long long m_visited;
+	};
+
+	// HELPER FUNCTIONS
+
+	// copyNode: copy constructor helper (deep copy)
+	// Copies every node under from into one block taken from m_pool, placing
+	// each copy at its preorder index. Large subtrees are copied by other
+	// threads.
+	// preconditions:	this not equal to nullptr.
+	// postconditions:	to becomes an identical copy of from, copying all
+	//					decendants. 
+	//
+	void copyNode(Node *&to, Node *from);
+
+	// copySubtree: copyNode helper
+	// Copies the subtree under from into block, starting at preorder index
+	// index. Runs iteratively; when spawn > 0 the left side of a large node
+	// is copied by another thread.
+	// preconditions:	block has room for size(from) nodes of blockSize bytes
+	//					from index on.
+	// postconditions:	*link points to an identical copy of from's subtree.
+	//
+	static void copySubtree(Node **link, const Node *from, char *block, size_t blockSize, int index,
+			int spawn);
+
+	// spawnDepth: parallel helper
+	// preconditions:	none
+	// postconditions:	the number of levels of two-way splitting needed to
+	//					give every hardware thread a task is returned.
+	//
+	static int spawnDepth();
+
+	// SetOperation
+	// which set operation setNodes performs
+	//
+	enum SetOperation { SET_UNION, SET_INTERSECTION, SET_DIFFERENCE };
+
+	// SetContext
+	// what every step of one set operation shares: the operation, the count
+	// policy, and the block (with one slot per node of the other tree, in
+	// preorder) that keys copied from the other tree are built in.
+	//
+	struct SetContext {
+		SetOperation m_operation;
+		CountPolicy m_policy;
+		char *m_block;
+		size_t m_blockSize;
+		vector<char> *m_used;
+	};
+
+	// applySetOperation: unionWith/intersectWith/differenceWith helper
+	// Runs setNodes over the whole tree and returns unused or freed blocks
+	// to m_pool. A tree that is this tree, or much deeper than a balanced
+	// tree, is first copied and rebuilt so the recursion stays shallow. So
+	// is any tree that is not AVL when this one is, as join needs balanced
+	// subtrees.
+	// preconditions:	tree must be a valid BasicBSTree object.
+	// postconditions:	this holds the result of the operation.
+	//
+	void applySetOperation(const BasicBSTree &tree, SetOperation operation, CountPolicy policy);
+
+	// setNodes: set operation helper
+	// Splits mine at the root key of theirs, applies the operation to each
+	// side against theirs' children, and joins the results. Nodes taken out
+	// of the tree are destroyed and added to garbage for the caller to
+	// return to m_pool.
+	// preconditions:	index is the preorder index of theirs in the other
+	//					tree; no other thread touches mine.
+	// postconditions:	the root of the combined subtree is returned.
+	//
+	Node* setNodes(Node *mine, const Node *theirs, int index, int spawn, const SetContext &context,
+			vector<Node*> &garbage);
+
+	// combineCounts: set operation helper
+	// preconditions:	none
+	// postconditions:	mine and theirs combined by policy are returned
+	//
+	static int combineCounts(int mine, int theirs, CountPolicy policy);
+
+	// discardSubtree: set operation helper
+	// preconditions:	none
+	// postconditions:	every node under node is destroyed and added to
+	//					garbage
+	//
+	static void discardSubtree(Node *node, vector<Node*> &garbage);
+
+	// split: set operation helper
+	// Divides the subtree under node into the keys ordered before data and
+	// the keys ordered after it, detaching the node equal to data.
+	// preconditions:	none
+	// postconditions:	left and right hold the smaller and larger keys, and
+	//					are balanced if m_policy is AVL. match is the node
+	//					equal to data with no children, or nullptr.
+	//
+	void split(Node *node, const Key &data, Node *&left, Node *&match, Node *&right);
+
+	// join: set operation helper
+	// Links middle between two subtrees whose keys are all smaller and all
+	// larger than middle's. Under AVL the shorter subtree is hung at the
+	// matching height on the taller one's spine and rebalanced upward.
+	// preconditions:	middle not equal to nullptr; left and right are
+	//					balanced if m_policy is AVL.
+	// postconditions:	the root of the joined subtree is returned.
+	//
+	Node* join(Node *left, Node *middle, Node *right);
+
+	// joinRight / joinLeft: join helpers
+	// preconditions:	left is taller than right by more than one / right is
+	//					taller than left by more than one.
+	// postconditions:	the root of the joined, balanced subtree is returned.
+	//
+	Node* joinRight(Node *left, Node *middle, Node *right);
+	Node* joinLeft(Node *left, Node *middle, Node *right);
+
+	// joinTwo: set operation helper
+	// Links two subtrees whose keys are all smaller and all larger
+	// respectively, with no middle key.
+	// preconditions:	left and right are balanced if m_policy is AVL.
+	// postconditions:	the root of the joined subtree is returned.
+	//
+	Node* joinTwo(Node *left, Node *right);
+
+	// removeLargest: joinTwo helper
+	// preconditions:	node not equal to nullptr; m_policy is AVL.
+	// postconditions:	the largest node is detached into largest and the
+	//					root of the remaining, balanced subtree is returned.
+	//
+	Node* removeLargest(Node *node, Node *&largest);
+
+	// DiffFrame
+	// a part of one tree that diff has yet to visit: the whole subtree under
+	// m_node, or m_node alone once its left subtree has been visited
+	//
+	struct DiffFrame {
+		const Node *m_node;
+		bool m_whole;
+	};
+
+	// openFrame: diff helper
+	// Replaces the whole subtree on top of frames with its right subtree, its
+	// root alone and its left subtree, so the leftmost part is on top. Empty
+	// subtrees are left out.
+	// preconditions:	frames.back() is a whole subtree.
+	// postconditions:	the subtree is opened one level
+	//
+	static void openFrame(vector<DiffFrame> &frames);
+
+	// isSameSubtree: diff helper
+	// preconditions:	none
+	// postconditions:	true is returned if self and other hold the same keys
+	//					and counts in the same shape, judged by their hashes
+	//					when keys are hashed and node by node otherwise
+	//
+	bool isSameSubtree(const Node *self, const Node *other) const;
+
+	// setCount: applyDelta helper
+	// Sets the m_itemCount of the node holding data, removing the node if
+	// count is below MIN_ITEM_COUNT, and rebalances the path to it.
+	// preconditions:	this not equal to nullptr.
+	// postconditions:	If data is found its count is count, or it is removed.
+	//
+	void setCount(const Key &data, int count);
+
+	// insert helper
+	// Links a node that is in no tree into the tree. If a node containing an
+	// equal m_item already exists in the tree, that node's m_itemCount is
+	// raised by item's and item is returned to the pool.
+	// preconditions:	item must be a leaf in no tree, carved from m_pool or a
+	//					pool in m_foreignPools; this not equal to nullptr.
+	// postconditions:	If item->m_item does not already exist in the tree, then
+	//					item is linked into the tree. If it already exists, then
+	//					m_itemCount is raised by item->m_itemCount and item is
+	//					freed.
+	//
+	bool insert(Node *item, Node *&node);
+	
+	// remove helper
+	// Removes a Key object equal to data from the tree. If there is only
+	// one Key object, the node containing that object is removed and
+	// deleted.
+	// preconditions:	node->m_item must be a valid Key object not equal
+	//					to nullptr; this not equal to nullptr.
+	// postconditions:	If data is not found, then false is returned. If data
+	//					is found and m_itemCount > 1 then m_itemCount is 
+	//					decremented by one; if m_itemCount == 1 then the node
+	//					is removed from the tree and deleted.
+	//
+	bool remove(const Key &data, Node *&node);
+	
+	// deleteNode: remove helper
+	// Deletes a Node with m_item equal to data from the tree.
+	// preconditions:	node must be a valid BasicBSTree::Node object not equal to
+	//					nullptr; this not equal to nullptr.
+	// postconditions:	node is deleted and set to nullptr.
+	//
+	void deleteNode(Node *&node);
+	
+	// deleteSmallest: remove helper
+	// Finds and deletes the Node with the smallest m_item from the tree, then
+	// rebalances the nodes on the path to it.
+	// preconditions:	node must be a valid BasicBSTree::Node object not equal to
+	//					nullptr; this not equal to nullptr.
+	// postconditions:	the smallest node is deleted and replaced by its right
+	//					child. A copy of its m_item is returned and its
+	//					m_itemCount is stored in count.
+	//
+	Key deleteSmallest(Node *&node, int &count);
+
+	// height: balance helper
+	// Returns the height of node.
+	// preconditions:	none
+	// postconditions:	If node is nullptr -1 is returned, else m_height.
+	//
+	static int height(const Node *node);
+
+	// update: balance helper
+	// Recomputes the height, size, weight and hash of node from its children.
+	// preconditions:	node must be a valid BasicBSTree::Node object not equal to
+	//					nullptr; the fields of its children must be correct.
+	// postconditions:	node->m_height is one greater than the height of its
+	//					taller child; m_size and m_weight total the subtree;
+	//					m_hash covers the subtree.
+	//
+	static void update(Node *node);
+
+	// size: order statistic helper
+	// Returns the number of nodes in the subtree rooted at node.
+	// preconditions:	none
+	// postconditions:	If node is nullptr 0 is returned, else m_size.
+	//
+	static int size(const Node *node);
+
+	// weight: order statistic helper
+	// Returns the sum of m_itemCount over the subtree rooted at node.
+	// preconditions:	none
+	// postconditions:	If node is nullptr 0 is returned, else m_weight.
+	//
+	static int weight(const Node *node);
+
+	// subtreeHash: hash helper
+	// Returns the hash of the subtree rooted at node.
+	// preconditions:	none
+	// postconditions:	If node is nullptr EMPTY_HASH is returned, else
+	//					m_hash.
+	//
+	static uint64_t subtreeHash(const Node *node);
+
+	// nodeHash: hash helper
+	// Combines a node's key and count with the hashes of its children in one
+	// mixing step. The children are scrambled differently before they are
+	// combined, so mirror images hash apart.
+	// preconditions:	none
+	// postconditions:	the hash of a node holding item itemCount times
+	//					above left and right is returned
+	//
+	static uint64_t nodeHash(const Key &item, int itemCount, const Node *left, const Node *right);
+
+	// keyHash: hash helper
+	// Hashes a key with KeyTraits when hashesKeys() is true, else returns 0.
+	// preconditions:	none
+	// postconditions:	the hash of key is returned
+	//
+	static uint64_t keyHash(const Key &key);
+
+	// hashesKeys: hash helper
+	// Keys are hashed only when KeyTraits hashes Key and Compare is known to
+	// treat keys as equal exactly when KeyTraits does; under any other
+	// Compare keys equal by Compare may hash differently.
+	// preconditions:	none
+	// postconditions:	true is returned if keys count towards node hashes
+	//
+	static bool hashesKeys();
+
+	// mixHash: hash helper
+	// Scrambles every bit of value into every bit of the result.
+	// preconditions:	none
+	// postconditions:	the mixed value is returned
+	//
+	static uint64_t mixHash(uint64_t value);
+
+	// rotateLeft: balance helper
+	// Rotates the subtree rooted at node to the left, making node's right
+	// child the new root of the subtree.
+	// preconditions:	node and node->m_right must not be nullptr.
+	// postconditions:	node points to the new subtree root; in-order sequence
+	//					and heights are preserved/updated.
+	//
+	static void rotateLeft(Node *&node);
+
+	// rotateRight: balance helper
+	// Rotates the subtree rooted at node to the right, making node's left
+	// child the new root of the subtree.
+	// preconditions:	node and node->m_left must not be nullptr.
+	// postconditions:	node points to the new subtree root; in-order sequence
+	//					and heights are preserved/updated.
+	//
+	static void rotateRight(Node *&node);
+
+	// buildBalanced: assignSorted/rebuild helper
+	// Links nodes[low..high] into a height-balanced subtree, taking the middle
+	// node as the root of each range.
+	// preconditions:	nodes must be in ascending order; low and high must be
+	//					valid indices into nodes or low > high.
+	// postconditions:	the root of the subtree is returned (nullptr for an
+	//					empty range) with correct heights throughout.
+	//
+	static Node* buildBalanced(const vector<Node*> &nodes, int low, int high);
+
+	// rebuildSubtree: rebuild/insertBatch helper
+	// Relinks the nodes under node into a height-balanced subtree.
+	// preconditions:	none
+	// postconditions:	node points to the root of the balanced subtree, which
+	//					holds the same nodes with correct heights throughout.
+	//
+	static void rebuildSubtree(Node *&node);
+
+	// mergeBatch: insertBatch helper
+	// Merges keys[low..high) into the subtree at link. Runs iteratively; when
+	// spawn > 0 the left part of a large split is merged by another thread.
+	// The node for keys[i], if one is needed, is built in nodes[i], and
+	// used[i] is then set.
+	// preconditions:	keys is sorted without repeats, counts holds their
+	//					counts, and nodes[i] is an unused block for each i;
+	//					no other thread touches the subtree at link.
+	// postconditions:	every key in the range is in the subtree, which is
+	//					balanced if m_policy is AVL. The number of new nodes
+	//					and count increments is returned.
+	//
+	InsertBatchResult mergeBatch(Node **link, const vector<Key> &keys, const vector<int> &counts,
+			const vector<Node*> &nodes, vector<char> &used, int low, int high, int spawn);
+
+	// retrace: insert/remove helper
+	// Rebalances every node on path, deepest first, after the tree below the
+	// last entry of path has changed shape.
+	// preconditions:	path must hold the links from an ancestor down to the
+	//					changed subtree, in root-to-leaf order.
+	// postconditions:	every node on path has been passed to rebalance.
+	//
+	void retrace(const vector<Node**> &path);
+
+	// rebalance: insert/remove helper
+	// Updates the height of node and, if m_policy is AVL, performs the single
+	// or double rotation needed to restore the AVL property at node.
+	// preconditions:	the subtrees of node must already be balanced.
+	// postconditions:	node's height is correct. If m_policy is AVL the heights
+	//					of node's children differ by at most one.
+	//
+	void rebalance(Node *&node);
+	
+	// newNode: node allocation helper
+	// Builds a Node holding a copy of data in a block taken from m_pool.
+	// preconditions:	this not equal to nullptr.
+	// postconditions:	a pointer to the new Node is returned.
+	//
+	Node* newNode(const Key &data);
+
+	// adoptPool: node handle helper
+	// preconditions:	pool not equal to nullptr.
+	// postconditions:	if pool is not m_pool, it is in m_foreignPools
+	//
+	void adoptPool(const shared_ptr<MemoryPool> &pool);
+
+	// pool: node allocation helper
+	// A tree that was moved from has no pool; it gets a new one the first
+	// time it allocates a node.
+	// preconditions:	this not equal to nullptr.
+	// postconditions:	m_pool, created if it was nullptr, is returned.
+	//
+	MemoryPool& pool();
+
+	// poolOf: node allocation helper
+	// Finds the pool node was carved from: m_pool unless the tree has taken
+	// in nodes from other trees, in which case the pools are searched.
+	// preconditions:	node is in this tree, or was until just now.
+	// postconditions:	the pool among m_pool and m_foreignPools that owns
+	//					node is returned.
+	//
+	const shared_ptr<MemoryPool>& poolOf(const Node *node) const;
+
+	// freeNode: node allocation helper
+	// Destroys node and returns its block to the pool it was carved from.
+	// preconditions:	node must be in this tree, or have been until just now.
+	// postconditions:	node's memory is back on its pool's free list.
+	//
+	void freeNode(Node *node);
+
+	// compareNode: equality helper
+	// Node-by-node comparison of this and tree. Returns true only if the 
+	// trees have the same data (including m_itemCount) and structure
+	// preconditions:	this not equal to nullptr
+	// postconditions:	If self and other have same data and structure then true
+	//					is returned, else false is returned.
+	//
+	bool compareNode(const Node *self, const Node *other) const;
+	
+	// findNode: descendants helper
+	// finds a Node with m_item equal to data and retunrs a constant pointer to
+	// the Node. If no match is found, nullptr is returned.
+	// preconditions:	data must be a valid Key object (must not reference
+	//					a dereferenced nullptr); this not equal to nullptr.
+	// postconditions:	if data is found, then a constant pointer to the Node 
+	//					containing data is returned, else false is returned.
+	//
+	const Node* findNode(const Key &data) const;
+
+	// findBatch: batch lookup helper
+	// Runs the searches for keys in groups of LOOKUP_BATCH_GROUP, moving
+	// each unfinished search of a group one level down per round and
+	// prefetching the node it moves to.
+	// preconditions:	none
+	// postconditions:	nodes holds the node matching each key, or nullptr.
+	//					If depths is not nullptr it holds the depth of each
+	//					node, or -1.
+	//
+	void findBatch(const vector<Key> &keys, vector<const Node*> &nodes, vector<int> *depths) const;
+
+	// prefetch: batch lookup helper
+	// Hints the processor to start loading node. Has no effect on compilers
+	// without a prefetch builtin.
+	// preconditions:	none
+	// postconditions:	none; node is never dereferenced
+	//
+	static void prefetch(const Node *node);
+	
+	// isLess: comparison helper
+	// Orders two keys with m_compare.
+	// preconditions:	none
+	// postconditions:	true is returned if lhs is ordered before rhs.
+	//
+	bool isLess(const Key &lhs, const Key &rhs) const;
+
+	// isEqual: comparison helper
+	// Two keys are equal when neither is ordered before the other by m_compare.
+	// preconditions:	none
+	// postconditions:	true is returned if lhs and rhs are equivalent.
+	//
+	bool isEqual(const Key &lhs, const Key &rhs) const;
+
+	// comparisonTally: instrumentation helper
+	// preconditions:	none
+	// postconditions:	the number of key comparisons the calling thread has
+	//					made in trees of this type is returned
+	//
+	static long long& comparisonTally();
+
+	// countComparison: instrumentation helper
+	// preconditions:	none
+	// postconditions:	one comparison is counted if BSTREE_STATS is defined
+	//
+	static void countComparison();
+
+	// countAllocations: instrumentation helper
+	// preconditions:	none
+	// postconditions:	count node allocations are counted if BSTREE_STATS
+	//					is defined
+	//
+	void countAllocations(size_t count) const;
+
+	// countFrees: instrumentation helper
+	// preconditions:	none
+	// postconditions:	count node frees are counted if BSTREE_STATS is
+	//					defined
+	//
+	void countFrees(size_t count) const;
+
+	// write: output helper
+	// Formats every node in order into out.
+	// preconditions:	none
+	// postconditions:	each node is appended to out as "m_item m_itemCount\n"
+	//
+	void write(OutputBuffer &out) const;
+
+	// print: output helper
+	// Prints the contents of the tree to sout.
+	// preconditions:	none
+	// postconditions:	the contents of this are printed to sout. Each line
+	//					contains a Node in the format: "m_item m_itemCount"
+	//
+	void print(ostream &sout, Node *node) const;
+};
+
+// BSTree
+// the binary search tree of TreeData objects
+//
+typedef BasicBSTree<TreeData> BSTree;
+
+// swap
+// Exchanges the contents of two trees in constant time.
+// preconditions:	none
+// postconditions:	lhs holds what rhs held and rhs what lhs held
+//
+template<typename Key, typename Compare>
+void swap(BasicBSTree<Key, Compare> &lhs, BasicBSTree<Key, Compare> &rhs) noexcept;
+
+#include "BSTree.cpp"
+#include "FrozenIndex.h"
 #endif
\ No newline at end of file
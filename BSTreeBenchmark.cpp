@@ -0,0 +1,896 @@
+// BSTreeBenchmark.cpp		Author: Sam Hoover
+// contains the benchmark driver for BasicBSTree. It times every tree
+// operation over several key streams and sizes and prints the results as
+// JSON on standard output. Build and run with:
+//
+//		g++ -std=c++11 -O2 -pthread -o bstree_benchmark BSTreeBenchmark.cpp
+//			MemoryPool.cpp OutputBuffer.cpp MappedFile.cpp SnapshotHeader.cpp
+//			PerfCounters.cpp RcuReaders.cpp
+//		./bstree_benchmark [maxSize] [avl|unbalanced|both]
+//
+// maxSize may be any value from 1e3 to 1e8 and defaults to 1e6. Sizes run
+// from 1e3 up to maxSize in steps of ten. The policy defaults to avl; both
+// runs every size and stream under AVL and then UNBALANCED, so one run
+// compares their depth and lookup times on the sorted and reverse streams.
+// Each result gives the policy of its tree and, where the tree has one,
+// the depth of its deepest node from stats().
+//
+// A chain run follows: a tree of BENCH_CHAIN_SIZE nodes, each the right
+// child of the one before, whatever maxSize is, timing the whole-tree
+// operations that must not recurse per level.
+//
+// A thread scaling run follows: a mixed read/write workload on a
+// ConcurrentBSTree and on a BSTree behind one mutex, then inserts on a
+// ShardedBSTree and on a BSTree behind one mutex, from 1 thread up to the
+// number of hardware threads.
+//
+// BSTreeCheck.cpp holds the matching correctness check; run it first, as
+// the benchmark itself does not compare results.
+//
+// Where Linux hardware counters can be read, each result also gives the
+// instructions, cache misses, TLB misses and branch misses per operation;
+// counters that cannot be read are written as null. Reading them may need
+// perf_event_paranoid lowered to 2 or below, and they are rarely offered
+// inside virtual machines or containers.
+//
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include "BSTree.h"
+#include "ConcurrentBSTree.h"
+#include "PerfCounters.h"
+#include "ShardedBSTree.h"
+using namespace std;
+
+// BENCH_MIN_SIZE, BENCH_MAX_SIZE
+// the smallest tree size measured, and the largest maxSize accepted
+//
+const long long BENCH_MIN_SIZE = 1000;
+const long long BENCH_MAX_SIZE = 100000000;
+
+// BENCH_DEFAULT_SIZE
+// the largest tree size measured when none is given
+//
+const long long BENCH_DEFAULT_SIZE = 1000000;
+
+// BENCH_QUERY_LIMIT
+// the most lookups timed for retrieve, depth and descendants at one size
+//
+const size_t BENCH_QUERY_LIMIT = 1000000;
+
+// BENCH_LOOKUP_BATCH
+// the number of keys in each retrieveBatch call timed; a request handler
+// looks up a few hundred keys at a time
+//
+const size_t BENCH_LOOKUP_BATCH = 256;
+
+// BENCH_LATENCY_SAMPLES
+// about how many operations of one run are timed one by one for the
+// latency percentiles; the rest are only counted in the throughput
+//
+const size_t BENCH_LATENCY_SAMPLES = 100000;
+
+// BENCH_WHOLE_TREE_KEYS
+// about how many keys a whole-tree operation (copy, compare, output) visits
+// in total at one size; small trees are processed repeatedly to reach it
+//
+const long long BENCH_WHOLE_TREE_KEYS = 10000000;
+
+// BENCH_UNBALANCED_SORTED_LIMIT
+// the largest sorted or reverse-sorted stream fed to an UNBALANCED tree,
+// which degenerates into a list and takes quadratic time to build
+//
+const long long BENCH_UNBALANCED_SORTED_LIMIT = 10000;
+
+// BENCH_ZIPF_THETA
+// the skew of the Zipfian stream; the most popular key is drawn about
+// 1 / zeta(n) of the time
+//
+const double BENCH_ZIPF_THETA = 0.99;
+
+// BENCH_NULL_DEVICE
+// the device operator<< and write are timed against to include the cost of
+// their system calls
+//
+const char BENCH_NULL_DEVICE[] = "/dev/null";
+
+// BENCH_DUPLICATE_FACTOR
+// the average number of times each key appears in the duplicate-heavy
+// stream
+//
+const long long BENCH_DUPLICATE_FACTOR = 100;
+
+// BENCH_CHAIN_SIZE
+// the number of nodes in the chain run
+//
+const long long BENCH_CHAIN_SIZE = 10000000;
+
+// BENCH_CHAIN_PATH
+// the snapshot the chain is written to and loaded from, removed afterwards
+//
+const char BENCH_CHAIN_PATH[] = "bstree_benchmark_chain.snap";
+
+// BENCH_SCALING_SIZE
+// the number of keys drawn into each tree before a thread scaling run, or
+// maxSize if that is smaller
+//
+const long long BENCH_SCALING_SIZE = 1000000;
+
+// BENCH_SCALING_OPERATIONS
+// the number of operations in one thread scaling run, shared evenly among
+// its threads
+//
+const long long BENCH_SCALING_OPERATIONS = 4000000;
+
+// BENCH_SCALING_READ_PERCENT
+// the percentage of retrieve calls in the mixed workload; the rest are split
+// evenly between insert and remove
+//
+const int BENCH_SCALING_READ_PERCENT = 90;
+
+// Distribution
+// the key streams a tree is built from
+//		UNIFORM:	independent keys drawn uniformly from all ints >= 0
+//		SORTED:		0, 1, ..., n - 1
+//		REVERSE:	n - 1, n - 2, ..., 0
+//		ZIPF:		keys 1..n drawn with Zipfian popularity
+//		DUPLICATE:	keys drawn uniformly from n / BENCH_DUPLICATE_FACTOR
+//					values
+//		CHAIN:		0, 1, ..., n - 1 loaded as a chain of right children;
+//					used only by the chain run
+//
+enum Distribution { UNIFORM, SORTED, REVERSE, ZIPF, DUPLICATE, CHAIN };
+
+// BENCH_DISTRIBUTIONS
+// every Distribution of the size runs, in the order they are run
+//
+const Distribution BENCH_DISTRIBUTIONS[] = { UNIFORM, SORTED, REVERSE, ZIPF, DUPLICATE };
+
+// BenchTree
+// the tree type being measured
+//
+typedef BasicBSTree<int> BenchTree;
+
+// BenchResult
+// the measurements of one operation at one size over one stream
+//		m_operation:	the operation timed
+//		m_operations:	the number of operations (or keys, for whole-tree
+//						operations) processed
+//		m_seconds:		the total time taken
+//		m_p50, m_p99:	the median and 99th percentile time of one
+//						operation (or one pass over the tree), in ns
+//		m_events:		the count of each hardware event over the run, or -1
+//						where it was not counted
+//		m_threads:		the number of threads the operations were shared by
+//		m_maxDepth:		the depth of the deepest node of the tree the
+//						operations ran on, or -1 where it was not measured
+//		m_skipped:		true if the run was not made
+//
+struct BenchResult {
+	string m_operation;
+	long long m_operations;
+	double m_seconds;
+	double m_p50;
+	double m_p99;
+	long long m_events[COUNTER_KINDS];
+	int m_threads;
+	int m_maxDepth;
+	bool m_skipped;
+};
+
+// NullBuffer
+// A stream buffer that throws away everything written to it, so operator<<
+// can be timed without the cost of a real device.
+//
+class NullBuffer : public streambuf {
+protected:
+	// overflow
+	// preconditions:	none
+	// postconditions:	c is discarded; success is returned
+	//
+	int overflow(int c) {
+		return(traits_type::not_eof(c));
+	}
+
+	// xsputn
+	// preconditions:	none
+	// postconditions:	count characters are discarded; count is returned
+	//
+	streamsize xsputn(const char *text, streamsize count) {
+		(void)text;
+		return(count);
+	}
+};
+
+// g_sink
+// collects a value from every timed operation so the compiler cannot drop
+// operations whose results are otherwise unused
+//
+static volatile long long g_sink = 0;
+
+// g_counters
+// the hardware event counters, opened once and started around every timed
+// loop
+//
+static PerfCounters g_counters;
+
+// readEvents
+// preconditions:	g_counters was stopped.
+// postconditions:	the count of each event is copied into result
+//
+static void readEvents(BenchResult &result) {
+	for(int i = 0; i < COUNTER_KINDS; i++) {
+		result.m_events[i] = g_counters.getCount(static_cast<PerfEvent>(i));
+	}
+}
+
+// elapsedNs
+// preconditions:	none
+// postconditions:	the nanoseconds between start and end are returned
+//
+static double elapsedNs(chrono::steady_clock::time_point start, chrono::steady_clock::time_point end) {
+	return(chrono::duration<double, nano>(end - start).count());
+}
+
+// percentile
+// preconditions:	0 <= fraction <= 1
+// postconditions:	the value below which fraction of samples lie is
+//					returned, or 0 if samples is empty. samples is
+//					reordered.
+//
+static double percentile(vector<double> &samples, double fraction) {
+	if(samples.empty()) {
+		return(0);
+	}
+	size_t index = static_cast<size_t>(fraction * (samples.size() - 1));
+	nth_element(samples.begin(), samples.begin() + index, samples.end());
+	return(samples[index]);
+}
+
+// peakRssKb
+// preconditions:	none
+// postconditions:	the largest resident set size the process has reached
+//					so far is returned, in kilobytes
+//
+static long peakRssKb() {
+	struct rusage usage;
+	if(getrusage(RUSAGE_SELF, &usage) != 0) {
+		return(0);
+	}
+#if defined(__APPLE__)
+	return(usage.ru_maxrss / 1024);
+#else
+	return(usage.ru_maxrss);
+#endif
+}
+
+// distributionName
+// preconditions:	none
+// postconditions:	the name of distribution used in the JSON output is
+//					returned
+//
+static const char* distributionName(Distribution distribution) {
+	switch(distribution) {
+	case SORTED:
+		return("sorted");
+	case REVERSE:
+		return("reverse");
+	case ZIPF:
+		return("zipf");
+	case DUPLICATE:
+		return("duplicate");
+	case CHAIN:
+		return("chain");
+	default:
+		return("uniform");
+	}
+}
+
+// policyName
+// preconditions:	none
+// postconditions:	the name of policy used on the command line and in the
+//					JSON output is returned
+//
+static const char* policyName(BalancePolicy policy) {
+	return(policy == AVL ? "avl" : "unbalanced");
+}
+
+// makeKeys
+// Draws a stream of count keys from distribution. The Zipfian keys follow
+// Gray et al., "Quickly Generating Billion-Record Synthetic Databases".
+// preconditions:	count > 0
+// postconditions:	the stream is returned
+//
+static vector<int> makeKeys(Distribution distribution, long long count, mt19937_64 &random) {
+	vector<int> keys(static_cast<size_t>(count));
+	switch(distribution) {
+	case SORTED:
+		for(long long i = 0; i < count; i++) {
+			keys[i] = static_cast<int>(i);
+		}
+		break;
+	case REVERSE:
+		for(long long i = 0; i < count; i++) {
+			keys[i] = static_cast<int>(count - 1 - i);
+		}
+		break;
+	case ZIPF: {
+		double zetaN = 0;
+		for(long long i = 1; i <= count; i++) {
+			zetaN += 1.0 / pow(static_cast<double>(i), BENCH_ZIPF_THETA);
+		}
+		double zeta2 = 1.0 + 1.0 / pow(2.0, BENCH_ZIPF_THETA);
+		double alpha = 1.0 / (1.0 - BENCH_ZIPF_THETA);
+		double eta = (1.0 - pow(2.0 / count, 1.0 - BENCH_ZIPF_THETA)) / (1.0 - zeta2 / zetaN);
+		uniform_real_distribution<double> unit(0.0, 1.0);
+		for(long long i = 0; i < count; i++) {
+			double u = unit(random);
+			double uz = u * zetaN;
+			long long rank;
+			if(uz < 1.0) {
+				rank = 1;
+			} else if(uz < zeta2) {
+				rank = 2;
+			} else {
+				rank = 1 + static_cast<long long>(count * pow(eta * u - eta + 1.0, alpha));
+			}
+			keys[i] = static_cast<int>(min(rank, count));
+		}
+		break;
+	}
+	case DUPLICATE: {
+		uniform_int_distribution<int> draw(0, static_cast<int>(max(1LL, count / BENCH_DUPLICATE_FACTOR) - 1));
+		for(long long i = 0; i < count; i++) {
+			keys[i] = draw(random);
+		}
+		break;
+	}
+	default: {
+		uniform_int_distribution<int> draw(0, 0x7fffffff);
+		for(long long i = 0; i < count; i++) {
+			keys[i] = draw(random);
+		}
+		break;
+	}
+	}
+	return(keys);
+}
+
+// timePointOperation
+// Runs op(0) .. op(count - 1), timing about BENCH_LATENCY_SAMPLES of the
+// calls one by one for the percentiles and the whole loop for throughput.
+// The hardware counts cover the whole loop, including the clock reads of
+// the sampled calls.
+// preconditions:	op(i) must be valid for i < count.
+// postconditions:	the measurements are returned under operation
+//
+template<typename Operation>
+static BenchResult timePointOperation(const char *operation, size_t count, Operation op) {
+	size_t stride = count / BENCH_LATENCY_SAMPLES + 1;
+	vector<double> samples;
+	samples.reserve(count / stride + 1);
+	g_counters.start();
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	for(size_t i = 0; i < count; i++) {
+		if(i % stride == 0) {
+			chrono::steady_clock::time_point before = chrono::steady_clock::now();
+			op(i);
+			samples.push_back(elapsedNs(before, chrono::steady_clock::now()));
+		} else {
+			op(i);
+		}
+	}
+	chrono::steady_clock::time_point end = chrono::steady_clock::now();
+	g_counters.stop();
+	BenchResult result;
+	result.m_operation = operation;
+	result.m_operations = static_cast<long long>(count);
+	result.m_seconds = elapsedNs(start, end) / 1e9;
+	readEvents(result);
+	result.m_p50 = percentile(samples, 0.50);
+	result.m_p99 = percentile(samples, 0.99);
+	result.m_threads = 1;
+	result.m_maxDepth = -1;
+	result.m_skipped = false;
+	return(result);
+}
+
+// timeTreeOperation
+// Runs op() passes times, timing each pass, for operations that visit the
+// whole tree of size keys at once.
+// preconditions:	passes > 0
+// postconditions:	the measurements are returned under operation, with
+//					m_operations counting keys visited
+//
+template<typename Operation>
+static BenchResult timeTreeOperation(const char *operation, long long size, int passes, Operation op) {
+	vector<double> samples;
+	g_counters.start();
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	for(int i = 0; i < passes; i++) {
+		chrono::steady_clock::time_point before = chrono::steady_clock::now();
+		op();
+		samples.push_back(elapsedNs(before, chrono::steady_clock::now()));
+	}
+	chrono::steady_clock::time_point end = chrono::steady_clock::now();
+	g_counters.stop();
+	BenchResult result;
+	result.m_operation = operation;
+	result.m_operations = size * passes;
+	result.m_seconds = elapsedNs(start, end) / 1e9;
+	readEvents(result);
+	result.m_p50 = percentile(samples, 0.50);
+	result.m_p99 = percentile(samples, 0.99);
+	result.m_threads = 1;
+	result.m_maxDepth = -1;
+	result.m_skipped = false;
+	return(result);
+}
+
+// timeThreadedOperation
+// Runs op(thread, 0) .. op(thread, count / threads - 1) on each of threads
+// threads at once, timing from when they are released together until the
+// last finishes, and about BENCH_LATENCY_SAMPLES calls one by one. The
+// hardware counters only follow the calling thread, so none are reported.
+// preconditions:	threads > 0; op(thread, i) must be safe to call from
+//					every thread at once and returns a value to keep.
+// postconditions:	the measurements are returned under operation
+//
+template<typename Operation>
+static BenchResult timeThreadedOperation(const char *operation, int threads, size_t count, Operation op) {
+	size_t perThread = count / threads;
+	size_t stride = count / BENCH_LATENCY_SAMPLES + 1;
+	vector<vector<double> > samples(threads);
+	vector<long long> sinks(threads, 0);
+	atomic<bool> released(false);
+	vector<thread> workers;
+	for(int t = 0; t < threads; t++) {
+		workers.push_back(thread([&, t]() {
+			long long sink = 0;
+			while(!released.load(memory_order_acquire)) {
+				this_thread::yield();
+			}
+			for(size_t i = 0; i < perThread; i++) {
+				if(i % stride == 0) {
+					chrono::steady_clock::time_point before = chrono::steady_clock::now();
+					sink += op(t, i);
+					samples[t].push_back(elapsedNs(before, chrono::steady_clock::now()));
+				} else {
+					sink += op(t, i);
+				}
+			}
+			sinks[t] = sink;
+		}));
+	}
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	released.store(true, memory_order_release);
+	for(int t = 0; t < threads; t++) {
+		workers[t].join();
+	}
+	chrono::steady_clock::time_point end = chrono::steady_clock::now();
+	vector<double> all;
+	for(int t = 0; t < threads; t++) {
+		g_sink += sinks[t];
+		all.insert(all.end(), samples[t].begin(), samples[t].end());
+	}
+	BenchResult result;
+	result.m_operation = operation;
+	result.m_operations = static_cast<long long>(perThread * threads);
+	result.m_seconds = elapsedNs(start, end) / 1e9;
+	for(int i = 0; i < COUNTER_KINDS; i++) {
+		result.m_events[i] = -1;
+	}
+	result.m_p50 = percentile(all, 0.50);
+	result.m_p99 = percentile(all, 0.99);
+	result.m_threads = threads;
+	result.m_maxDepth = -1;
+	result.m_skipped = false;
+	return(result);
+}
+
+// runSize
+// Builds a tree from one stream and times every operation on it: insert,
+// retrieve, frozen_retrieve (the same lookups on the tree's freeze()),
+// retrieve_batch (the same lookups through retrieveBatch, BENCH_LOOKUP_BATCH
+// at a time, with the percentiles timing whole batches), depth,
+// descendants, copy (copyNode), freeze, compare (compareNode), output
+// (operator<<), write (the buffered write, to the same stream as
+// output), output_device and write_device (the same two on
+// BENCH_NULL_DEVICE, skipped if it cannot be opened), and finally remove
+// until the tree is empty. Every result gives the depth of the tree as
+// built.
+// preconditions:	size > 0
+// postconditions:	one result per operation is returned
+//
+static vector<BenchResult> runSize(Distribution distribution, long long size, BalancePolicy policy,
+		mt19937_64 &random) {
+	vector<BenchResult> results;
+	vector<int> keys = makeKeys(distribution, size, random);
+	BenchTree tree(policy);
+	results.push_back(timePointOperation("insert", keys.size(), [&](size_t i) {
+		g_sink += tree.emplace(keys[i]);
+	}));
+
+	// lookups and removals follow the popularity of the stream, not its order
+	vector<int> queries(keys);
+	shuffle(queries.begin(), queries.end(), random);
+	size_t queryCount = min(queries.size(), BENCH_QUERY_LIMIT);
+	results.push_back(timePointOperation("retrieve", queryCount, [&](size_t i) {
+		g_sink += tree.retrieve(queries[i]) != nullptr;
+	}));
+	{
+		BasicFrozenIndex<int> frozen = tree.freeze();
+		results.push_back(timePointOperation("frozen_retrieve", queryCount, [&](size_t i) {
+			g_sink += frozen.retrieve(queries[i]) != nullptr;
+		}));
+	}
+	vector<vector<int> > batches(queryCount / BENCH_LOOKUP_BATCH);
+	for(size_t b = 0; b < batches.size(); b++) {
+		batches[b].assign(queries.begin() + b * BENCH_LOOKUP_BATCH, queries.begin() + (b + 1) * BENCH_LOOKUP_BATCH);
+	}
+	vector<const int*> found;
+	BenchResult batched = timePointOperation("retrieve_batch", batches.size(), [&](size_t b) {
+		tree.retrieveBatch(batches[b], found);
+		g_sink += found.back() != nullptr;
+	});
+	batched.m_operations *= BENCH_LOOKUP_BATCH;
+	results.push_back(batched);
+	results.push_back(timePointOperation("depth", queryCount, [&](size_t i) {
+		g_sink += tree.depth(queries[i]);
+	}));
+	results.push_back(timePointOperation("descendants", queryCount, [&](size_t i) {
+		g_sink += tree.descendants(queries[i]);
+	}));
+
+	long long distinct = tree.size();
+	int passes = static_cast<int>(max(1LL, min(100LL, BENCH_WHOLE_TREE_KEYS / max(1LL, distinct))));
+	results.push_back(timeTreeOperation("copy", distinct, passes, [&]() {
+		BenchTree copy(tree);
+		g_sink += copy.isEmpty();
+	}));
+	results.push_back(timeTreeOperation("freeze", distinct, passes, [&]() {
+		g_sink += tree.freeze().size();
+	}));
+	BenchTree copy(tree);
+	results.push_back(timeTreeOperation("compare", distinct, passes, [&]() {
+		g_sink += tree == copy;
+	}));
+	copy.makeEmpty();
+	NullBuffer discard;
+	ostream sout(&discard);
+	results.push_back(timeTreeOperation("output", distinct, passes, [&]() {
+		sout << tree;
+	}));
+	results.push_back(timeTreeOperation("write", distinct, passes, [&]() {
+		g_sink += tree.write(sout);
+	}));
+
+	// the same pair on a real device, where each flush is a system call
+	ofstream devNull(BENCH_NULL_DEVICE);
+	int devNullFd = open(BENCH_NULL_DEVICE, O_WRONLY);
+	if(devNull && devNullFd >= 0) {
+		results.push_back(timeTreeOperation("output_device", distinct, passes, [&]() {
+			devNull << tree;
+		}));
+		results.push_back(timeTreeOperation("write_device", distinct, passes, [&]() {
+			g_sink += tree.write(devNullFd);
+		}));
+	}
+	if(devNullFd >= 0) {
+		close(devNullFd);
+	}
+
+	int maxDepth = tree.stats().m_maxDepth;
+	results.push_back(timePointOperation("remove", queries.size(), [&](size_t i) {
+		g_sink += tree.remove(queries[i]);
+	}));
+	for(size_t i = 0; i < results.size(); i++) {
+		results[i].m_maxDepth = maxDepth;
+	}
+	return(results);
+}
+
+// runChain
+// Writes a snapshot of a chain of size nodes, each the right child of the
+// one before, and loads it, which builds the chain in linear time where
+// inserting a sorted stream would take quadratic time. Then times load,
+// copy, compare, output, write and destroy (makeEmpty) on the chain, one
+// pass each, every result giving the depth of the chain. If the snapshot
+// cannot be written or loaded, one skipped result is returned in place of
+// the rest.
+// preconditions:	size > 0
+// postconditions:	one result per operation is returned
+//
+static vector<BenchResult> runChain(long long size) {
+	vector<BenchResult> results;
+	SnapshotHeader header = SnapshotHeader();
+	memcpy(header.m_magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+	header.m_version = SNAPSHOT_VERSION;
+	header.m_byteOrder = SNAPSHOT_BYTE_ORDER;
+	header.m_keySize = KeyTraits<int>::ENCODED_SIZE;
+	header.m_keyTag = KeyTraits<int>::KEY_TAG;
+	header.m_policy = UNBALANCED;
+	header.m_nodeCount = size;
+
+	// in preorder, a chain of right children is its keys in ascending order
+	vector<char> payload(header.payloadSize());
+	char *keys = payload.data();
+	char *counts = keys + size * header.m_keySize;
+	char *shape = counts + size * sizeof(int32_t);
+	for(long long i = 0; i < size; i++) {
+		KeyTraits<int>::encode(static_cast<int>(i), keys + i * header.m_keySize);
+		int32_t itemCount = MIN_ITEM_COUNT;
+		memcpy(counts + i * sizeof(int32_t), &itemCount, sizeof(int32_t));
+		shape[i] = i + 1 < size ? SNAPSHOT_HAS_RIGHT : 0;
+	}
+	header.m_checksum = SnapshotHeader::checksum(payload.data(), payload.size());
+	ofstream file(BENCH_CHAIN_PATH, ios::binary | ios::trunc);
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	file.write(payload.data(), payload.size());
+	file.close();
+	vector<char>().swap(payload);
+
+	BenchTree tree;
+	bool loaded = false;
+	BenchResult load = timeTreeOperation("load", size, 1, [&]() {
+		loaded = !file.fail() && tree.loadSnapshot(BENCH_CHAIN_PATH);
+	});
+	remove(BENCH_CHAIN_PATH);
+	if(!loaded) {
+		BenchResult skipped;
+		skipped.m_operation = "all";
+		skipped.m_threads = 1;
+		skipped.m_maxDepth = -1;
+		skipped.m_skipped = true;
+		results.push_back(skipped);
+		return(results);
+	}
+	results.push_back(load);
+
+	results.push_back(timeTreeOperation("copy", size, 1, [&]() {
+		BenchTree copy(tree);
+		g_sink += copy.isEmpty();
+	}));
+	BenchTree copy(tree);
+	results.push_back(timeTreeOperation("compare", size, 1, [&]() {
+		g_sink += tree == copy;
+	}));
+	copy.makeEmpty();
+	NullBuffer discard;
+	ostream sout(&discard);
+	results.push_back(timeTreeOperation("output", size, 1, [&]() {
+		sout << tree;
+	}));
+	results.push_back(timeTreeOperation("write", size, 1, [&]() {
+		g_sink += tree.write(sout);
+	}));
+	int maxDepth = tree.stats().m_maxDepth;
+	results.push_back(timeTreeOperation("destroy", size, 1, [&]() {
+		tree.makeEmpty();
+	}));
+	for(size_t i = 0; i < results.size(); i++) {
+		results[i].m_maxDepth = maxDepth;
+	}
+	return(results);
+}
+
+// runScaling
+// Times the mixed workload on threads threads: each operation is a
+// retrieve BENCH_SCALING_READ_PERCENT percent of the time, else an insert
+// or a remove, of a key drawn uniformly from twice the range the trees were
+// filled from. The same streams are run on a ConcurrentBSTree ("mixed") and
+// on a BSTree of policy with every call behind one mutex ("mixed_locked").
+// Then each thread inserts keys drawn from its own slice of that range into
+// an empty ShardedBSTree with one shard per slice ("insert_sharded"), and
+// the same streams into an empty BSTree behind one mutex ("insert_locked").
+// preconditions:	size > 0; threads > 0
+// postconditions:	one result per workload and tree is returned
+//
+static vector<BenchResult> runScaling(long long size, int threads, BalancePolicy policy, mt19937_64 &random) {
+	vector<BenchResult> results;
+	uniform_int_distribution<int> draw(0, static_cast<int>(min(2 * size, 0x7fffffffLL)));
+	uniform_int_distribution<int> percent(0, 99);
+	BasicConcurrentBSTree<int> concurrent;
+	BenchTree locked(policy);
+	for(long long i = 0; i < size; i++) {
+		int key = draw(random);
+		concurrent.insert(key);
+		locked.insert(key);
+	}
+	size_t perThread = static_cast<size_t>(BENCH_SCALING_OPERATIONS / threads);
+	vector<vector<int> > keys(threads, vector<int>(perThread));
+	vector<vector<int> > kinds(threads, vector<int>(perThread));
+	for(int t = 0; t < threads; t++) {
+		for(size_t i = 0; i < perThread; i++) {
+			keys[t][i] = draw(random);
+			kinds[t][i] = percent(random);
+		}
+	}
+	const int insertBelow = BENCH_SCALING_READ_PERCENT + (100 - BENCH_SCALING_READ_PERCENT) / 2;
+
+	results.push_back(timeThreadedOperation("mixed", threads, BENCH_SCALING_OPERATIONS, [&](int t, size_t i) -> long long {
+		int key = keys[t][i];
+		if(kinds[t][i] < BENCH_SCALING_READ_PERCENT) {
+			return(concurrent.retrieve(key) != nullptr);
+		} else if(kinds[t][i] < insertBelow) {
+			return(concurrent.insert(key));
+		}
+		return(concurrent.remove(key));
+	}));
+	mutex lock;
+	results.push_back(timeThreadedOperation("mixed_locked", threads, BENCH_SCALING_OPERATIONS, [&](int t, size_t i) -> long long {
+		int key = keys[t][i];
+		lock_guard<mutex> guard(lock);
+		if(kinds[t][i] < BENCH_SCALING_READ_PERCENT) {
+			return(locked.retrieve(key) != nullptr);
+		} else if(kinds[t][i] < insertBelow) {
+			return(locked.insert(key));
+		}
+		return(locked.remove(key));
+	}));
+
+	// the sample of slice starts makes them exactly the shard boundaries
+	long long range = min(2 * size, 0x7fffffffLL) + 1;
+	vector<int> starts(threads);
+	for(int t = 0; t < threads; t++) {
+		starts[t] = static_cast<int>(range * t / threads);
+		uniform_int_distribution<int> slice(starts[t], static_cast<int>(range * (t + 1) / threads - 1));
+		for(size_t i = 0; i < perThread; i++) {
+			keys[t][i] = slice(random);
+		}
+	}
+	BasicShardedBSTree<int> sharded(starts.begin(), starts.end(), threads, policy);
+	results.push_back(timeThreadedOperation("insert_sharded", threads, BENCH_SCALING_OPERATIONS, [&](int t, size_t i) -> long long {
+		return(sharded.insert(keys[t][i]));
+	}));
+	BenchTree single(policy);
+	results.push_back(timeThreadedOperation("insert_locked", threads, BENCH_SCALING_OPERATIONS, [&](int t, size_t i) -> long long {
+		lock_guard<mutex> guard(lock);
+		return(single.insert(keys[t][i]));
+	}));
+	return(results);
+}
+
+// writeResult
+// Prints one result as a JSON object.
+// preconditions:	none
+// postconditions:	the object is written to sout, preceded by a comma
+//					unless first is true
+//
+static void writeResult(ostream &sout, const BenchResult &result, Distribution distribution,
+		BalancePolicy policy, long long size, bool first) {
+	sout << (first ? "\n" : ",\n") << "    {\"operation\": \"" << result.m_operation
+			<< "\", \"distribution\": \"" << distributionName(distribution)
+			<< "\", \"policy\": \"" << policyName(policy)
+			<< "\", \"size\": " << size << ", \"threads\": " << result.m_threads;
+	if(result.m_skipped) {
+		sout << ", \"skipped\": true}";
+		return;
+	}
+	double throughput = result.m_seconds > 0 ? result.m_operations / result.m_seconds : 0;
+	sout << ", \"max_depth\": ";
+	if(result.m_maxDepth < 0) {
+		sout << "null";
+	} else {
+		sout << result.m_maxDepth;
+	}
+	sout << ", \"operations\": " << result.m_operations
+			<< fixed << setprecision(6) << ", \"seconds\": " << result.m_seconds
+			<< setprecision(1) << ", \"throughput_per_s\": " << throughput
+			<< ", \"p50_ns\": " << result.m_p50
+			<< ", \"p99_ns\": " << result.m_p99
+			<< setprecision(3);
+	for(int i = 0; i < COUNTER_KINDS; i++) {
+		sout << ", \"" << PerfCounters::getName(static_cast<PerfEvent>(i)) << "_per_op\": ";
+		if(result.m_events[i] < 0 || result.m_operations == 0) {
+			sout << "null";
+		} else {
+			sout << static_cast<double>(result.m_events[i]) / result.m_operations;
+		}
+	}
+	sout << ", \"peak_rss_kb\": " << peakRssKb() << "}";
+	sout.unsetf(ios::floatfield);
+}
+
+// main
+// preconditions:	argv[1], if given, is the largest size to measure;
+//					argv[2], if given, is "avl", "unbalanced" or "both".
+// postconditions:	the results are printed to standard output as one JSON
+//					object. 1 is returned for bad arguments, else 0.
+//
+int main(int argc, char *argv[]) {
+	long long maxSize = BENCH_DEFAULT_SIZE;
+	vector<BalancePolicy> policies(1, AVL);
+	if(argc > 1) {
+		maxSize = atoll(argv[1]);
+		if(maxSize < BENCH_MIN_SIZE || maxSize > BENCH_MAX_SIZE) {
+			cerr << "maxSize must be between " << BENCH_MIN_SIZE << " and " << BENCH_MAX_SIZE << endl;
+			return(1);
+		}
+	}
+	if(argc > 2) {
+		if(strcmp(argv[2], "unbalanced") == 0) {
+			policies[0] = UNBALANCED;
+		} else if(strcmp(argv[2], "both") == 0) {
+			policies.push_back(UNBALANCED);
+		} else if(strcmp(argv[2], "avl") != 0) {
+			cerr << "policy must be avl, unbalanced or both" << endl;
+			return(1);
+		}
+	}
+
+	mt19937_64 random(343);
+	cout << "{\n  \"benchmark\": \"BSTree\",\n  \"key\": \"int\",\n  \"policy\": \""
+			<< (policies.size() > 1 ? "both" : policyName(policies[0])) << "\",\n  \"perf_counters\": "
+			<< (g_counters.isAvailable() ? "true" : "false");
+	if(!g_counters.isAvailable()) {
+		cout << ",\n  \"perf_counters_error\": \"" << g_counters.getError() << "\"";
+	}
+	cout << ",\n  \"results\": [";
+	bool first = true;
+	for(long long size = BENCH_MIN_SIZE; size <= maxSize; size *= 10) {
+		for(size_t d = 0; d < sizeof(BENCH_DISTRIBUTIONS) / sizeof(BENCH_DISTRIBUTIONS[0]); d++) {
+			Distribution distribution = BENCH_DISTRIBUTIONS[d];
+			for(size_t p = 0; p < policies.size(); p++) {
+				if(policies[p] == UNBALANCED && (distribution == SORTED || distribution == REVERSE) &&
+						size > BENCH_UNBALANCED_SORTED_LIMIT) {
+					BenchResult skipped;
+					skipped.m_operation = "all";
+					skipped.m_threads = 1;
+					skipped.m_maxDepth = -1;
+					skipped.m_skipped = true;
+					writeResult(cout, skipped, distribution, policies[p], size, first);
+					first = false;
+					continue;
+				}
+				vector<BenchResult> results = runSize(distribution, size, policies[p], random);
+				for(size_t i = 0; i < results.size(); i++) {
+					writeResult(cout, results[i], distribution, policies[p], size, first);
+					first = false;
+				}
+				cout.flush();
+			}
+		}
+	}
+
+	vector<BenchResult> chain = runChain(BENCH_CHAIN_SIZE);
+	for(size_t i = 0; i < chain.size(); i++) {
+		writeResult(cout, chain[i], CHAIN, UNBALANCED, BENCH_CHAIN_SIZE, first);
+		first = false;
+	}
+	cout.flush();
+
+	// thread counts double from 1, ending with the number of hardware
+	// threads; the locked and sharded trees take the first policy
+	long long scalingSize = min(maxSize, BENCH_SCALING_SIZE);
+	int maxThreads = max(1, static_cast<int>(thread::hardware_concurrency()));
+	for(int threads = 1; ; threads = min(threads * 2, maxThreads)) {
+		vector<BenchResult> results = runScaling(scalingSize, threads, policies[0], random);
+		for(size_t i = 0; i < results.size(); i++) {
+			writeResult(cout, results[i], UNIFORM, policies[0], scalingSize, first);
+			first = false;
+		}
+		cout.flush();
+		if(threads == maxThreads) {
+			break;
+		}
+	}
+	cout << "\n  ]\n}" << endl;
+	return(0);
+}
\ No newline at end of file
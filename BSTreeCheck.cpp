@@ -0,0 +1,961 @@
+// BSTreeCheck.cpp		Author: Sam Hoover
+// contains a correctness check for the trees in this directory. Each check
+// runs a seeded stream of operations on a tree and on a std::map of key
+// counts that models it, and stops at the first difference. Build and run
+// with:
+//
+//		g++ -std=c++11 -O2 -pthread -o bstree_check BSTreeCheck.cpp
+//			MemoryPool.cpp OutputBuffer.cpp MappedFile.cpp SnapshotHeader.cpp
+//			RcuReaders.cpp DenseCharTree.cpp
+//		./bstree_check
+//
+// The containers shared between threads are also given a threaded run, in
+// which each thread writes its own keys and all of them add to a few shared
+// ones; it is a smoke test, best run under ThreadSanitizer or
+// AddressSanitizer. One line is printed per check. The exit status is 1 if any check failed,
+// else 0.
+//
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "BSTree.h"
+#include "BTree.h"
+#include "ConcurrentBSTree.h"
+#include "DenseCharTree.h"
+#include "RcuBSTree.h"
+#include "ShardedBSTree.h"
+using namespace std;
+
+// CHECK_OPERATIONS
+// the number of random operations each check makes
+//
+const int CHECK_OPERATIONS = 20000;
+
+// CHECK_KEY_RANGE
+// keys are drawn from 0 .. CHECK_KEY_RANGE - 1, so that inserts, repeated
+// inserts and removes of present keys are all common
+//
+const int CHECK_KEY_RANGE = 2000;
+
+// CHECK_COMPARE_EVERY
+// how many operations pass between full comparisons of tree and model
+//
+const int CHECK_COMPARE_EVERY = 500;
+
+// CHECK_FOREST_SIZE
+// the number of trees the node handle check moves nodes between
+//
+const int CHECK_FOREST_SIZE = 3;
+
+// CHECK_VECTOR_TREES
+// the number of trees the move check grows a vector to, one at a time
+//
+const int CHECK_VECTOR_TREES = 64;
+
+// CHECK_SET_ROUNDS, CHECK_SET_SIZE
+// the number of set operations the set check makes, and the most keys
+// either tree holds before each
+//
+const int CHECK_SET_ROUNDS = 400;
+const int CHECK_SET_SIZE = 300;
+
+// CHECK_BATCH_ROUNDS, CHECK_BATCH_SIZE
+// the number of insertBatch calls the batch check makes, and the most keys
+// in each; batches past BATCH_PARALLEL_GRAIN are merged on several threads
+//
+const int CHECK_BATCH_ROUNDS = 200;
+const int CHECK_BATCH_SIZE = 20000;
+
+// CHECK_DELTA_ROUNDS, CHECK_DELTA_CHANGES
+// the number of diff and applyDelta pairs the delta check makes, and the
+// most changes made to the target tree before each
+//
+const int CHECK_DELTA_ROUNDS = 400;
+const int CHECK_DELTA_CHANGES = 50;
+
+// CHECK_SHARD_COUNT
+// the number of shards of the ShardedBSTree checked
+//
+const int CHECK_SHARD_COUNT = 4;
+
+// CHECK_THREADS, CHECK_THREAD_OPERATIONS, CHECK_SHARED_KEYS
+// the number of threads in a threaded run, the operations each makes, and
+// the number of keys every thread adds to; every tenth operation of a
+// thread adds to a shared key
+//
+const int CHECK_THREADS = 4;
+const int CHECK_THREAD_OPERATIONS = 20000;
+const int CHECK_SHARED_KEYS = 100;
+
+// CHECK_SNAPSHOT_PATH
+// the file the snapshot check writes and reads back, removed afterwards
+//
+const char CHECK_SNAPSHOT_PATH[] = "bstree_check.snapshot";
+
+// CheckTree, Model
+// the tree type checked and the std::map of key counts it is checked against
+//
+typedef BasicBSTree<int> CheckTree;
+typedef map<int, int> Model;
+
+// expectedText
+// preconditions:	none
+// postconditions:	the text operator<< should print for a tree holding the
+//					keys and counts of model is returned
+//
+template<typename Key>
+static string expectedText(const map<Key, int> &model) {
+	ostringstream text;
+	for(typename map<Key, int>::const_iterator it = model.begin(); it != model.end(); ++it) {
+		text << it->first << " " << it->second << '\n';
+	}
+	return(text.str());
+}
+
+// textOf
+// preconditions:	Tree has an operator<<
+// postconditions:	the text operator<< prints for tree is returned
+//
+template<typename Tree>
+static string textOf(const Tree &tree) {
+	ostringstream text;
+	text << tree;
+	return(text.str());
+}
+
+// matchesModel
+// Compares every key and count of tree, through operator<<, write() and its
+// iterators, with model.
+// preconditions:	none
+// postconditions:	true is returned if tree holds exactly model
+//
+static bool matchesModel(const CheckTree &tree, const Model &model) {
+	string expected = expectedText(model);
+	ostringstream written;
+	if(textOf(tree) != expected || !tree.write(written) || written.str() != expected) {
+		return(false);
+	}
+	if(tree.size() != static_cast<int>(model.size())) {
+		return(false);
+	}
+	Model::const_iterator it = model.begin();
+	for(CheckTree::const_iterator node = tree.begin(); node != tree.end(); ++node, ++it) {
+		if(it == model.end() || *node != it->first || node.getCount() != it->second) {
+			return(false);
+		}
+	}
+	return(it == model.end());
+}
+
+// withinAvlHeight
+// An AVL tree of n nodes is less than 1.4405 log2(n + 2) - 0.3277 nodes
+// high; a tree that breaks the balance rule may still pass for a while, but
+// not for long under the operations the checks make.
+// preconditions:	maxDepth is -1 for an empty tree.
+// postconditions:	true is returned if a tree of size nodes whose deepest
+//					node is at maxDepth is within the AVL height bound
+//
+static bool withinAvlHeight(int maxDepth, int size) {
+	return(maxDepth + 1 < 1.4405 * log2(size + 2.0) - 0.3277);
+}
+
+// hasAvlHeight
+// preconditions:	none
+// postconditions:	true is returned if tree is within the AVL height bound
+//
+static bool hasAvlHeight(const CheckTree &tree) {
+	return(withinAvlHeight(tree.stats().m_maxDepth, tree.size()));
+}
+
+// report
+// preconditions:	none
+// postconditions:	the outcome of the check named name is printed; failed
+//					is returned
+//
+static bool report(const char *name, bool failed, int operation) {
+	if(failed) {
+		cout << "FAIL " << name << " at operation " << operation << endl;
+	} else {
+		cout << "ok   " << name << endl;
+	}
+	return(failed);
+}
+
+// checkTree
+// Inserts, removes and looks up random keys, checking every return value
+// against the model and the whole tree every CHECK_COMPARE_EVERY steps,
+// together with rank, select, a copy and, for AVL, the height.
+// preconditions:	none
+// postconditions:	true is returned if the check failed
+//
+static bool checkTree(BalancePolicy policy, mt19937 &random) {
+	CheckTree tree(policy);
+	Model model;
+	for(int i = 1; i <= CHECK_OPERATIONS; i++) {
+		int key = static_cast<int>(random() % CHECK_KEY_RANGE);
+		bool present = model.count(key) > 0;
+		bool ok = true;
+		switch(random() % 3) {
+		case 0:
+			ok = tree.emplace(key) == !present;
+			model[key]++;
+			break;
+		case 1:
+			ok = tree.remove(key) == present;
+			if(present && --model[key] == 0) {
+				model.erase(key);
+			}
+			break;
+		default:
+			ok = (tree.retrieve(key) != nullptr) == present && (tree.depth(key) >= 0) == present;
+			break;
+		}
+		if(!ok) {
+			return(report(policy == AVL ? "BSTree avl" : "BSTree unbalanced", true, i));
+		}
+		if(i % CHECK_COMPARE_EVERY == 0) {
+			int rank = 0;
+			for(Model::const_iterator it = model.begin(); it != model.end() && ok; ++it, ++rank) {
+				const int *selected = tree.select(rank);
+				ok = tree.rank(it->first) == rank && selected != nullptr && *selected == it->first;
+			}
+			CheckTree copy(tree);
+			if(!ok || !matchesModel(tree, model) || !(copy == tree) || !matchesModel(copy, model) ||
+					(policy == AVL && !hasAvlHeight(tree))) {
+				return(report(policy == AVL ? "BSTree avl" : "BSTree unbalanced", true, i));
+			}
+		}
+	}
+	return(report(policy == AVL ? "BSTree avl" : "BSTree unbalanced", false, 0));
+}
+
+// checkBTree
+// Runs the operations of checkTree on a BasicBTree.
+// preconditions:	none
+// postconditions:	true is returned if the check failed
+//
+static bool checkBTree(mt19937 &random) {
+	BasicBTree<int> tree;
+	Model model;
+	for(int i = 1; i <= CHECK_OPERATIONS; i++) {
+		int key = static_cast<int>(random() % CHECK_KEY_RANGE);
+		bool present = model.count(key) > 0;
+		bool ok = true;
+		switch(random() % 3) {
+		case 0:
+			ok = tree.emplace(key) == !present;
+			model[key]++;
+			break;
+		case 1:
+			ok = tree.remove(key) == present;
+			if(present && --model[key] == 0) {
+				model.erase(key);
+			}
+			break;
+		default:
+			ok = (tree.retrieve(key) != nullptr) == present && (tree.depth(key) >= 0) == present;
+			break;
+		}
+		if(ok && i % CHECK_COMPARE_EVERY == 0) {
+			BasicBTree<int> copy(tree);
+			ok = tree.size() == static_cast<int>(model.size()) && textOf(tree) == expectedText(model) &&
+					textOf(copy) == expectedText(model);
+		}
+		if(!ok) {
+			return(report("BTree", true, i));
+		}
+	}
+	return(report("BTree", false, 0));
+}
+
+// checkFrozenIndex
+// Freezes a random tree and compares the lookups, ranks and iteration of
+// the index with the model, including keys that are not present.
+// preconditions:	none
+// postconditions:	true is returned if the check failed
+//
+static bool checkFrozenIndex(mt19937 &random) {
+	CheckTree tree(AVL);
+	Model model;
+	for(int i = 0; i < CHECK_OPERATIONS; i++) {
+		int key = static_cast<int>(random() % CHECK_KEY_RANGE);
+		tree.emplace(key);
+		model[key]++;
+	}
+	BasicFrozenIndex<int, less<int> > index = tree.freeze();
+	bool ok = index.size() == static_cast<int>(model.size());
+	Model::const_iterator it = model.begin();
+	for(BasicFrozenIndex<int, less<int> >::const_iterator entry = index.begin(); ok && entry != index.end(); ++entry, ++it) {
+		ok = it != model.end() && *entry == it->first && entry.getCount() == it->second;
+	}
+	ok = ok && it == model.end();
+	int rank = 0;
+	int deepest = 0;
+	while((2 << deepest) <= index.size()) {
+		deepest++;
+	}
+	for(int key = -1; ok && key <= CHECK_KEY_RANGE; key++) {
+		bool present = model.count(key) > 0;
+		int depth = index.depth(key);
+		ok = (index.retrieve(key) != nullptr) == present && index.rank(key) == rank &&
+				(present ? depth >= 0 && depth <= deepest : depth == VALUE_NOT_FOUND);
+		rank += present ? 1 : 0;
+	}
+	return(report("FrozenIndex", !ok, 0));
+}
+
+// checkSnapshot
+// Saves a random tree, loads it into another tree and checks that the two
+// are equal in keys, counts and shape, then that trees of another key type
+// or Compare refuse the snapshot.
+// preconditions:	the current directory is writable
+// postconditions:	true is returned if the check failed
+//
+static bool checkSnapshot(mt19937 &random) {
+	CheckTree tree(AVL);
+	Model model;
+	for(int i = 0; i < CHECK_OPERATIONS; i++) {
+		int key = static_cast<int>(random() % CHECK_KEY_RANGE);
+		if(random() % 4 == 0) {
+			if(tree.remove(key) && --model[key] == 0) {
+				model.erase(key);
+			}
+		} else {
+			tree.emplace(key);
+			model[key]++;
+		}
+	}
+	CheckTree loaded;
+	bool ok = tree.saveSnapshot(CHECK_SNAPSHOT_PATH) && loaded.loadSnapshot(CHECK_SNAPSHOT_PATH);
+	ok = ok && loaded == tree && loaded.getPolicy() == AVL && matchesModel(loaded, model);
+
+	// a snapshot of ints is refused by a tree of another key type of the
+	// same size, and by a tree ordering ints the other way; either tree is
+	// left as it was
+	BasicBSTree<float> floats;
+	floats.emplace(1.5f);
+	BasicBSTree<int, greater<int> > descending;
+	descending.emplace(1);
+	ok = ok && !floats.loadSnapshot(CHECK_SNAPSHOT_PATH) && floats.size() == 1 && floats.retrieve(1.5f) != nullptr;
+	ok = ok && (tree.size() < 2 || !descending.loadSnapshot(CHECK_SNAPSHOT_PATH));
+	ok = ok && descending.size() == 1 && descending.retrieve(1) != nullptr;
+	remove(CHECK_SNAPSHOT_PATH);
+	return(report("snapshot round trip", !ok, 0));
+}
+
+// checkNodeHandles
+// Moves nodes between trees with extract and insert while the trees are
+// emptied, destroyed and rebuilt, so nodes outlive the trees whose pools
+// they were carved from. Run under AddressSanitizer to catch a node freed
+// into the wrong pool.
+// preconditions:	none
+// postconditions:	true is returned if the check failed
+//
+static bool checkNodeHandles(mt19937 &random) {
+	// a node passed through two trees that are then destroyed
+	CheckTree *first = new CheckTree(AVL);
+	for(int key = 0; key < 10; key++) {
+		first->emplace(key);
+	}
+	CheckTree *second = new CheckTree(AVL);
+	second->insert(first->extract(5));
+	delete first;
+	CheckTree third(AVL);
+	third.insert(second->extract(5));
+	delete second;
+	if(third.retrieve(5) == nullptr || third.size() != 1) {
+		return(report("node handles", true, 0));
+	}
+
+	CheckTree *forest[CHECK_FOREST_SIZE];
+	Model models[CHECK_FOREST_SIZE];
+	for(int i = 0; i < CHECK_FOREST_SIZE; i++) {
+		forest[i] = new CheckTree(AVL);
+	}
+	bool ok = true;
+	int i = 1;
+	for(; ok && i <= CHECK_OPERATIONS; i++) {
+		int from = static_cast<int>(random() % CHECK_FOREST_SIZE);
+		int to = static_cast<int>(random() % CHECK_FOREST_SIZE);
+		int key = static_cast<int>(random() % CHECK_KEY_RANGE);
+		bool present = models[from].count(key) > 0;
+		switch(random() % 5) {
+		case 0:
+			forest[from]->emplace(key);
+			models[from][key]++;
+			break;
+		case 1: {
+			CheckTree::NodeHandle handle = forest[from]->extract(key);
+			ok = handle.isEmpty() != present && (!present || handle.getCount() == models[from][key]);
+			if(present) {
+				int count = models[from][key];
+				models[from].erase(key);
+				models[to][key] += count;
+			}
+			forest[to]->insert(std::move(handle));
+			break;
+		}
+		case 2:
+			ok = forest[from]->remove(key) == present;
+			if(present && --models[from][key] == 0) {
+				models[from].erase(key);
+			}
+			break;
+		case 3:
+			// a handle dropped without being inserted frees its node
+			forest[from]->extract(key);
+			models[from].erase(key);
+			break;
+		default:
+			if(random() % 100 == 0) {
+				delete forest[from];
+				forest[from] = new CheckTree(AVL);
+				models[from].clear();
+			} else if(random() % 100 == 0) {
+				forest[from]->makeEmpty();
+				models[from].clear();
+			}
+			break;
+		}
+		for(int tree = 0; ok && i % CHECK_COMPARE_EVERY == 0 && tree < CHECK_FOREST_SIZE; tree++) {
+			ok = matchesModel(*forest[tree], models[tree]);
+		}
+	}
+	for(int tree = 0; tree < CHECK_FOREST_SIZE; tree++) {
+		delete forest[tree];
+	}
+	return(report("node handles", !ok, ok ? 0 : i - 1));
+}
+
+// insertMedianFirst: checkSetOperations helper
+// Inserts low .. high so that an UNBALANCED tree comes out balanced.
+// preconditions:	none
+// postconditions:	every key from low to high is added to tree and model
+//
+static void insertMedianFirst(CheckTree &tree, Model &model, int low, int high) {
+	vector<pair<int, int> > ranges(1, make_pair(low, high));
+	while(!ranges.empty()) {
+		pair<int, int> range = ranges.back();
+		ranges.pop_back();
+		if(range.first > range.second) {
+			continue;
+		}
+		int middle = range.first + (range.second - range.first) / 2;
+		tree.emplace(middle);
+		model[middle]++;
+		ranges.push_back(make_pair(range.first, middle - 1));
+		ranges.push_back(make_pair(middle + 1, range.second));
+	}
+}
+
+// fillSetTree: checkSetOperations helper
+// Fills tree in one of three shapes: random keys, a sorted run (a chain
+// when UNBALANCED), or a balanced block with a short chain hanging off it,
+// which is deep for its size yet under the depth at which set operations
+// rebuild their argument anyway.
+// preconditions:	tree and model are empty
+// postconditions:	tree and model hold the same keys and counts
+//
+static void fillSetTree(CheckTree &tree, Model &model, mt19937 &random) {
+	int count = static_cast<int>(random() % CHECK_SET_SIZE);
+	int first = static_cast<int>(random() % CHECK_KEY_RANGE);
+	switch(random() % 3) {
+	case 0:
+		for(int i = 0; i < count; i++) {
+			int key = static_cast<int>(random() % CHECK_KEY_RANGE);
+			tree.emplace(key);
+			model[key]++;
+		}
+		break;
+	case 1:
+		for(int key = first; key < first + count; key++) {
+			tree.emplace(key);
+			model[key]++;
+		}
+		break;
+	default:
+		insertMedianFirst(tree, model, first, first + count);
+		for(int key = first + count + 1; key < first + count + 10; key++) {
+			tree.emplace(key);
+			model[key]++;
+		}
+		break;
+	}
+}
+
+// combineCounts: checkSetOperations helper
+// preconditions:	none
+// postconditions:	the count policy gives a key held with counts mine and
+//					theirs is returned
+//
+static int combineCounts(int mine, int theirs, CountPolicy policy) {
+	switch(policy) {
+	case COUNT_MIN:
+		return(min(mine, theirs));
+	case COUNT_MAX:
+		return(max(mine, theirs));
+	case COUNT_SUBTRACT:
+		return(mine - theirs);
+	default:
+		return(mine + theirs);
+	}
+}
+
+// checkSetOperations
+// Applies unionWith, intersectWith and differenceWith between trees of
+// every pair of policies, shapes and count policies, and checks the result
+// against the model, the argument for being unchanged, and an AVL result
+// for its height.
+// preconditions:	none
+// postconditions:	true is returned if the check failed
+//
+static bool checkSetOperations(mt19937 &random) {
+	for(int round = 1; round <= CHECK_SET_ROUNDS; round++) {
+		CheckTree tree(random() % 2 == 0 ? AVL : UNBALANCED);
+		CheckTree other(random() % 2 == 0 ? AVL : UNBALANCED);
+		Model model;
+		Model otherModel;
+		fillSetTree(tree, model, random);
+		fillSetTree(other, otherModel, random);
+		CountPolicy policy = static_cast<CountPolicy>(random() % 4);
+		Model expected;
+		switch(random() % 3) {
+		case 0:
+			tree.unionWith(other, policy);
+			expected = model;
+			for(Model::const_iterator it = otherModel.begin(); it != otherModel.end(); ++it) {
+				expected[it->first] = model.count(it->first) > 0 ?
+						combineCounts(model[it->first], it->second, policy) : it->second;
+			}
+			break;
+		case 1:
+			tree.intersectWith(other, policy);
+			for(Model::const_iterator it = model.begin(); it != model.end(); ++it) {
+				if(otherModel.count(it->first) > 0) {
+					expected[it->first] = combineCounts(it->second, otherModel[it->first], policy);
+				}
+			}
+			break;
+		default:
+			tree.differenceWith(other, policy);
+			expected = model;
+			for(Model::const_iterator it = model.begin(); it != model.end(); ++it) {
+				if(otherModel.count(it->first) > 0) {
+					expected[it->first] = combineCounts(it->second, otherModel[it->first], policy);
+				}
+			}
+			break;
+		}
+		for(Model::iterator it = expected.begin(); it != expected.end();) {
+			if(it->second < MIN_ITEM_COUNT) {
+				expected.erase(it++);
+			} else {
+				++it;
+			}
+		}
+		if(!matchesModel(tree, expected) || !matchesModel(other, otherModel) ||
+				(tree.getPolicy() == AVL && !hasAvlHeight(tree))) {
+			return(report("set operations", true, round));
+		}
+	}
+	return(report("set operations", false, 0));
+}
+
+// checkMoves
+// Grows a vector of trees one at a time. The move constructor must be
+// noexcept, or the vector copies every node of every tree when it
+// reallocates; the keys found by retrieve would then move. A tree left empty
+// by a move must still work.
+// preconditions:	none
+// postconditions:	true is returned if the check failed
+//
+static bool checkMoves(mt19937 &random) {
+	static_assert(is_nothrow_move_constructible<CheckTree>::value,
+			"moving a BasicBSTree must not throw, or vectors of trees copy them");
+	static_assert(is_nothrow_move_assignable<CheckTree>::value,
+			"move assigning a BasicBSTree must not throw");
+	vector<CheckTree> trees;
+	vector<const int*> first;
+	for(int i = 0; i < CHECK_VECTOR_TREES; i++) {
+		trees.emplace_back(AVL);
+		for(int key = 0; key < 100; key++) {
+			trees.back().emplace(static_cast<int>(random() % CHECK_KEY_RANGE));
+		}
+		first.push_back(&*trees.back().begin());
+	}
+	bool ok = true;
+	for(int i = 0; ok && i < CHECK_VECTOR_TREES; i++) {
+		ok = &*trees[i].begin() == first[i];
+	}
+
+	CheckTree moved(std::move(trees[0]));
+	Model model;
+	model[5] = 1;
+	ok = ok && trees[0].isEmpty() && trees[0].emplace(5) && matchesModel(trees[0], model);
+	trees[1] = std::move(trees[0]);
+	ok = ok && matchesModel(trees[1], model) && trees[0].isEmpty();
+	trees[0].insert(moved.extract(*moved.begin()));
+	ok = ok && trees[0].size() == 1;
+	return(report("moves", !ok, 0));
+}
+
+// checkInsertBatch
+// Merges random, sorted and duplicate-heavy batches into trees of both
+// policies that already hold keys, and checks the counts insertBatch
+// returns, the tree against the model, and an AVL tree for its height.
+// preconditions:	none
+// postconditions:	true is returned if the check failed
+//
+static bool checkInsertBatch(mt19937 &random) {
+	for(int round = 1; round <= CHECK_BATCH_ROUNDS; round++) {
+		CheckTree tree(random() % 2 == 0 ? AVL : UNBALANCED);
+		Model model;
+		int count = static_cast<int>(random() % CHECK_SET_SIZE);
+		for(int i = 0; i < count; i++) {
+			int key = static_cast<int>(random() % CHECK_KEY_RANGE);
+			tree.emplace(key);
+			model[key]++;
+		}
+		vector<int> batch(random() % CHECK_BATCH_SIZE);
+		int first = static_cast<int>(random() % CHECK_KEY_RANGE);
+		int kind = static_cast<int>(random() % 3);
+		for(size_t i = 0; i < batch.size(); i++) {
+			if(kind == 0) {
+				batch[i] = static_cast<int>(random() % (CHECK_BATCH_SIZE * 2));
+			} else if(kind == 1) {
+				batch[i] = first + static_cast<int>(i);
+			} else {
+				batch[i] = first + static_cast<int>(random() % 10);
+			}
+		}
+		InsertBatchResult expected = { 0, 0 };
+		for(size_t i = 0; i < batch.size(); i++) {
+			if(model[batch[i]]++ == 0) {
+				expected.m_created++;
+			} else {
+				expected.m_incremented++;
+			}
+		}
+		InsertBatchResult result = tree.insertBatch(batch.begin(), batch.end());
+		if(result.m_created != expected.m_created || result.m_incremented != expected.m_incremented ||
+				!matchesModel(tree, model) || (tree.getPolicy() == AVL && !hasAvlHeight(tree))) {
+			return(report("insertBatch", true, round));
+		}
+	}
+	return(report("insertBatch", false, 0));
+}
+
+// checkDelta
+// Takes the diff from a random tree to a copy with a few changes (or, every
+// fourth round, to the same copy rebuilt into another shape), checks every
+// entry against the two models, applies it, and checks that the delta is
+// then refused as it no longer fits.
+// preconditions:	none
+// postconditions:	true is returned if the check failed
+//
+static bool checkDelta(mt19937 &random) {
+	for(int round = 1; round <= CHECK_DELTA_ROUNDS; round++) {
+		CheckTree tree(random() % 2 == 0 ? AVL : UNBALANCED);
+		Model model;
+		fillSetTree(tree, model, random);
+		CheckTree target(tree);
+		Model targetModel(model);
+		int changes = static_cast<int>(random() % CHECK_DELTA_CHANGES);
+		for(int i = 0; i < changes; i++) {
+			int key = static_cast<int>(random() % CHECK_KEY_RANGE);
+			if(random() % 2 == 0) {
+				target.emplace(key);
+				targetModel[key]++;
+			} else if(target.remove(key) && --targetModel[key] == 0) {
+				targetModel.erase(key);
+			}
+		}
+		if(random() % 4 == 0) {
+			target.rebuild();
+		}
+
+		// every key counted in either model but not alike in both needs an entry
+		vector<CheckTree::DeltaEntry> delta = tree.diff(target);
+		Model differing;
+		for(Model::const_iterator it = model.begin(); it != model.end(); ++it) {
+			differing[it->first] = 0;
+		}
+		for(Model::const_iterator it = targetModel.begin(); it != targetModel.end(); ++it) {
+			differing[it->first] = 0;
+		}
+		for(Model::iterator it = differing.begin(); it != differing.end();) {
+			int mine = model.count(it->first) > 0 ? model[it->first] : 0;
+			int theirs = targetModel.count(it->first) > 0 ? targetModel[it->first] : 0;
+			if(mine == theirs) {
+				differing.erase(it++);
+			} else {
+				it->second = theirs;
+				++it;
+			}
+		}
+		bool ok = delta.size() == differing.size();
+		bool structural = false;
+		Model::const_iterator expected = differing.begin();
+		for(size_t i = 0; ok && i < delta.size(); i++, ++expected) {
+			DeltaKind kind = model.count(expected->first) == 0 ? DELTA_INSERT :
+					(expected->second == 0 ? DELTA_REMOVE : DELTA_COUNT);
+			ok = delta[i].m_key == expected->first && delta[i].m_kind == kind && delta[i].m_count == expected->second;
+			structural = structural || kind != DELTA_COUNT;
+		}
+		ok = ok && tree.applyDelta(delta) && matchesModel(tree, targetModel) && matchesModel(target, targetModel);
+		ok = ok && (!structural || !tree.applyDelta(delta)) && matchesModel(tree, targetModel);
+		ok = ok && (tree.getPolicy() != AVL || hasAvlHeight(tree));
+		if(!ok) {
+			return(report("diff and applyDelta", true, round));
+		}
+	}
+	return(report("diff and applyDelta", false, 0));
+}
+
+// runPointOperations: container check helper
+// Runs the insert, remove and retrieve stream of checkTree on any container
+// with those operations and operator<<, checking every return value and the
+// whole container every CHECK_COMPARE_EVERY steps against model.
+// preconditions:	tree holds exactly model; keyRange > 0
+// postconditions:	0 is returned if every step matched, else the number of
+//					the first step that did not. tree and model hold the
+//					same keys and counts up to that step.
+//
+template<typename Key, typename Tree>
+static int runPointOperations(Tree &tree, map<Key, int> &model, int keyRange, mt19937 &random) {
+	for(int i = 1; i <= CHECK_OPERATIONS; i++) {
+		Key key = static_cast<Key>(random() % keyRange);
+		bool present = model.count(key) > 0;
+		bool ok = true;
+		switch(random() % 3) {
+		case 0:
+			ok = tree.emplace(key) == !present;
+			model[key]++;
+			break;
+		case 1:
+			ok = tree.remove(key) == present;
+			if(present && --model[key] == 0) {
+				model.erase(key);
+			}
+			break;
+		default:
+			ok = (tree.retrieve(key) != nullptr) == present;
+			break;
+		}
+		if(!ok || (i % CHECK_COMPARE_EVERY == 0 && (textOf(tree) != expectedText(model) ||
+				tree.isEmpty() != model.empty()))) {
+			return(i);
+		}
+	}
+	return(0);
+}
+
+// runThreadedWrites: container check helper
+// Runs CHECK_THREADS threads at once on tree. Each inserts and removes keys
+// of its own range, checking every return value against a model of its
+// own, and every tenth operation adds to one of CHECK_SHARED_KEYS keys that
+// all threads add to, so the shared counts must come out as the sum of
+// every thread's.
+// preconditions:	tree is empty and may be written by many threads at once
+// postconditions:	true is returned if every return value matched and tree
+//					holds the keys and counts of the models together
+//
+template<typename Tree>
+static bool runThreadedWrites(Tree &tree, mt19937 &random) {
+	vector<Model> models(CHECK_THREADS);
+	vector<unsigned> seeds(CHECK_THREADS);
+	for(int t = 0; t < CHECK_THREADS; t++) {
+		seeds[t] = static_cast<unsigned>(random());
+	}
+	atomic<bool> failed(false);
+	vector<thread> workers;
+	for(int t = 0; t < CHECK_THREADS; t++) {
+		workers.push_back(thread([&, t]() {
+			mt19937 local(seeds[t]);
+			Model &model = models[t];
+			for(int i = 0; i < CHECK_THREAD_OPERATIONS; i++) {
+				if(i % 10 == 0) {
+					int shared = static_cast<int>(local() % CHECK_SHARED_KEYS);
+					tree.emplace(shared);
+					model[shared]++;
+					continue;
+				}
+				int key = CHECK_SHARED_KEYS + t * CHECK_KEY_RANGE + static_cast<int>(local() % CHECK_KEY_RANGE);
+				bool present = model.count(key) > 0;
+				bool ok = true;
+				switch(local() % 3) {
+				case 0:
+					ok = tree.emplace(key) == !present;
+					model[key]++;
+					break;
+				case 1:
+					ok = tree.remove(key) == present;
+					if(present && --model[key] == 0) {
+						model.erase(key);
+					}
+					break;
+				default:
+					ok = (tree.retrieve(key) != nullptr) == present;
+					break;
+				}
+				if(!ok) {
+					failed = true;
+				}
+			}
+		}));
+	}
+	for(int t = 0; t < CHECK_THREADS; t++) {
+		workers[t].join();
+	}
+	Model expected;
+	for(int t = 0; t < CHECK_THREADS; t++) {
+		for(Model::const_iterator it = models[t].begin(); it != models[t].end(); ++it) {
+			expected[it->first] += it->second;
+		}
+	}
+	return(!failed && textOf(tree) == expectedText(expected));
+}
+
+// checkConcurrentTree
+// Model checks a ConcurrentBSTree from one thread, then gives a second one
+// a threaded run.
+// preconditions:	none
+// postconditions:	true is returned if either check failed
+//
+static bool checkConcurrentTree(mt19937 &random) {
+	BasicConcurrentBSTree<int> tree;
+	Model model;
+	int failedAt = runPointOperations(tree, model, CHECK_KEY_RANGE, random);
+	if(failedAt == 0 && tree.size() != static_cast<int>(model.size())) {
+		failedAt = CHECK_OPERATIONS;
+	}
+	bool failed = report("ConcurrentBSTree", failedAt != 0, failedAt);
+	BasicConcurrentBSTree<int> shared;
+	return(report("ConcurrentBSTree threaded", !runThreadedWrites(shared, random), 0) || failed);
+}
+
+// checkRcuTree
+// Model checks an RcuBSTree of policy from one thread, measuring the depth
+// of every key afterwards for the AVL height.
+// preconditions:	none
+// postconditions:	true is returned if the check failed
+//
+static bool checkRcuTree(BalancePolicy policy, mt19937 &random) {
+	const char *name = policy == AVL ? "RcuBSTree avl" : "RcuBSTree unbalanced";
+	BasicRcuBSTree<int> tree(policy);
+	Model model;
+	int failedAt = runPointOperations(tree, model, CHECK_KEY_RANGE, random);
+	int maxDepth = -1;
+	for(Model::const_iterator it = model.begin(); it != model.end(); ++it) {
+		maxDepth = max(maxDepth, tree.depth(it->first));
+	}
+	if(failedAt == 0 && policy == AVL && !withinAvlHeight(maxDepth, static_cast<int>(model.size()))) {
+		failedAt = CHECK_OPERATIONS;
+	}
+	tree.synchronize();
+	return(report(name, failedAt != 0, failedAt));
+}
+
+// checkRcuThreaded
+// Gives an RcuBSTree a threaded run; its writers take turns, but readers
+// walk published versions while they do.
+// preconditions:	none
+// postconditions:	true is returned if the check failed
+//
+static bool checkRcuThreaded(mt19937 &random) {
+	BasicRcuBSTree<int> tree(AVL);
+	return(report("RcuBSTree threaded", !runThreadedWrites(tree, random), 0));
+}
+
+// checkShardedTree
+// Model checks a ShardedBSTree with boundaries spread over the key range,
+// then compares its size, rank, select and iteration with the model before
+// and after rebalanceShards, and gives a second one a threaded run.
+// preconditions:	none
+// postconditions:	true is returned if either check failed
+//
+static bool checkShardedTree(mt19937 &random) {
+	vector<int> sample;
+	for(int key = 0; key < CHECK_KEY_RANGE; key += 10) {
+		sample.push_back(key);
+	}
+	BasicShardedBSTree<int> tree(sample.begin(), sample.end(), CHECK_SHARD_COUNT, AVL);
+	Model model;
+	int failedAt = runPointOperations(tree, model, CHECK_KEY_RANGE, random);
+	for(int pass = 0; failedAt == 0 && pass < 2; pass++) {
+		bool ok = tree.size() == static_cast<int>(model.size()) && textOf(tree) == expectedText(model);
+		int rank = 0;
+		BasicShardedBSTree<int>::const_iterator node = tree.begin();
+		for(Model::const_iterator it = model.begin(); ok && it != model.end(); ++it, ++rank, ++node) {
+			const int *selected = tree.select(rank);
+			ok = tree.rank(it->first) == rank && selected != nullptr && *selected == it->first &&
+					node != tree.end() && *node == it->first;
+		}
+		if(!ok || node != tree.end()) {
+			failedAt = CHECK_OPERATIONS;
+		}
+		tree.rebalanceShards();
+	}
+	bool failed = report("ShardedBSTree", failedAt != 0, failedAt);
+
+	// one shard per thread's own keys, with the shared keys in the first
+	vector<int> starts;
+	for(int t = 0; t < CHECK_THREADS; t++) {
+		starts.push_back(CHECK_SHARED_KEYS + t * CHECK_KEY_RANGE);
+	}
+	BasicShardedBSTree<int> shared(starts.begin(), starts.end(), CHECK_THREADS, AVL);
+	return(report("ShardedBSTree threaded", !runThreadedWrites(shared, random), 0) || failed);
+}
+
+// checkDenseCharTree
+// Model checks a DenseCharTree over every char value, and checks that a copy
+// is equal to it.
+// preconditions:	none
+// postconditions:	true is returned if the check failed
+//
+static bool checkDenseCharTree(mt19937 &random) {
+	DenseCharTree tree;
+	map<char, int> model;
+	int failedAt = runPointOperations(tree, model, DENSE_KEY_COUNT, random);
+	DenseCharTree copy(tree);
+	if(failedAt == 0 && (copy != tree || textOf(copy) != expectedText(model))) {
+		failedAt = CHECK_OPERATIONS;
+	}
+	return(report("DenseCharTree", failedAt != 0, failedAt));
+}
+
+// main
+// preconditions:	none
+// postconditions:	every check is run and its outcome printed. 1 is
+//					returned if any failed, else 0.
+//
+int main() {
+	mt19937 random(343);
+	bool failed = false;
+	failed = checkTree(AVL, random) || failed;
+	failed = checkTree(UNBALANCED, random) || failed;
+	failed = checkBTree(random) || failed;
+	failed = checkFrozenIndex(random) || failed;
+	failed = checkSnapshot(random) || failed;
+	failed = checkNodeHandles(random) || failed;
+	failed = checkMoves(random) || failed;
+	failed = checkSetOperations(random) || failed;
+	failed = checkInsertBatch(random) || failed;
+	failed = checkDelta(random) || failed;
+	failed = checkConcurrentTree(random) || failed;
+	failed = checkRcuTree(AVL, random) || failed;
+	failed = checkRcuTree(UNBALANCED, random) || failed;
+	failed = checkRcuThreaded(random) || failed;
+	failed = checkShardedTree(random) || failed;
+	failed = checkDenseCharTree(random) || failed;
+	return(failed ? 1 : 0);
+}
\ No newline at end of file
@@ -0,0 +1,756 @@
+// BTree.cpp		Author: Sam Hoover
+// contains the definitions for the BasicBTree class template. This file is
+// included at the bottom of BTree.h and needs no separate compilation
+//
+#ifndef BTREE_CPP
+#define BTREE_CPP
+#include "BTree.h"
+
+// BasicBTree::Node default constructor
+// preconditions:	none
+// postconditions:	Creates an empty leaf
+//
+template<typename Key, typename Compare>
+BasicBTree<Key, Compare>::Node::Node() : m_keyCount(0), m_size(0) {
+	for(int i = 0; i <= MAX_KEYS; i++) {
+		m_children[i] = nullptr;
+	}
+}
+
+// BasicBTree::Node keys
+// preconditions:	none
+// postconditions:	a pointer to the first key slot is returned
+//
+template<typename Key, typename Compare>
+Key* BasicBTree<Key, Compare>::Node::keys() {
+	return(reinterpret_cast<Key*>(m_slots));
+}
+
+template<typename Key, typename Compare>
+const Key* BasicBTree<Key, Compare>::Node::keys() const {
+	return(reinterpret_cast<const Key*>(m_slots));
+}
+
+// BasicBTree::Node isLeaf
+// preconditions:	none
+// postconditions:	true is returned if the node has no children
+//
+template<typename Key, typename Compare>
+bool BasicBTree<Key, Compare>::Node::isLeaf() const {
+	return(m_children[0] == nullptr);
+}
+
+// default constructor
+// preconditions:	none
+// postconditions:	Creates an empty tree (m_root equal to nullptr)
+//
+template<typename Key, typename Compare>
+BasicBTree<Key, Compare>::BasicBTree() : m_root(nullptr), m_pool(sizeof(Node)), m_compare() {}
+
+// copy constructor
+// preconditions:	tree must be a valid BTree object (must not reference a
+//					dereferenced nullptr)
+// postconditions:	this is a deep copy of tree, node for node
+//
+template<typename Key, typename Compare>
+BasicBTree<Key, Compare>::BasicBTree(const BasicBTree &tree) : m_root(nullptr), m_pool(sizeof(Node)),
+		m_compare(tree.m_compare) {
+	copyTree(tree);
+}
+
+// destructor
+// preconditions:	none
+// postconditions:	All nodes removed and deleted, m_root set to nullptr
+//
+template<typename Key, typename Compare>
+BasicBTree<Key, Compare>::~BasicBTree() {
+	makeEmpty();
+}
+
+// insert(const Key &data)
+// Inserts a copy of data into the tree. If the key already exists in the
+// tree, its count is incremented by one.
+// preconditions:	data must be a valid Key object (must not reference
+//					a dereferenced nullptr); this not equal to nullptr.
+// postconditions:	If data does not already exist in the tree, then a copy
+//					of data is inserted with a count of one and true is
+//					returned. If the data already exists, then its count is
+//					incremented by one and false is returned.
+//
+template<typename Key, typename Compare>
+bool BasicBTree<Key, Compare>::insert(const Key &data) {
+	return(add(Key(data)));
+}
+
+// insert(Key *data)
+// Deprecated: use insert(const Key&) or emplace. The key is copied out of
+// *data; the tree never takes ownership of data.
+// preconditions:	data must be a valid Key object not equal to nullptr;
+//					this not equal to nullptr.
+// postconditions:	the same as insert(*data); data is left to the caller.
+//
+template<typename Key, typename Compare>
+bool BasicBTree<Key, Compare>::insert(Key *data) {
+	return(insert(*data));
+}
+
+// emplace
+// Constructs a Key from args and inserts it into the tree, following the
+// same rules as insert.
+// preconditions:	args must be valid arguments to a Key constructor; this
+//					not equal to nullptr.
+// postconditions:	If the constructed key does not already exist in the
+//					tree, it is inserted and true is returned. Otherwise its
+//					count is incremented by one and false is returned.
+//
+template<typename Key, typename Compare>
+template<typename... Args>
+bool BasicBTree<Key, Compare>::emplace(Args&&... args) {
+	return(add(Key(std::forward<Args>(args)...)));
+}
+
+// remove
+// Removes a Key object equal to data from the tree. If its count is one,
+// the key itself is deleted from its node.
+// preconditions:	data must be a valid Key object (must not reference a
+//					dereferenced nullptr); this not equal to nullptr.
+// postconditions:	If data is not found, then false is returned. If data is
+//					found and its count > 1 then the count is decremented by
+//					one; if the count == 1 then the key is deleted from the
+//					tree. true is returned.
+//
+template<typename Key, typename Compare>
+bool BasicBTree<Key, Compare>::remove(const Key &data) {
+	int slot = 0;
+	Node *node = const_cast<Node*>(findKey(data, slot));
+	if(node == nullptr) {
+		return(false);
+	}
+	if(node->m_itemCounts[slot] > MIN_ITEM_COUNT) {
+		node->m_itemCounts[slot]--;
+	} else {
+		erase(data);
+	}
+	return(true);
+}
+
+// makeEmpty
+// Removes and deletes all keys and nodes from the tree, and set m_root
+// equal to nullptr. Keys that need no destructor are released with the
+// pool in O(chunks).
+// preconditions:	this not equal to nullptr.
+// postconditions:	All nodes removed and deleted, m_root set to nullptr
+//
+template<typename Key, typename Compare>
+void BasicBTree<Key, Compare>::makeEmpty() {
+	if(!is_trivially_destructible<Key>::value) {
+		vector<Node*> stack;
+		if(m_root != nullptr) {
+			stack.push_back(m_root);
+		}
+		while(!stack.empty()) {
+			Node *node = stack.back();
+			stack.pop_back();
+			if(!node->isLeaf()) {
+				for(int i = 0; i <= node->m_keyCount; i++) {
+					stack.push_back(node->m_children[i]);
+				}
+			}
+			freeNode(node);
+		}
+	}
+	m_root = nullptr;
+	m_pool.release();
+}
+
+// retrieve
+// Searches the tree for data, if found, a const pointer to that object is
+// returned.
+// preconditions:	data must be a valid Key object (must not reference a
+//					dereferenced nullptr); this not equal to nullptr.
+// postconditions:	If data is found, a const pointer to the key equal to
+//					data is returned; else nullptr is returned.
+//
+template<typename Key, typename Compare>
+const Key* BasicBTree<Key, Compare>::retrieve(const Key &data) const {
+	int slot = 0;
+	const Node *node = findKey(data, slot);
+	if(node == nullptr) {
+		return(nullptr);
+	}
+	return(&node->keys()[slot]);
+}
+
+// depth
+// Finds the depth of the node holding data. Depth of m_root is 0.
+// preconditions:	data must be a valid Key object (must not reference a
+//					dereferenced nullptr); this not equal to nullptr.
+// postconditions:	If data is found, the depth of its node is returned. If
+//					data is not found, -1 is returned.
+//
+template<typename Key, typename Compare>
+int BasicBTree<Key, Compare>::depth(const Key &data) const {
+	int slot = 0;
+	int dep = 0;
+	if(findKey(data, slot, &dep) == nullptr) {
+		return(VALUE_NOT_FOUND);
+	}
+	return(dep);
+}
+
+// descendants
+// Finds the number of keys below data: the keys in the two subtrees on
+// either side of it in its node, which hold every key between its
+// neighbours there. A key in a leaf has none. The count is read from the
+// subtrees' m_size, so the cost is that of finding the key.
+// preconditions:	data must be a valid Key object (must not reference a
+//					dereferenced nullptr); this not equal to nullptr.
+// postconditions:	If data is found, the number of keys below it is
+//					returned. If data is not found, -1 is returned.
+//
+template<typename Key, typename Compare>
+int BasicBTree<Key, Compare>::descendants(const Key &data) const {
+	int slot = 0;
+	const Node *node = findKey(data, slot);
+	if(node == nullptr) {
+		return(VALUE_NOT_FOUND);
+	}
+	return(subtreeSize(node->m_children[slot]) + subtreeSize(node->m_children[slot + 1]));
+}
+
+// size
+// Returns the number of distinct keys in the tree.
+// preconditions:	this not equal to nullptr.
+// postconditions:	m_root's m_size is returned, or 0 if the tree is empty
+//
+template<typename Key, typename Compare>
+int BasicBTree<Key, Compare>::size() const {
+	return(subtreeSize(m_root));
+}
+
+// isEmpty
+// Returns true is tree is empty, else false
+// preconditions:	this not equal to nullptr.
+// postconditions:	true is returned if m_root is equal to nullptr
+//
+template<typename Key, typename Compare>
+bool BasicBTree<Key, Compare>::isEmpty() const {
+	return(m_root == nullptr);
+}
+
+// write(ostream &sout)
+// Prints the contents of the tree to sout in the same format as
+// operator<<, building the text in large blocks.
+// preconditions:	this not equal to nullptr.
+// postconditions:	the contents of this are written to sout. false is
+//					returned if sout failed.
+//
+template<typename Key, typename Compare>
+bool BasicBTree<Key, Compare>::write(ostream &sout) const {
+	OutputBuffer out(sout);
+	write(out);
+	return(out.flush());
+}
+
+// write(int fd)
+// Prints the contents of the tree to the file descriptor fd in the same
+// format as operator<<, using large write calls.
+// preconditions:	fd must be open for writing; this not equal to nullptr.
+// postconditions:	the contents of this are written to fd. false is
+//					returned if a write failed.
+//
+template<typename Key, typename Compare>
+bool BasicBTree<Key, Compare>::write(int fd) const {
+	OutputBuffer out(fd);
+	write(out);
+	return(out.flush());
+}
+
+// assignment
+// Sets this equal to tree. Performs a deep copy.
+// preconditions:	tree must be a valid BTree object (must not reference a
+//					dereferenced nullptr)
+// postconditions:	this is a deep copy of tree; the old contents of this are
+//					deleted.
+//
+template<typename Key, typename Compare>
+const BasicBTree<Key, Compare>& BasicBTree<Key, Compare>::operator=(const BasicBTree &tree) {
+	if(this != &tree) {
+		makeEmpty();
+		m_compare = tree.m_compare;
+		copyTree(tree);
+	}
+	return(*this);
+}
+
+// add: insert helper
+// Makes data present in the tree, or increments its count. Splits every
+// full node on the way down, so the leaf reached always has room.
+// preconditions:	data must be a valid Key object.
+// postconditions:	true is returned if data was not present before.
+//
+template<typename Key, typename Compare>
+bool BasicBTree<Key, Compare>::add(Key &&data) {
+	if(m_root == nullptr) {
+		m_root = newNode();
+	} else if(m_root->m_keyCount == MAX_KEYS) {
+		Node *top = newNode();
+		top->m_children[0] = m_root;
+		top->m_size = m_root->m_size;
+		m_root = top;
+		splitChild(top, 0);
+	}
+
+	vector<Node*> path;
+	Node *node = m_root;
+	while(true) {
+		int slot = findSlot(node, data);
+		if(slot < node->m_keyCount && isEqual(data, node->keys()[slot])) {
+			node->m_itemCounts[slot]++;
+			return(false);
+		}
+		path.push_back(node);
+		if(node->isLeaf()) {
+			insertAt(node, slot, std::move(data), MIN_ITEM_COUNT, nullptr);
+			for(size_t i = 0; i < path.size(); i++) {
+				path[i]->m_size++;
+			}
+			return(true);
+		}
+		if(node->m_children[slot]->m_keyCount == MAX_KEYS) {
+			splitChild(node, slot);
+			// the median of the child now sits at slot
+			if(isEqual(data, node->keys()[slot])) {
+				node->m_itemCounts[slot]++;
+				return(false);
+			} else if(isLess(node->keys()[slot], data)) {
+				slot++;
+			}
+		}
+		node = node->m_children[slot];
+	}
+}
+
+// erase: remove helper
+// Deletes data from the tree in one pass from the root. Each child is given
+// at least DEGREE keys before it is entered, by borrowing from or merging
+// with a sibling, so deleting from the leaf at the bottom never leaves a
+// node with too few keys. A key in an internal node is overwritten by its
+// predecessor or successor, which is then deleted from below instead.
+// preconditions:	data must be in the tree.
+// postconditions:	data is no longer in the tree
+//
+template<typename Key, typename Compare>
+void BasicBTree<Key, Compare>::erase(const Key &data) {
+	Key target(data);
+	Node *node = m_root;
+	while(true) {
+		// every node entered holds target, so its subtree loses one key
+		node->m_size--;
+		int slot = findSlot(node, target);
+		bool found = slot < node->m_keyCount && isEqual(target, node->keys()[slot]);
+		if(found && node->isLeaf()) {
+			eraseAt(node, slot, slot + 1);
+			break;
+		}
+
+		Node *next;
+		if(found) {
+			Node *left = node->m_children[slot];
+			Node *right = node->m_children[slot + 1];
+			if(left->m_keyCount >= DEGREE) {
+				const Node *last = left;
+				while(!last->isLeaf()) {
+					last = last->m_children[last->m_keyCount];
+				}
+				node->keys()[slot] = last->keys()[last->m_keyCount - 1];
+				node->m_itemCounts[slot] = last->m_itemCounts[last->m_keyCount - 1];
+				target = node->keys()[slot];
+				next = left;
+			} else if(right->m_keyCount >= DEGREE) {
+				const Node *first = right;
+				while(!first->isLeaf()) {
+					first = first->m_children[0];
+				}
+				node->keys()[slot] = first->keys()[0];
+				node->m_itemCounts[slot] = first->m_itemCounts[0];
+				target = node->keys()[slot];
+				next = right;
+			} else {
+				mergeChildren(node, slot);
+				next = left;
+			}
+		} else {
+			if(node->m_children[slot]->m_keyCount < DEGREE) {
+				if(slot > 0 && node->m_children[slot - 1]->m_keyCount >= DEGREE) {
+					borrowFromLeft(node, slot);
+				} else if(slot < node->m_keyCount && node->m_children[slot + 1]->m_keyCount >= DEGREE) {
+					borrowFromRight(node, slot);
+				} else if(slot < node->m_keyCount) {
+					mergeChildren(node, slot);
+				} else {
+					slot--;
+					mergeChildren(node, slot);
+				}
+			}
+			next = node->m_children[slot];
+		}
+
+		// a root emptied by a merge gives way to its only child
+		if(node == m_root && node->m_keyCount == 0) {
+			m_root = next;
+			freeNode(node);
+		}
+		node = next;
+	}
+
+	if(m_root->m_keyCount == 0) {
+		freeNode(m_root);
+		m_root = nullptr;
+	}
+}
+
+// splitChild: insert helper
+// preconditions:	parent is not full; its child at slot is full.
+// postconditions:	the child at slot keeps its lower DEGREE - 1 keys, a new
+//					node right of it takes the upper DEGREE - 1 keys, and the
+//					median key moves up into parent at slot.
+//
+template<typename Key, typename Compare>
+void BasicBTree<Key, Compare>::splitChild(Node *parent, int slot) {
+	Node *full = parent->m_children[slot];
+	Node *right = newNode();
+	for(int i = 0; i < DEGREE - 1; i++) {
+		relocate(&right->keys()[i], &full->keys()[DEGREE + i]);
+		right->m_itemCounts[i] = full->m_itemCounts[DEGREE + i];
+	}
+	right->m_keyCount = DEGREE - 1;
+	right->m_size = DEGREE - 1;
+	if(!full->isLeaf()) {
+		for(int i = 0; i < DEGREE; i++) {
+			right->m_children[i] = full->m_children[DEGREE + i];
+			right->m_size += right->m_children[i]->m_size;
+			full->m_children[DEGREE + i] = nullptr;
+		}
+	}
+	full->m_keyCount = DEGREE - 1;
+	full->m_size -= right->m_size + 1;
+
+	Key *median = &full->keys()[DEGREE - 1];
+	insertAt(parent, slot, std::move(*median), full->m_itemCounts[DEGREE - 1], right);
+	median->~Key();
+}
+
+// mergeChildren: remove helper
+// preconditions:	the children at slot and slot + 1 of parent hold
+//					DEGREE - 1 keys each.
+// postconditions:	key slot of parent and every key of the child at
+//					slot + 1 are moved to the end of the child at slot, and
+//					the emptied child is freed.
+//
+template<typename Key, typename Compare>
+void BasicBTree<Key, Compare>::mergeChildren(Node *parent, int slot) {
+	Node *left = parent->m_children[slot];
+	Node *right = parent->m_children[slot + 1];
+	int count = left->m_keyCount;
+	new(&left->keys()[count]) Key(std::move(parent->keys()[slot]));
+	left->m_itemCounts[count] = parent->m_itemCounts[slot];
+	for(int i = 0; i < right->m_keyCount; i++) {
+		relocate(&left->keys()[count + 1 + i], &right->keys()[i]);
+		left->m_itemCounts[count + 1 + i] = right->m_itemCounts[i];
+	}
+	for(int i = 0; i <= right->m_keyCount; i++) {
+		left->m_children[count + 1 + i] = right->m_children[i];
+	}
+	left->m_keyCount += 1 + right->m_keyCount;
+	left->m_size += 1 + right->m_size;
+	right->m_keyCount = 0;
+	freeNode(right);
+	eraseAt(parent, slot, slot + 1);
+}
+
+// borrowFromLeft: remove helper
+// preconditions:	slot > 0; the child at slot - 1 holds DEGREE keys or
+//					more.
+// postconditions:	key slot - 1 of parent moves to the front of the child at
+//					slot, and the last key of its left sibling (with its last
+//					child) takes its place.
+//
+template<typename Key, typename Compare>
+void BasicBTree<Key, Compare>::borrowFromLeft(Node *parent, int slot) {
+	Node *child = parent->m_children[slot];
+	Node *sibling = parent->m_children[slot - 1];
+	int last = sibling->m_keyCount - 1;
+	Node *moved = sibling->m_children[last + 1];
+	insertAt(child, 0, std::move(parent->keys()[slot - 1]), parent->m_itemCounts[slot - 1], child->m_children[0]);
+	child->m_children[0] = moved;
+	parent->keys()[slot - 1] = std::move(sibling->keys()[last]);
+	parent->m_itemCounts[slot - 1] = sibling->m_itemCounts[last];
+	eraseAt(sibling, last, last + 1);
+	child->m_size += 1 + subtreeSize(moved);
+	sibling->m_size -= 1 + subtreeSize(moved);
+}
+
+// borrowFromRight: remove helper
+// preconditions:	slot < parent->m_keyCount; the child at slot + 1 holds
+//					DEGREE keys or more.
+// postconditions:	key slot of parent moves to the end of the child at slot,
+//					and the first key of its right sibling (with its first
+//					child) takes its place.
+//
+template<typename Key, typename Compare>
+void BasicBTree<Key, Compare>::borrowFromRight(Node *parent, int slot) {
+	Node *child = parent->m_children[slot];
+	Node *sibling = parent->m_children[slot + 1];
+	Node *moved = sibling->m_children[0];
+	insertAt(child, child->m_keyCount, std::move(parent->keys()[slot]), parent->m_itemCounts[slot], moved);
+	parent->keys()[slot] = std::move(sibling->keys()[0]);
+	parent->m_itemCounts[slot] = sibling->m_itemCounts[0];
+	eraseAt(sibling, 0, 0);
+	child->m_size += 1 + subtreeSize(moved);
+	sibling->m_size -= 1 + subtreeSize(moved);
+}
+
+// insertAt: node helper
+// preconditions:	node is not full; 0 <= slot <= node->m_keyCount.
+// postconditions:	data is moved into key slot with count, right becomes
+//					child slot + 1, and later keys and children shift up one
+//					place.
+//
+template<typename Key, typename Compare>
+void BasicBTree<Key, Compare>::insertAt(Node *node, int slot, Key &&data, int count, Node *right) {
+	Key *keys = node->keys();
+	for(int i = node->m_keyCount; i > slot; i--) {
+		relocate(&keys[i], &keys[i - 1]);
+		node->m_itemCounts[i] = node->m_itemCounts[i - 1];
+		node->m_children[i + 1] = node->m_children[i];
+	}
+	new(&keys[slot]) Key(std::move(data));
+	node->m_itemCounts[slot] = count;
+	node->m_children[slot + 1] = right;
+	node->m_keyCount++;
+}
+
+// eraseAt: node helper
+// preconditions:	0 <= slot < node->m_keyCount; child is slot or slot + 1.
+// postconditions:	key slot and the given child are removed, and later keys
+//					and children shift down one place.
+//
+template<typename Key, typename Compare>
+void BasicBTree<Key, Compare>::eraseAt(Node *node, int slot, int child) {
+	Key *keys = node->keys();
+	keys[slot].~Key();
+	for(int i = slot; i < node->m_keyCount - 1; i++) {
+		relocate(&keys[i], &keys[i + 1]);
+		node->m_itemCounts[i] = node->m_itemCounts[i + 1];
+	}
+	for(int i = child; i < node->m_keyCount; i++) {
+		node->m_children[i] = node->m_children[i + 1];
+	}
+	node->m_children[node->m_keyCount] = nullptr;
+	node->m_keyCount--;
+}
+
+// relocate: node helper
+// preconditions:	dest is an unconstructed slot; src holds a key.
+// postconditions:	the key is moved from src to dest; src is destroyed
+//
+template<typename Key, typename Compare>
+void BasicBTree<Key, Compare>::relocate(Key *dest, Key *src) {
+	new(dest) Key(std::move(*src));
+	src->~Key();
+}
+
+// findSlot: search helper
+// preconditions:	none
+// postconditions:	the index of the first key of node not ordered before
+//					data is returned, or node->m_keyCount if there is none
+//
+template<typename Key, typename Compare>
+int BasicBTree<Key, Compare>::findSlot(const Node *node, const Key &data) const {
+	return(findSlot(node, data, integral_constant<bool,
+			is_arithmetic<Key>::value && is_same<Compare, less<Key> >::value>()));
+}
+
+// findSlot helper for arithmetic keys under less<Key>
+// The keys are sorted, so the slot is the number of keys smaller than data.
+// The loop counts them all without an early exit, which the compiler turns
+// into SIMD comparisons over the packed keys.
+//
+template<typename Key, typename Compare>
+int BasicBTree<Key, Compare>::findSlot(const Node *node, const Key &data, true_type) const {
+	const Key *keys = node->keys();
+	int count = node->m_keyCount;
+	int slot = 0;
+	for(int i = 0; i < count; i++) {
+		slot += keys[i] < data;
+	}
+	return(slot);
+}
+
+// findSlot helper for any other key
+// A binary search over the keys of the node.
+//
+template<typename Key, typename Compare>
+int BasicBTree<Key, Compare>::findSlot(const Node *node, const Key &data, false_type) const {
+	const Key *keys = node->keys();
+	int low = 0;
+	int high = node->m_keyCount;
+	while(low < high) {
+		int middle = low + (high - low) / 2;
+		if(isLess(keys[middle], data)) {
+			low = middle + 1;
+		} else {
+			high = middle;
+		}
+	}
+	return(low);
+}
+
+// findKey: search helper
+// preconditions:	none
+// postconditions:	the node holding data is returned with its slot in slot,
+//					or nullptr if data is not in the tree. If depth is not
+//					nullptr it is set to the node's depth.
+//
+template<typename Key, typename Compare>
+const typename BasicBTree<Key, Compare>::Node*
+BasicBTree<Key, Compare>::findKey(const Key &data, int &slot, int *depth) const {
+	const Node *node = m_root;
+	int dep = 0;
+	while(node != nullptr) {
+		slot = findSlot(node, data);
+		if(slot < node->m_keyCount && isEqual(data, node->keys()[slot])) {
+			if(depth != nullptr) {
+				*depth = dep;
+			}
+			return(node);
+		}
+		node = node->m_children[slot];
+		dep++;
+	}
+	return(nullptr);
+}
+
+// subtreeSize: node helper
+// preconditions:	none
+// postconditions:	node's m_size is returned, or 0 if node is nullptr
+//
+template<typename Key, typename Compare>
+int BasicBTree<Key, Compare>::subtreeSize(const Node *node) {
+	return(node == nullptr ? 0 : node->m_size);
+}
+
+// newNode: node allocation helper
+// preconditions:	none
+// postconditions:	an empty leaf carved from m_pool is returned
+//
+template<typename Key, typename Compare>
+typename BasicBTree<Key, Compare>::Node* BasicBTree<Key, Compare>::newNode() {
+	return(new(m_pool.allocate()) Node());
+}
+
+// freeNode: node allocation helper
+// preconditions:	node was returned by newNode and is unlinked.
+// postconditions:	the keys held by node are destroyed and node is returned
+//					to m_pool
+//
+template<typename Key, typename Compare>
+void BasicBTree<Key, Compare>::freeNode(Node *node) {
+	for(int i = 0; i < node->m_keyCount; i++) {
+		node->keys()[i].~Key();
+	}
+	node->~Node();
+	m_pool.deallocate(node);
+}
+
+// copyTree: copy helper
+// preconditions:	this is empty.
+// postconditions:	this holds a node-for-node copy of tree
+//
+template<typename Key, typename Compare>
+void BasicBTree<Key, Compare>::copyTree(const BasicBTree &tree) {
+	vector<pair<Node**, const Node*> > stack;
+	if(tree.m_root != nullptr) {
+		stack.push_back(make_pair(&m_root, tree.m_root));
+	}
+	while(!stack.empty()) {
+		Node **link = stack.back().first;
+		const Node *from = stack.back().second;
+		stack.pop_back();
+		Node *to = newNode();
+		for(int i = 0; i < from->m_keyCount; i++) {
+			new(&to->keys()[i]) Key(from->keys()[i]);
+			to->m_itemCounts[i] = from->m_itemCounts[i];
+		}
+		to->m_keyCount = from->m_keyCount;
+		to->m_size = from->m_size;
+		*link = to;
+		if(!from->isLeaf()) {
+			for(int i = 0; i <= from->m_keyCount; i++) {
+				stack.push_back(make_pair(&to->m_children[i], from->m_children[i]));
+			}
+		}
+	}
+}
+
+// isLess: comparison helper
+// preconditions:	none
+// postconditions:	true is returned if lhs orders before rhs
+//
+template<typename Key, typename Compare>
+bool BasicBTree<Key, Compare>::isLess(const Key &lhs, const Key &rhs) const {
+	return(m_compare(lhs, rhs));
+}
+
+// isEqual: comparison helper
+// preconditions:	none
+// postconditions:	true is returned if neither key orders before the other
+//
+template<typename Key, typename Compare>
+bool BasicBTree<Key, Compare>::isEqual(const Key &lhs, const Key &rhs) const {
+	return(!m_compare(lhs, rhs) && !m_compare(rhs, lhs));
+}
+
+// write: output helper
+// Formats every key in order into out. Each stack entry is a node and the
+// next of its keys to print.
+// preconditions:	none
+// postconditions:	each key is appended to out as "m_item m_itemCount\n"
+//
+template<typename Key, typename Compare>
+void BasicBTree<Key, Compare>::write(OutputBuffer &out) const {
+	vector<pair<const Node*, int> > stack;
+	for(const Node *node = m_root; node != nullptr; node = node->m_children[0]) {
+		stack.push_back(make_pair(node, 0));
+	}
+	while(!stack.empty()) {
+		const Node *node = stack.back().first;
+		int slot = stack.back().second;
+		if(slot == node->m_keyCount) {
+			stack.pop_back();
+			continue;
+		}
+		KeyTraits<Key>::format(out, node->keys()[slot]);
+		out.append(' ');
+		out.appendInt(node->m_itemCounts[slot]);
+		out.append('\n');
+		stack.back().second++;
+		for(const Node *child = node->m_children[slot + 1]; child != nullptr; child = child->m_children[0]) {
+			stack.push_back(make_pair(child, 0));
+		}
+	}
+}
+
+// output
+// Prints the contents of the tree to the ostream
+// preconditions:	this not equal to nullptr.
+// postconditions:	every key is printed in order, one per line, in the
+//					format: "m_item m_itemCount"
+//
+template<typename Key, typename Compare>
+ostream& operator<<(ostream &sout, const BasicBTree<Key, Compare> &tree) {
+	tree.write(sout);
+	return(sout);
+}
+#endif
\ No newline at end of file
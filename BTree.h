@@ -0,0 +1,428 @@
+// BTree.h		Author: Sam Hoover
+// contains the declarations for the BasicBTree class template and the BTree
+// type, a tree of wide nodes holding many keys each
+//
+#ifndef BTREE_H
+#define BTREE_H
+#include <cstddef>
+#include <functional>
+#include <iostream>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "BSTree.h"
+#include "KeyTraits.h"
+#include "MemoryPool.h"
+#include "OutputBuffer.h"
+#include "TreeData.h"
+using namespace std;
+
+// BTREE_KEY_BYTES
+// the number of bytes of keys a BasicBTree node is sized to hold, a few
+// cache lines
+//
+const size_t BTREE_KEY_BYTES = 256;
+
+// BTREE_MAX_DEGREE
+// the largest minimum degree a BasicBTree node is given, however small its
+// keys are
+//
+const size_t BTREE_MAX_DEGREE = 32;
+
+// BasicBTree
+// A B-tree class template storing Key objects ordered by Compare, with the
+// same duplicate-count rules as BasicBSTree: inserting a key already present
+// increments its count, and removing a key decrements the count until the
+// key is deleted.
+//
+// Each node holds up to MAX_KEYS keys in sorted order, packed together in
+// one array (about BTREE_KEY_BYTES bytes) with their counts and child
+// pointers kept in separate arrays beside it, so a search inside a node
+// reads only contiguous keys. Every node but the root holds at least
+// DEGREE - 1 keys, so a tree of n keys is about log(n) / log(DEGREE) nodes
+// deep instead of log2(n): a 10 million key tree of ints is 4 nodes deep.
+//
+// Inside a node, arithmetic keys under less<Key> are located by counting
+// the keys ordered before the search key in a loop with no early exit,
+// which the compiler turns into SIMD comparisons. Other keys use a binary
+// search.
+//
+// Full nodes are split on the way down during insert, and nodes with the
+// minimum number of keys are filled on the way down during remove, so both
+// finish in one pass from the root with no recursion. Every node records the
+// number of keys in its subtree (m_size) to answer descendants in
+// O(depth). Nodes are allocated from a per-tree MemoryPool.
+//
+// Key must be copy constructible, assignable, and printable with operator<<.
+// Compare must be a strict weak ordering on Key.
+//
+template<typename Key, typename Compare = less<Key> >
+class BasicBTree {
+
+	// output
+	// Prints the contents of the tree to the ostream
+	// preconditions:	this not equal to nullptr.
+	// postconditions:	every key is printed in order, one per line, in the
+	//					format: "m_item m_itemCount"
+	//
+	template<typename K, typename C>
+	friend ostream& operator<<(ostream &sout, const BasicBTree<K, C> &tree);
+
+public:
+	// CONSTRUCTORS/DESTRUCTOR
+
+	// default constructor
+	// preconditions:	none
+	// postconditions:	Creates an empty tree (m_root equal to nullptr)
+	//
+	BasicBTree();
+
+	// copy constructor
+	// preconditions:	tree must be a valid BTree object (must not reference
+	//					a dereferenced nullptr)
+	// postconditions:	this is a deep copy of tree, node for node
+	//
+	BasicBTree(const BasicBTree &tree);
+
+	// destructor
+	// preconditions:	none
+	// postconditions:	All nodes removed and deleted, m_root set to nullptr
+	//
+	~BasicBTree();
+
+	// MUTATORS
+
+	// insert(const Key &data)
+	// Inserts a copy of data into the tree. If the key already exists in the
+	// tree, its count is incremented by one.
+	// preconditions:	data must be a valid Key object (must not reference
+	//					a dereferenced nullptr); this not equal to nullptr.
+	// postconditions:	If data does not already exist in the tree, then a copy
+	//					of data is inserted with a count of one and true is
+	//					returned. If the data already exists, then its count is
+	//					incremented by one and false is returned.
+	//
+	bool insert(const Key &data);
+
+	// insert(Key *data)
+	// Deprecated: use insert(const Key&) or emplace. The key is copied out of
+	// *data; the tree never takes ownership of data.
+	// preconditions:	data must be a valid Key object not equal to nullptr;
+	//					this not equal to nullptr.
+	// postconditions:	the same as insert(*data); data is left to the caller.
+	//
+	bool insert(Key *data);
+
+	// emplace
+	// Constructs a Key from args and inserts it into the tree, following the
+	// same rules as insert.
+	// preconditions:	args must be valid arguments to a Key constructor;
+	//					this not equal to nullptr.
+	// postconditions:	If the constructed key does not already exist in the
+	//					tree, it is inserted and true is returned. Otherwise
+	//					its count is incremented by one and false is returned.
+	//
+	template<typename... Args>
+	bool emplace(Args&&... args);
+
+	// remove
+	// Removes a Key object equal to data from the tree. If its count is one,
+	// the key itself is deleted from its node.
+	// preconditions:	data must be a valid Key object (must not reference
+	//					a dereferenced nullptr); this not equal to nullptr.
+	// postconditions:	If data is not found, then false is returned. If data
+	//					is found and its count > 1 then the count is
+	//					decremented by one; if the count == 1 then the key is
+	//					deleted from the tree. true is returned.
+	//
+	bool remove(const Key &data);
+
+	// makeEmpty
+	// Removes and deletes all keys and nodes from the tree, and set m_root
+	// equal to nullptr.
+	// preconditions:	this not equal to nullptr.
+	// postconditions:	All nodes removed and deleted, m_root set to nullptr
+	//
+	void makeEmpty();
+
+	// ACCESSORS
+
+	// retrieve
+	// Searches the tree for data, if found, a const pointer to that object is
+	// returned.
+	// preconditions:	data must be a valid Key object (must not reference
+	//					a dereferenced nullptr); this not equal to nullptr.
+	// postconditions:	If data is found, a const pointer to the key equal to
+	//					data is returned; else nullptr is returned.
+	//
+	const Key* retrieve(const Key &data) const;
+
+	// depth
+	// Finds the depth of the node holding data. Depth of m_root is 0.
+	// preconditions:	data must be a valid Key object (must not reference
+	//					a dereferenced nullptr); this not equal to nullptr.
+	// postconditions:	If data is found, the depth of its node is returned.
+	//					If data is not found, -1 is returned.
+	//
+	int depth(const Key &data) const;
+
+	// descendants
+	// Finds the number of keys below data: the keys in the two subtrees on
+	// either side of it in its node, which hold every key between its
+	// neighbours there. A key in a leaf has none. The count is read from the
+	// subtrees' m_size, so the cost is that of finding the key.
+	// preconditions:	data must be a valid Key object (must not reference
+	//					a dereferenced nullptr); this not equal to nullptr.
+	// postconditions:	If data is found, the number of keys below it is
+	//					returned. If data is not found, -1 is returned.
+	//
+	int descendants(const Key &data) const;
+
+	// size
+	// Returns the number of distinct keys in the tree.
+	// preconditions:	this not equal to nullptr.
+	// postconditions:	m_root's m_size is returned, or 0 if the tree is
+	//					empty
+	//
+	int size() const;
+
+	// isEmpty
+	// Returns true is tree is empty, else false
+	// preconditions:	this not equal to nullptr.
+	// postconditions:	true is returned if m_root is equal to nullptr
+	//
+	bool isEmpty() const;
+
+	// write(ostream &sout)
+	// Prints the contents of the tree to sout in the same format as
+	// operator<<, building the text in large blocks.
+	// preconditions:	this not equal to nullptr.
+	// postconditions:	the contents of this are written to sout. false is
+	//					returned if sout failed.
+	//
+	bool write(ostream &sout) const;
+
+	// write(int fd)
+	// Prints the contents of the tree to the file descriptor fd in the same
+	// format as operator<<, using large write calls.
+	// preconditions:	fd must be open for writing; this not equal to nullptr.
+	// postconditions:	the contents of this are written to fd. false is
+	//					returned if a write failed.
+	//
+	bool write(int fd) const;
+
+	// OPERATORS
+
+	// assignment
+	// Sets this equal to tree. Performs a deep copy.
+	// preconditions:	tree must be a valid BTree object (must not reference
+	//					a dereferenced nullptr)
+	// postconditions:	this is a deep copy of tree; the old contents of this
+	//					are deleted.
+	//
+	const BasicBTree& operator=(const BasicBTree &tree);
+
+private:
+	// DATA
+
+	// DEGREE
+	// the minimum degree of the tree: every node but the root holds between
+	// DEGREE - 1 and MAX_KEYS keys
+	//
+	static const int DEGREE = static_cast<int>(BTREE_KEY_BYTES / sizeof(Key) / 2 > BTREE_MAX_DEGREE ?
+			BTREE_MAX_DEGREE : (BTREE_KEY_BYTES / sizeof(Key) / 2 < 2 ? 2 : BTREE_KEY_BYTES / sizeof(Key) / 2));
+
+	// MAX_KEYS
+	// the most keys a node can hold
+	//
+	static const int MAX_KEYS = 2 * DEGREE - 1;
+
+	// Node
+	// A node of the tree. Only the first m_keyCount slots of m_slots hold
+	// constructed keys; m_itemCounts[i] is the count of key i. An internal
+	// node has m_keyCount + 1 children, with the keys of m_children[i]
+	// ordered before key i and those of m_children[i + 1] after it. A leaf
+	// has no children.
+	//
+	struct Node {
+		// Node default constructor
+		// preconditions:	none
+		// postconditions:	Creates an empty leaf
+		//
+		Node();
+
+		// keys
+		// preconditions:	none
+		// postconditions:	a pointer to the first key slot is returned
+		//
+		Key* keys();
+		const Key* keys() const;
+
+		// isLeaf
+		// preconditions:	none
+		// postconditions:	true is returned if the node has no children
+		//
+		bool isLeaf() const;
+
+		int m_keyCount;
+		int m_size;
+		typename aligned_storage<sizeof(Key), alignof(Key)>::type m_slots[MAX_KEYS];
+		int m_itemCounts[MAX_KEYS];
+		Node *m_children[MAX_KEYS + 1];
+	};
+
+	// HELPER FUNCTIONS
+
+	// add: insert helper
+	// Makes data present in the tree, or increments its count. Splits every
+	// full node on the way down, so the leaf reached always has room.
+	// preconditions:	data must be a valid Key object.
+	// postconditions:	true is returned if data was not present before.
+	//
+	bool add(Key &&data);
+
+	// erase: remove helper
+	// Deletes data from the tree in one pass from the root. Each child is
+	// given at least DEGREE keys before it is entered, by borrowing from or
+	// merging with a sibling, so deleting from the leaf at the bottom never
+	// leaves a node with too few keys.
+	// preconditions:	data must be in the tree.
+	// postconditions:	data is no longer in the tree
+	//
+	void erase(const Key &data);
+
+	// splitChild: insert helper
+	// preconditions:	parent is not full; its child at slot is full.
+	// postconditions:	the child at slot keeps its lower DEGREE - 1 keys, a
+	//					new node right of it takes the upper DEGREE - 1 keys,
+	//					and the median key moves up into parent at slot.
+	//
+	void splitChild(Node *parent, int slot);
+
+	// mergeChildren: remove helper
+	// preconditions:	the children at slot and slot + 1 of parent hold
+	//					DEGREE - 1 keys each.
+	// postconditions:	key slot of parent and every key of the child at
+	//					slot + 1 are moved to the end of the child at slot,
+	//					and the emptied child is freed.
+	//
+	void mergeChildren(Node *parent, int slot);
+
+	// borrowFromLeft: remove helper
+	// preconditions:	slot > 0; the child at slot - 1 holds DEGREE keys or
+	//					more.
+	// postconditions:	key slot - 1 of parent moves to the front of the child
+	//					at slot, and the last key of its left sibling (with
+	//					its last child) takes its place.
+	//
+	void borrowFromLeft(Node *parent, int slot);
+
+	// borrowFromRight: remove helper
+	// preconditions:	slot < parent->m_keyCount; the child at slot + 1
+	//					holds DEGREE keys or more.
+	// postconditions:	key slot of parent moves to the end of the child at
+	//					slot, and the first key of its right sibling (with its
+	//					first child) takes its place.
+	//
+	void borrowFromRight(Node *parent, int slot);
+
+	// insertAt: node helper
+	// preconditions:	node is not full; 0 <= slot <= node->m_keyCount.
+	// postconditions:	data is moved into key slot with count, right becomes
+	//					child slot + 1, and later keys and children shift up
+	//					one place.
+	//
+	static void insertAt(Node *node, int slot, Key &&data, int count, Node *right);
+
+	// eraseAt: node helper
+	// preconditions:	0 <= slot < node->m_keyCount; child is slot or
+	//					slot + 1.
+	// postconditions:	key slot and the given child are removed, and later
+	//					keys and children shift down one place.
+	//
+	static void eraseAt(Node *node, int slot, int child);
+
+	// relocate: node helper
+	// preconditions:	dest is an unconstructed slot; src holds a key.
+	// postconditions:	the key is moved from src to dest; src is destroyed
+	//
+	static void relocate(Key *dest, Key *src);
+
+	// findSlot: search helper
+	// preconditions:	none
+	// postconditions:	the index of the first key of node not ordered before
+	//					data is returned, or node->m_keyCount if there is none
+	//
+	int findSlot(const Node *node, const Key &data) const;
+
+	// findSlot helpers, chosen by whether Key is arithmetic under less<Key>:
+	// a branch-free count of the smaller keys, or a binary search
+	int findSlot(const Node *node, const Key &data, true_type) const;
+	int findSlot(const Node *node, const Key &data, false_type) const;
+
+	// findKey: search helper
+	// preconditions:	none
+	// postconditions:	the node holding data is returned with its slot in
+	//					slot, or nullptr if data is not in the tree. If depth
+	//					is not nullptr it is set to the node's depth.
+	//
+	const Node* findKey(const Key &data, int &slot, int *depth = nullptr) const;
+
+	// subtreeSize: node helper
+	// preconditions:	none
+	// postconditions:	node's m_size is returned, or 0 if node is nullptr
+	//
+	static int subtreeSize(const Node *node);
+
+	// newNode: node allocation helper
+	// preconditions:	none
+	// postconditions:	an empty leaf carved from m_pool is returned
+	//
+	Node* newNode();
+
+	// freeNode: node allocation helper
+	// preconditions:	node was returned by newNode and is unlinked.
+	// postconditions:	the keys held by node are destroyed and node is
+	//					returned to m_pool
+	//
+	void freeNode(Node *node);
+
+	// copyTree: copy helper
+	// preconditions:	this is empty.
+	// postconditions:	this holds a node-for-node copy of tree
+	//
+	void copyTree(const BasicBTree &tree);
+
+	// isLess: comparison helper
+	// preconditions:	none
+	// postconditions:	true is returned if lhs orders before rhs
+	//
+	bool isLess(const Key &lhs, const Key &rhs) const;
+
+	// isEqual: comparison helper
+	// preconditions:	none
+	// postconditions:	true is returned if neither key orders before the
+	//					other
+	//
+	bool isEqual(const Key &lhs, const Key &rhs) const;
+
+	// write: output helper
+	// Formats every key in order into out.
+	// preconditions:	none
+	// postconditions:	each key is appended to out as "m_item m_itemCount\n"
+	//
+	void write(OutputBuffer &out) const;
+
+	Node *m_root;
+	MemoryPool m_pool;
+	Compare m_compare;
+};
+
+// BTree
+// the B-tree of TreeData objects
+//
+typedef BasicBTree<TreeData> BTree;
+
+#include "BTree.cpp"
+#endif
\ No newline at end of file
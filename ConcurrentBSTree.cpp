@@ -0,0 +1,715 @@
+// ConcurrentBSTree.cpp		Author: Sam Hoover
+// contains the definitions for the BasicConcurrentBSTree class template. This
+// file is included at the bottom of ConcurrentBSTree.h and needs no separate
+// compilation
+//
+#ifndef CONCURRENTBSTREE_CPP
+#define CONCURRENTBSTREE_CPP
+#include <new>
+#include "ConcurrentBSTree.h"
+
+template<typename Key, typename Compare>
+const uintptr_t BasicConcurrentBSTree<Key, Compare>::FLAG_BIT;
+template<typename Key, typename Compare>
+const uintptr_t BasicConcurrentBSTree<Key, Compare>::TAG_BIT;
+template<typename Key, typename Compare>
+const uintptr_t BasicConcurrentBSTree<Key, Compare>::LINK_BITS;
+
+// BasicConcurrentBSTree::Node constructor(const Key &data, Node *left,
+//											Node *right)
+// preconditions:	data must be a valid Key object
+// postconditions:	Creates a node holding a copy of data with m_itemCount
+//					equal to MIN_ITEM_COUNT and the given children; a leaf
+//					if both are nullptr
+//
+template<typename Key, typename Compare>
+BasicConcurrentBSTree<Key, Compare>::Node::Node(const Key &data, Node *left, Node *right) : m_infinity(0),
+		m_itemCount(MIN_ITEM_COUNT), m_left(linkTo(left)), m_right(linkTo(right)),
+		m_retiredNext(nullptr), m_retiredEpoch(0) {
+	new(m_storage) Key(data);
+}
+
+// BasicConcurrentBSTree::Node constructor(Node *left, Node *right,
+//											int infinity)
+// The children come first so that the call cannot be confused with the one
+// above when Key is an integer.
+// preconditions:	infinity > 0
+// postconditions:	Creates a sentinel node with no key
+//
+template<typename Key, typename Compare>
+BasicConcurrentBSTree<Key, Compare>::Node::Node(Node *left, Node *right, int infinity) : m_infinity(infinity),
+		m_itemCount(0), m_left(linkTo(left)), m_right(linkTo(right)), m_retiredNext(nullptr),
+		m_retiredEpoch(0) {
+}
+
+// BasicConcurrentBSTree::Node destructor
+// preconditions:	none
+// postconditions:	m_item is destroyed if the node holds one
+//
+template<typename Key, typename Compare>
+BasicConcurrentBSTree<Key, Compare>::Node::~Node() {
+	if(m_infinity == 0) {
+		reinterpret_cast<Key*>(m_storage)->~Key();
+	}
+}
+
+// BasicConcurrentBSTree::Node item
+// preconditions:	m_infinity equal to 0
+// postconditions:	the key held by the node is returned
+//
+template<typename Key, typename Compare>
+const Key& BasicConcurrentBSTree<Key, Compare>::Node::item() const {
+	return(*reinterpret_cast<const Key*>(m_storage));
+}
+
+// BasicConcurrentBSTree::Node isLeaf
+// Routing nodes always have two children, so one link is enough to check.
+// preconditions:	none
+// postconditions:	true is returned if the node has no children
+//
+template<typename Key, typename Compare>
+bool BasicConcurrentBSTree<Key, Compare>::Node::isLeaf() const {
+	return(nodeOf(m_left.load(memory_order_acquire)) == nullptr);
+}
+
+// ReadGuard constructor(const BasicConcurrentBSTree &tree)
+// preconditions:	tree must outlive the guard.
+// postconditions:	the calling thread is reading tree
+//
+template<typename Key, typename Compare>
+BasicConcurrentBSTree<Key, Compare>::ReadGuard::ReadGuard(const BasicConcurrentBSTree &tree) : m_tree(tree) {
+	m_tree.beginRead();
+}
+
+// ReadGuard destructor
+// preconditions:	the guard is destroyed by the thread that made it.
+// postconditions:	the calling thread's read of tree has ended if this was
+//					the outermost guard
+//
+template<typename Key, typename Compare>
+BasicConcurrentBSTree<Key, Compare>::ReadGuard::~ReadGuard() {
+	m_tree.endRead();
+}
+
+// default constructor
+// The top sentinel (m_infinity 3) has the second sentinel (2) on its left;
+// that one's left subtree, a single sentinel leaf (1) while the tree is
+// empty, is where every key goes. The sentinels give every search a parent
+// and an ancestor, and are never removed.
+// preconditions:	none
+// postconditions:	Creates an empty tree (only the sentinel nodes)
+//
+template<typename Key, typename Compare>
+BasicConcurrentBSTree<Key, Compare>::BasicConcurrentBSTree() : m_keyCount(0), m_retired(nullptr),
+		m_retiredCount(0) {
+	Node *keys = new Node(new Node(nullptr, nullptr, 1), new Node(nullptr, nullptr, 2), 2);
+	m_root = new Node(keys, new Node(nullptr, nullptr, 3), 3);
+}
+
+// destructor
+// preconditions:	no other thread is using the tree.
+// postconditions:	every node, retired or not, is deleted
+//
+template<typename Key, typename Compare>
+BasicConcurrentBSTree<Key, Compare>::~BasicConcurrentBSTree() {
+	makeEmpty();
+	deleteSubtree(linkTo(m_root));
+}
+
+// insert(const Key &data)
+// Inserts a copy of data into the tree. If a leaf containing an equal
+// object already exists in the tree, its m_itemCount is incremented by
+// one. Safe to call from any number of threads.
+// preconditions:	data must be a valid Key object (must not reference
+//					a dereferenced nullptr); this not equal to nullptr.
+// postconditions:	If data was not present in the tree, it becomes
+//					present with m_itemCount equal to 1 and true is
+//					returned. If data was present, then m_itemCount is
+//					incremented by one and false is returned.
+//
+template<typename Key, typename Compare>
+bool BasicConcurrentBSTree<Key, Compare>::insert(const Key &data) {
+	bool inserted;
+	{
+		ReadGuard guard(*this);
+		inserted = add(data);
+	}
+	// an insert that helped a removal may have retired nodes
+	if(m_retiredCount.load(memory_order_relaxed) >= CONCURRENT_RECLAIM_THRESHOLD) {
+		reclaim();
+	}
+	return(inserted);
+}
+
+// insert(Key *data)
+// Deprecated: use insert(const Key&) or emplace. Only a copy of *data
+// enters the tree, so data stays owned by the caller.
+// preconditions:	data must be a valid Key object not equal to
+//					nullptr; this not equal to nullptr.
+// postconditions:	the same as insert(*data); data is left to the caller.
+//
+template<typename Key, typename Compare>
+bool BasicConcurrentBSTree<Key, Compare>::insert(Key *data) {
+	return(insert(*data));
+}
+
+// emplace
+// Constructs a Key from args and inserts it into the tree, following the
+// same rules as insert. Safe to call from any number of threads.
+// preconditions:	args must be valid arguments to a Key constructor;
+//					this not equal to nullptr.
+// postconditions:	If the constructed item was not present in the tree,
+//					it becomes present and true is returned. Otherwise its
+//					m_itemCount is incremented by one and false is
+//					returned.
+//
+template<typename Key, typename Compare>
+template<typename... Args>
+bool BasicConcurrentBSTree<Key, Compare>::emplace(Args&&... args) {
+	return(insert(Key(std::forward<Args>(args)...)));
+}
+
+// remove
+// Removes a Key object equal to data from the tree. Safe to call from any
+// number of threads.
+// preconditions:	data must be a valid Key object (must not reference
+//					a dereferenced nullptr); this not equal to nullptr.
+// postconditions:	If data is not present, then false is returned.
+//					Otherwise m_itemCount is decremented by one and true is
+//					returned; when it reaches 0 the key's leaf and the
+//					routing node above it are unlinked and retired.
+//
+template<typename Key, typename Compare>
+bool BasicConcurrentBSTree<Key, Compare>::remove(const Key &data) {
+	bool removed;
+	{
+		ReadGuard guard(*this);
+		removed = erase(data);
+	}
+	if(m_retiredCount.load(memory_order_relaxed) >= CONCURRENT_RECLAIM_THRESHOLD) {
+		reclaim();
+	}
+	return(removed);
+}
+
+// makeEmpty
+// Removes and deletes all nodes from the tree, including retired ones,
+// leaving only the sentinel nodes.
+// preconditions:	no other thread is using the tree.
+// postconditions:	the tree is empty and no retired node is waiting
+//
+template<typename Key, typename Compare>
+void BasicConcurrentBSTree<Key, Compare>::makeEmpty() {
+	Node *keys = nodeOf(m_root->m_left.load());
+	deleteSubtree(keys->m_left.exchange(linkTo(new Node(nullptr, nullptr, 1))));
+	Node *node = m_retired.exchange(nullptr);
+	while(node != nullptr) {
+		Node *next = node->m_retiredNext;
+		delete node;
+		node = next;
+	}
+	m_retiredCount.store(0);
+	m_keyCount.store(0);
+}
+
+// retrieve
+// Searches the tree for data, if found, a const pointer to that object is
+// returned. The pointer stays valid only while the calling thread holds a
+// ReadGuard on the tree, as the key may be removed and its leaf freed by
+// another thread.
+// preconditions:	data must be a valid Key object (must not reference
+//					a dereferenced nullptr); this not equal to nullptr.
+// postconditions:	If data is present in the tree, a const pointer to the
+//					stored object is returned. If data is not present then
+//					nullptr is returned.
+//
+template<typename Key, typename Compare>
+const Key* BasicConcurrentBSTree<Key, Compare>::retrieve(const Key &data) const {
+	ReadGuard guard(*this);
+	SeekRecord record;
+	seek(data, record);
+	const Node *leaf = record.m_leaf;
+	if(!isEqual(data, leaf) || leaf->m_itemCount.load(memory_order_acquire) < MIN_ITEM_COUNT) {
+		return(nullptr);
+	}
+	return(&leaf->item());
+}
+
+// depth
+// Finds the depth of the leaf holding data, counted in routing nodes from
+// the top of the tree's keys: a tree holding one key has it at depth 1.
+// preconditions:	data must be a valid Key object (must not reference
+//					a dereferenced nullptr); this not equal to nullptr.
+// postconditions:	If data is present in the tree, the depth of its leaf is
+//					returned. If data is not present, -1 is returned.
+//
+template<typename Key, typename Compare>
+int BasicConcurrentBSTree<Key, Compare>::depth(const Key &data) const {
+	ReadGuard guard(*this);
+	SeekRecord record;
+	int dep = 0;
+	seek(data, record, &dep);
+	const Node *leaf = record.m_leaf;
+	if(!isEqual(data, leaf) || leaf->m_itemCount.load(memory_order_acquire) < MIN_ITEM_COUNT) {
+		return(VALUE_NOT_FOUND);
+	}
+	return(dep);
+}
+
+// size
+// Returns the number of distinct keys present in the tree. While other
+// threads are writing, the value may lag their most recent changes.
+// preconditions:	this not equal to nullptr.
+// postconditions:	m_keyCount is returned
+//
+template<typename Key, typename Compare>
+int BasicConcurrentBSTree<Key, Compare>::size() const {
+	return(m_keyCount.load(memory_order_relaxed));
+}
+
+// isEmpty
+// Checks whether any key is present in the tree.
+// preconditions:	this not equal to nullptr.
+// postconditions:	true is returned if no key is present; otherwise false
+//					is returned.
+//
+template<typename Key, typename Compare>
+bool BasicConcurrentBSTree<Key, Compare>::isEmpty() const {
+	return(size() == 0);
+}
+
+// write
+// Writes the contents of the tree to sout in the same format as
+// operator<<. Safe to call while other threads write; each key is
+// reported with the count it held when it was visited.
+// preconditions:	this not equal to nullptr.
+// postconditions:	each key present is written to sout. false is
+//					returned if sout failed.
+//
+template<typename Key, typename Compare>
+bool BasicConcurrentBSTree<Key, Compare>::write(ostream &sout) const {
+	OutputBuffer out(sout);
+	{
+		ReadGuard guard(*this);
+		write(out);
+	}
+	return(out.flush());
+}
+
+// write
+// Writes the contents of the tree to the file descriptor fd in the same
+// format as operator<<.
+// preconditions:	fd must be open for writing; this not equal to nullptr.
+// postconditions:	each key present is written to fd. false is returned
+//					if a write failed.
+//
+template<typename Key, typename Compare>
+bool BasicConcurrentBSTree<Key, Compare>::write(int fd) const {
+	OutputBuffer out(fd);
+	{
+		ReadGuard guard(*this);
+		write(out);
+	}
+	return(out.flush());
+}
+
+// getRetiredCount
+// Returns the number of unlinked nodes not yet freed.
+// preconditions:	this not equal to nullptr.
+// postconditions:	m_retiredCount is returned
+//
+template<typename Key, typename Compare>
+int BasicConcurrentBSTree<Key, Compare>::getRetiredCount() const {
+	return(m_retiredCount.load(memory_order_relaxed));
+}
+
+// beginRead: ReadGuard helper
+// The outermost read announces the current epoch in the thread's slot of
+// m_epochs before any link is followed, so nothing it reaches is freed
+// until it ends.
+// preconditions:	none
+// postconditions:	the calling thread's slot announces the current epoch
+//
+template<typename Key, typename Compare>
+void BasicConcurrentBSTree<Key, Compare>::beginRead() const {
+	m_epochs.beginRead();
+}
+
+// endRead: ReadGuard helper
+// preconditions:	follows a beginRead on the same thread.
+// postconditions:	the calling thread's slot is idle if this ended the
+//					outermost read
+//
+template<typename Key, typename Compare>
+void BasicConcurrentBSTree<Key, Compare>::endRead() const {
+	m_epochs.endRead();
+}
+
+// add: insert helper
+// Finds the leaf where data belongs. If it holds data, its count is raised,
+// unless it is already 0 and the leaf on its way out, in which case the
+// removal is finished first. Otherwise the leaf's clean link is swung, with
+// a compare-and-swap, to a new routing node over the old leaf and a new
+// one. A marked link means a removal is under way there; it is helped to
+// finish and the insert retried.
+// preconditions:	data must be a valid Key object; the calling thread is
+//					reading the tree.
+// postconditions:	true is returned if data was not present before.
+//
+template<typename Key, typename Compare>
+bool BasicConcurrentBSTree<Key, Compare>::add(const Key &data) {
+	Node *fresh = nullptr;
+	while(true) {
+		SeekRecord record;
+		seek(data, record);
+		Node *leaf = record.m_leaf;
+		if(isEqual(data, leaf)) {
+			int count = leaf->m_itemCount.load(memory_order_acquire);
+			while(count >= MIN_ITEM_COUNT) {
+				if(leaf->m_itemCount.compare_exchange_weak(count, count + 1,
+						memory_order_acq_rel, memory_order_acquire)) {
+					delete fresh;
+					return(false);
+				}
+			}
+			unlinkLeaf(data, leaf);
+			continue;
+		}
+
+		if(fresh == nullptr) {
+			fresh = new Node(data, nullptr, nullptr);
+		}
+		Node *routing;
+		if(!isLess(data, leaf)) {
+			routing = new Node(data, leaf, fresh);
+		} else if(leaf->m_infinity > 0) {
+			routing = new Node(fresh, leaf, leaf->m_infinity);
+		} else {
+			routing = new Node(leaf->item(), fresh, leaf);
+		}
+		Node *parent = record.m_parent;
+		atomic<uintptr_t> &link = isLess(data, parent) ? parent->m_left : parent->m_right;
+		uintptr_t expected = linkTo(leaf);
+		if(link.compare_exchange_strong(expected, linkTo(routing), memory_order_acq_rel,
+				memory_order_acquire)) {
+			m_keyCount.fetch_add(1, memory_order_relaxed);
+			return(true);
+		}
+		delete routing;
+		if(nodeOf(expected) == leaf && (expected & LINK_BITS) != 0) {
+			cleanup(data, record);
+		}
+	}
+}
+
+// erase: remove helper
+// The count of data's leaf is lowered with a compare-and-swap. Taking it
+// from MIN_ITEM_COUNT to 0 removes the key, and the thread that did so
+// unlinks the leaf.
+// preconditions:	data must be a valid Key object; the calling thread is
+//					reading the tree.
+// postconditions:	true is returned if data was present.
+//
+template<typename Key, typename Compare>
+bool BasicConcurrentBSTree<Key, Compare>::erase(const Key &data) {
+	SeekRecord record;
+	seek(data, record);
+	Node *leaf = record.m_leaf;
+	if(!isEqual(data, leaf)) {
+		return(false);
+	}
+	int count = leaf->m_itemCount.load(memory_order_acquire);
+	while(count >= MIN_ITEM_COUNT) {
+		if(leaf->m_itemCount.compare_exchange_weak(count, count - 1,
+				memory_order_acq_rel, memory_order_acquire)) {
+			if(count == MIN_ITEM_COUNT) {
+				m_keyCount.fetch_sub(1, memory_order_relaxed);
+				unlinkLeaf(data, leaf);
+			}
+			return(true);
+		}
+	}
+	return(false);
+}
+
+// unlinkLeaf: remove helper
+// Flags the link to leaf, then cleans up. A link already tagged means the
+// leaf is the sibling in another removal, which is helped first; once the
+// leaf has moved up, the search is repeated from the top.
+// preconditions:	leaf holds data and has m_itemCount 0; the calling
+//					thread is reading the tree.
+// postconditions:	leaf is unlinked, by this or another thread
+//
+template<typename Key, typename Compare>
+void BasicConcurrentBSTree<Key, Compare>::unlinkLeaf(const Key &data, Node *leaf) {
+	while(true) {
+		SeekRecord record;
+		seek(data, record);
+		if(record.m_leaf != leaf) {
+			return;
+		}
+		Node *parent = record.m_parent;
+		atomic<uintptr_t> &link = isLess(data, parent) ? parent->m_left : parent->m_right;
+		uintptr_t expected = linkTo(leaf);
+		if(link.compare_exchange_strong(expected, linkTo(leaf) | FLAG_BIT, memory_order_acq_rel,
+				memory_order_acquire) || expected == (linkTo(leaf) | FLAG_BIT)) {
+			if(cleanup(data, record)) {
+				return;
+			}
+		} else if(nodeOf(expected) == leaf) {
+			cleanup(data, record);
+		}
+	}
+}
+
+// cleanup: remove helper
+// The flagged leaf is the child of record.m_parent on data's side, or, if
+// that link is not flagged, the other child. Its sibling's link is tagged
+// so it cannot change, then the link from record.m_ancestor to
+// record.m_successor is swung to the sibling, keeping the sibling's flag.
+// Everything from record.m_successor down to record.m_parent is cut off:
+// those routing nodes and, hanging from each, a flagged leaf whose removal
+// was waiting on this one.
+// preconditions:	a link of record.m_parent is flagged; the calling thread
+//					is reading the tree.
+// postconditions:	true is returned if this call did the unlinking.
+//
+template<typename Key, typename Compare>
+bool BasicConcurrentBSTree<Key, Compare>::cleanup(const Key &data, const SeekRecord &record) {
+	Node *ancestor = record.m_ancestor;
+	Node *successor = record.m_successor;
+	Node *parent = record.m_parent;
+	atomic<uintptr_t> &successorLink = isLess(data, ancestor) ? ancestor->m_left : ancestor->m_right;
+	atomic<uintptr_t> *childLink = &parent->m_right;
+	atomic<uintptr_t> *siblingLink = &parent->m_left;
+	if(isLess(data, parent)) {
+		childLink = &parent->m_left;
+		siblingLink = &parent->m_right;
+	}
+	if((childLink->load(memory_order_acquire) & FLAG_BIT) == 0) {
+		siblingLink = childLink;
+	}
+	uintptr_t sibling = siblingLink->fetch_or(TAG_BIT, memory_order_acq_rel) & ~TAG_BIT;
+	uintptr_t expected = linkTo(successor);
+	if(!successorLink.compare_exchange_strong(expected, sibling, memory_order_acq_rel,
+			memory_order_acquire)) {
+		return(false);
+	}
+
+	// every link below successor on the way to parent is tagged, and every
+	// other link of those nodes flagged, so none of them can change now
+	Node *node = successor;
+	while(node != parent) {
+		bool left = isLess(data, node);
+		uintptr_t next = (left ? node->m_left : node->m_right).load(memory_order_acquire);
+		retire(nodeOf((left ? node->m_right : node->m_left).load(memory_order_acquire)));
+		retire(node);
+		node = nodeOf(next);
+	}
+	Node *kept = nodeOf(sibling);
+	Node *removed = nodeOf(parent->m_left.load(memory_order_acquire));
+	if(removed == kept) {
+		removed = nodeOf(parent->m_right.load(memory_order_acquire));
+	}
+	retire(removed);
+	retire(parent);
+	return(true);
+}
+
+// seek: search helper
+// Walks from the top sentinels to a leaf, remembering the parent of the
+// leaf and the lowest untagged link above it.
+// preconditions:	data must be a valid Key object; the calling thread is
+//					reading the tree.
+// postconditions:	record describes the path to the leaf where data is or
+//					would be. If depth is not nullptr it is set to the
+//					leaf's depth below m_root's key subtree.
+//
+template<typename Key, typename Compare>
+void BasicConcurrentBSTree<Key, Compare>::seek(const Key &data, SeekRecord &record, int *depth) const {
+	Node *keys = nodeOf(m_root->m_left.load(memory_order_acquire));
+	record.m_ancestor = m_root;
+	record.m_successor = keys;
+	record.m_parent = keys;
+	uintptr_t parentLink = keys->m_left.load(memory_order_acquire);
+	record.m_leaf = nodeOf(parentLink);
+	uintptr_t currentLink = (isLess(data, record.m_leaf) ? record.m_leaf->m_left
+			: record.m_leaf->m_right).load(memory_order_acquire);
+	int dep = 0;
+	while(nodeOf(currentLink) != nullptr) {
+		if((parentLink & TAG_BIT) == 0) {
+			record.m_ancestor = record.m_parent;
+			record.m_successor = record.m_leaf;
+		}
+		record.m_parent = record.m_leaf;
+		record.m_leaf = nodeOf(currentLink);
+		parentLink = currentLink;
+		currentLink = (isLess(data, record.m_leaf) ? record.m_leaf->m_left
+				: record.m_leaf->m_right).load(memory_order_acquire);
+		dep++;
+	}
+	if(depth != nullptr) {
+		*depth = dep;
+	}
+}
+
+// retire: reclamation helper
+// The node is stamped with the epoch current after it was unlinked: a
+// reader that announces a later epoch started after the unlinking and
+// cannot reach it.
+// preconditions:	node is unlinked and no other thread will retire it.
+// postconditions:	node is pushed onto m_retired with the current epoch
+//
+template<typename Key, typename Compare>
+void BasicConcurrentBSTree<Key, Compare>::retire(Node *node) {
+	node->m_retiredEpoch = m_epochs.getEpoch();
+	Node *head = m_retired.load(memory_order_relaxed);
+	do {
+		node->m_retiredNext = head;
+	} while(!m_retired.compare_exchange_weak(head, node, memory_order_release, memory_order_relaxed));
+	m_retiredCount.fetch_add(1, memory_order_relaxed);
+}
+
+// reclaim: reclamation helper
+// Takes the whole of m_retired, frees what no reader can reach and pushes
+// the rest back. The list is taken before the epoch advances, so every node
+// taken was unlinked before the readers are scanned: a reader the scan
+// misses cannot reach it. Several threads may reclaim at once; each frees
+// only the nodes it took.
+// preconditions:	the calling thread is not reading the tree, or what it
+//					reads is not retired.
+// postconditions:	the retired nodes no reader can reach are deleted
+//
+template<typename Key, typename Compare>
+void BasicConcurrentBSTree<Key, Compare>::reclaim() {
+	Node *node = m_retired.exchange(nullptr, memory_order_acquire);
+	m_epochs.advance();
+	uint64_t oldest = m_epochs.oldestReader();
+	Node *kept = nullptr;
+	Node *keptTail = nullptr;
+	int freed = 0;
+	while(node != nullptr) {
+		Node *next = node->m_retiredNext;
+		if(node->m_retiredEpoch < oldest) {
+			delete node;
+			freed++;
+		} else {
+			node->m_retiredNext = kept;
+			kept = node;
+			if(keptTail == nullptr) {
+				keptTail = node;
+			}
+		}
+		node = next;
+	}
+	if(kept != nullptr) {
+		Node *head = m_retired.load(memory_order_relaxed);
+		do {
+			keptTail->m_retiredNext = head;
+		} while(!m_retired.compare_exchange_weak(head, kept, memory_order_release, memory_order_relaxed));
+	}
+	m_retiredCount.fetch_sub(freed, memory_order_relaxed);
+}
+
+// deleteSubtree: makeEmpty helper
+// preconditions:	no other thread is using the tree.
+// postconditions:	every node below link, link's own node included, is
+//					deleted
+//
+template<typename Key, typename Compare>
+void BasicConcurrentBSTree<Key, Compare>::deleteSubtree(uintptr_t link) {
+	vector<Node*> stack;
+	if(nodeOf(link) != nullptr) {
+		stack.push_back(nodeOf(link));
+	}
+	while(!stack.empty()) {
+		Node *node = stack.back();
+		stack.pop_back();
+		if(!node->isLeaf()) {
+			stack.push_back(nodeOf(node->m_left.load()));
+			stack.push_back(nodeOf(node->m_right.load()));
+		}
+		delete node;
+	}
+}
+
+// nodeOf: link helper
+// preconditions:	none
+// postconditions:	the node link points at, without its marks, is returned
+//
+template<typename Key, typename Compare>
+typename BasicConcurrentBSTree<Key, Compare>::Node* BasicConcurrentBSTree<Key, Compare>::nodeOf(uintptr_t link) {
+	return(reinterpret_cast<Node*>(link & ~LINK_BITS));
+}
+
+// linkTo: link helper
+// preconditions:	none
+// postconditions:	an unmarked link to node is returned
+//
+template<typename Key, typename Compare>
+uintptr_t BasicConcurrentBSTree<Key, Compare>::linkTo(const Node *node) {
+	return(reinterpret_cast<uintptr_t>(node));
+}
+
+// isLess: comparison helper
+// preconditions:	none
+// postconditions:	true is returned if data orders before the key of node,
+//					which is always so for a sentinel
+//
+template<typename Key, typename Compare>
+bool BasicConcurrentBSTree<Key, Compare>::isLess(const Key &data, const Node *node) const {
+	return(node->m_infinity > 0 || m_compare(data, node->item()));
+}
+
+// isEqual: comparison helper
+// preconditions:	none
+// postconditions:	true is returned if node holds a key and neither it nor
+//					data orders before the other
+//
+template<typename Key, typename Compare>
+bool BasicConcurrentBSTree<Key, Compare>::isEqual(const Key &data, const Node *node) const {
+	return(node->m_infinity == 0 && !m_compare(data, node->item()) && !m_compare(node->item(), data));
+}
+
+// write: output helper
+// Formats every present key in order into out. Keys live in the leaves, so
+// the routing nodes are passed over.
+// preconditions:	the calling thread is reading the tree.
+// postconditions:	each key present is appended to out
+//
+template<typename Key, typename Compare>
+void BasicConcurrentBSTree<Key, Compare>::write(OutputBuffer &out) const {
+	vector<const Node*> stack;
+	stack.push_back(m_root);
+	while(!stack.empty()) {
+		const Node *node = stack.back();
+		stack.pop_back();
+		if(!node->isLeaf()) {
+			stack.push_back(nodeOf(node->m_right.load(memory_order_acquire)));
+			stack.push_back(nodeOf(node->m_left.load(memory_order_acquire)));
+			continue;
+		}
+		int count = node->m_itemCount.load(memory_order_acquire);
+		if(node->m_infinity == 0 && count >= MIN_ITEM_COUNT) {
+			KeyTraits<Key>::format(out, node->item());
+			out.append(' ');
+			out.appendInt(count);
+			out.append('\n');
+		}
+	}
+}
+
+// output
+// Prints the contents of the tree to the ostream
+// preconditions:	tree must be a valid BasicConcurrentBSTree object (must
+//					not reference a dereferenced nullptr).
+// postconditions:	the contents of tree are printed to the ostream. Each
+//					line contains a key in the format:
+//						"m_item m_itemCount"
+//
+template<typename Key, typename Compare>
+ostream& operator<<(ostream &sout, const BasicConcurrentBSTree<Key, Compare> &tree) {
+	tree.write(sout);
+	return(sout);
+}
+#endif
\ No newline at end of file
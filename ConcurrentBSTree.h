@@ -0,0 +1,440 @@
+// ConcurrentBSTree.h		Author: Sam Hoover
+// contains the declarations for the BasicConcurrentBSTree class template and
+// the ConcurrentBSTree type, a lock-free tree shared between threads
+//
+#ifndef CONCURRENTBSTREE_H
+#define CONCURRENTBSTREE_H
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <utility>
+#include <vector>
+#include "BSTree.h"
+#include "KeyTraits.h"
+#include "OutputBuffer.h"
+#include "RcuReaders.h"
+#include "TreeData.h"
+using namespace std;
+
+// CONCURRENT_RECLAIM_THRESHOLD
+// the number of retired nodes waiting to be freed at which the thread that
+// retires one more starts a reclamation pass
+//
+const int CONCURRENT_RECLAIM_THRESHOLD = 256;
+
+// BasicConcurrentBSTree
+// A binary search tree class template that may be used by many threads at
+// once without a lock. It stores Key objects ordered by Compare with the same
+// duplicate-count rules as BasicBSTree: inserting a key already present
+// increments its m_itemCount, and removing a key decrements it until the key
+// is gone.
+//
+// NOT BALANCED: the tree is never rebalanced. Its shape depends only on the
+// order keys arrive in, so keys inserted in sorted (or nearly sorted) order
+// build a chain, and every operation on that chain takes time proportional
+// to the number of keys. Shuffle bulk loads before inserting them, or use
+// ShardedBSTree or RcuBSTree with the AVL BalancePolicy when the input order
+// cannot be controlled.
+//
+// The tree is the external tree of Natarajan and Mittal: keys are held in
+// leaves, and internal nodes only route searches. An insert replaces a leaf
+// with a routing node over the old leaf and a new one, in a single
+// compare-and-swap. A remove first takes the count of a leaf from
+// MIN_ITEM_COUNT to 0 (the moment the key stops being present), then marks
+// the leaf's link (FLAG_BIT) and its sibling's link (TAG_BIT) so no thread
+// can change them, and swings the link above the leaf's parent to the
+// sibling. A thread that meets a marked link finishes the unlinking before
+// retrying, so no operation waits for another.
+//
+// Unlinked nodes are retired and freed once no thread can still reach them,
+// using the reader epochs in m_epochs: every operation announces itself as a
+// reader for its duration. A pointer returned by retrieve stays valid only
+// while the calling thread holds a ReadGuard on the tree.
+//
+// Keys are ordered in the format:
+//			key < routing key = search(left)
+//			key >= routing key = search(right)
+//
+template<typename Key, typename Compare = less<Key> >
+class BasicConcurrentBSTree {
+
+	// output
+	// Prints the contents of the tree to the ostream
+	// preconditions:	this not equal to nullptr.
+	// postconditions:	each key present is printed in order, one per line,
+	//					in the format: "m_item m_itemCount"
+	//
+	template<typename K, typename C>
+	friend ostream& operator<<(ostream &sout, const BasicConcurrentBSTree<K, C> &tree);
+
+	struct Node;
+
+public:
+	// ReadGuard
+	// Marks a read-side critical section on a tree. Nodes seen while a guard
+	// is held, and pointers returned by retrieve, are not freed until the
+	// guard is destroyed. Guards may be nested.
+	//
+	class ReadGuard {
+	public:
+		// constructor(const BasicConcurrentBSTree &tree)
+		// preconditions:	tree must outlive the guard.
+		// postconditions:	the calling thread is reading tree
+		//
+		explicit ReadGuard(const BasicConcurrentBSTree &tree);
+
+		// destructor
+		// preconditions:	the guard is destroyed by the thread that made it.
+		// postconditions:	the calling thread's read of tree has ended if
+		//					this was the outermost guard
+		//
+		~ReadGuard();
+
+	private:
+		// copying a guard is not supported
+		ReadGuard(const ReadGuard &guard);
+		const ReadGuard& operator=(const ReadGuard &guard);
+
+		const BasicConcurrentBSTree &m_tree;
+	};
+
+	// CONSTRUCTORS/DESTRUCTOR
+
+	// default constructor
+	// preconditions:	none
+	// postconditions:	Creates an empty tree (only the sentinel nodes)
+	//
+	BasicConcurrentBSTree();
+
+	// destructor
+	// preconditions:	no other thread is using the tree.
+	// postconditions:	every node, retired or not, is deleted
+	//
+	~BasicConcurrentBSTree();
+
+	// MUTATORS
+
+	// insert(const Key &data)
+	// Inserts a copy of data into the tree. If a leaf containing an equal
+	// object already exists in the tree, its m_itemCount is incremented by
+	// one. Safe to call from any number of threads.
+	// preconditions:	data must be a valid Key object (must not reference
+	//					a dereferenced nullptr); this not equal to nullptr.
+	// postconditions:	If data was not present in the tree, it becomes
+	//					present with m_itemCount equal to 1 and true is
+	//					returned. If data was present, then m_itemCount is
+	//					incremented by one and false is returned.
+	//
+	bool insert(const Key &data);
+
+	// insert(Key *data)
+	// Deprecated: use insert(const Key&) or emplace. Only a copy of *data
+	// enters the tree, so data stays owned by the caller.
+	// preconditions:	data must be a valid Key object not equal to
+	//					nullptr; this not equal to nullptr.
+	// postconditions:	the same as insert(*data); data is left to the caller.
+	//
+	bool insert(Key *data);
+
+	// emplace
+	// Constructs a Key from args and inserts it into the tree, following the
+	// same rules as insert. Safe to call from any number of threads.
+	// preconditions:	args must be valid arguments to a Key constructor;
+	//					this not equal to nullptr.
+	// postconditions:	If the constructed item was not present in the tree,
+	//					it becomes present and true is returned. Otherwise its
+	//					m_itemCount is incremented by one and false is
+	//					returned.
+	//
+	template<typename... Args>
+	bool emplace(Args&&... args);
+
+	// remove
+	// Removes a Key object equal to data from the tree. Safe to call from any
+	// number of threads.
+	// preconditions:	data must be a valid Key object (must not reference
+	//					a dereferenced nullptr); this not equal to nullptr.
+	// postconditions:	If data is not present, then false is returned.
+	//					Otherwise m_itemCount is decremented by one and true is
+	//					returned; when it reaches 0 the key's leaf and the
+	//					routing node above it are unlinked and retired.
+	//
+	bool remove(const Key &data);
+
+	// makeEmpty
+	// Removes and deletes all nodes from the tree, including retired ones,
+	// leaving only the sentinel nodes.
+	// preconditions:	no other thread is using the tree.
+	// postconditions:	the tree is empty and no retired node is waiting
+	//
+	void makeEmpty();
+
+	// ACCESSORS
+
+	// retrieve
+	// Searches the tree for data, if found, a const pointer to that object is
+	// returned. The pointer stays valid only while the calling thread holds
+	// a ReadGuard on the tree, as the key may be removed and its leaf freed
+	// by another thread.
+	// preconditions:	data must be a valid Key object (must not reference
+	//					a dereferenced nullptr); this not equal to nullptr.
+	// postconditions:	If data is present in the tree, a const pointer to the
+	//					stored object is returned. If data is not present then
+	//					nullptr is returned.
+	//
+	const Key* retrieve(const Key &data) const;
+
+	// depth
+	// Finds the depth of the leaf holding data, counted in routing nodes
+	// from the top of the tree's keys: a tree holding one key has it at
+	// depth 1.
+	// preconditions:	data must be a valid Key object (must not reference
+	//					a dereferenced nullptr); this not equal to nullptr.
+	// postconditions:	If data is present in the tree, the depth of its leaf
+	//					is returned. If data is not present, -1 is returned.
+	//
+	int depth(const Key &data) const;
+
+	// size
+	// Returns the number of distinct keys present in the tree. While other
+	// threads are writing, the value may lag their most recent changes.
+	// preconditions:	this not equal to nullptr.
+	// postconditions:	m_keyCount is returned
+	//
+	int size() const;
+
+	// isEmpty
+	// Checks whether any key is present in the tree.
+	// preconditions:	this not equal to nullptr.
+	// postconditions:	true is returned if no key is present; otherwise false
+	//					is returned.
+	//
+	bool isEmpty() const;
+
+	// write
+	// Writes the contents of the tree to sout in the same format as
+	// operator<<. Safe to call while other threads write; each key is
+	// reported with the count it held when it was visited.
+	// preconditions:	this not equal to nullptr.
+	// postconditions:	each key present is written to sout. false is
+	//					returned if sout failed.
+	//
+	bool write(ostream &sout) const;
+
+	// write
+	// Writes the contents of the tree to the file descriptor fd in the same
+	// format as operator<<.
+	// preconditions:	fd must be open for writing; this not equal to nullptr.
+	// postconditions:	each key present is written to fd. false is returned
+	//					if a write failed.
+	//
+	bool write(int fd) const;
+
+	// getRetiredCount
+	// Returns the number of unlinked nodes not yet freed. It stays near
+	// CONCURRENT_RECLAIM_THRESHOLD unless a thread holds a ReadGuard for a
+	// long time.
+	// preconditions:	this not equal to nullptr.
+	// postconditions:	m_retiredCount is returned
+	//
+	int getRetiredCount() const;
+
+private:
+	// FLAG_BIT, TAG_BIT, LINK_BITS
+	// the marks kept in the low bits of a link: FLAG_BIT on the link to a
+	// leaf being removed, TAG_BIT on the link to its sibling. A marked link
+	// never changes again.
+	//
+	static const uintptr_t FLAG_BIT = 1;
+	static const uintptr_t TAG_BIT = 2;
+	static const uintptr_t LINK_BITS = FLAG_BIT | TAG_BIT;
+
+	// Node
+	// A leaf holds a key and its count; a routing node holds a copy of a key
+	// and two links. Sentinel nodes (m_infinity > 0) hold no key and order
+	// after every key, by m_infinity. m_item is built in m_storage before the
+	// node is published and never changes.
+	//
+	struct Node {
+		// constructor(const Key &data, Node *left, Node *right)
+		// preconditions:	data must be a valid Key object
+		// postconditions:	Creates a node holding a copy of data with
+		//					m_itemCount equal to MIN_ITEM_COUNT and the given
+		//					children; a leaf if both are nullptr
+		//
+		Node(const Key &data, Node *left, Node *right);
+
+		// constructor(Node *left, Node *right, int infinity)
+		// The children come first so that the call cannot be confused with
+		// the one above when Key is an integer.
+		// preconditions:	infinity > 0
+		// postconditions:	Creates a sentinel node with no key
+		//
+		Node(Node *left, Node *right, int infinity);
+
+		// destructor
+		// preconditions:	none
+		// postconditions:	m_item is destroyed if the node holds one
+		//
+		~Node();
+
+		// item
+		// preconditions:	m_infinity equal to 0
+		// postconditions:	the key held by the node is returned
+		//
+		const Key& item() const;
+
+		// isLeaf
+		// preconditions:	none
+		// postconditions:	true is returned if the node has no children
+		//
+		bool isLeaf() const;
+
+		alignas(Key) unsigned char m_storage[sizeof(Key)];
+		int m_infinity;
+		atomic<int> m_itemCount;
+		atomic<uintptr_t> m_left;
+		atomic<uintptr_t> m_right;
+		Node *m_retiredNext;
+		uint64_t m_retiredEpoch;
+	};
+
+	// SeekRecord
+	// The last four nodes of a search: the leaf it ended at, the leaf's
+	// parent, and the lowest link above the parent that is not tagged
+	// (from m_ancestor to m_successor).
+	//
+	struct SeekRecord {
+		Node *m_ancestor;
+		Node *m_successor;
+		Node *m_parent;
+		Node *m_leaf;
+	};
+
+	// copying a shared tree is not supported
+	BasicConcurrentBSTree(const BasicConcurrentBSTree &tree);
+	const BasicConcurrentBSTree& operator=(const BasicConcurrentBSTree &tree);
+
+	// beginRead / endRead: ReadGuard helpers
+	// preconditions:	endRead follows a beginRead on the same thread.
+	// postconditions:	the calling thread's slot announces the current epoch
+	//					while at least one read is open, and 0 otherwise
+	//
+	void beginRead() const;
+	void endRead() const;
+
+	// add: insert helper
+	// Makes data present in the tree, or increments its m_itemCount.
+	// preconditions:	data must be a valid Key object; the calling thread
+	//					is reading the tree.
+	// postconditions:	true is returned if data was not present before.
+	//
+	bool add(const Key &data);
+
+	// erase: remove helper
+	// Takes one count of data away, unlinking its leaf when the last goes.
+	// preconditions:	data must be a valid Key object; the calling thread
+	//					is reading the tree.
+	// postconditions:	true is returned if data was present.
+	//
+	bool erase(const Key &data);
+
+	// unlinkLeaf: remove helper
+	// Marks the link to leaf and cleans it up, helping any other removal in
+	// the way, until leaf is no longer in the tree.
+	// preconditions:	leaf holds data and has m_itemCount 0; the calling
+	//					thread is reading the tree.
+	// postconditions:	leaf is unlinked, by this or another thread
+	//
+	void unlinkLeaf(const Key &data, Node *leaf);
+
+	// cleanup: remove helper
+	// Tags the sibling of the flagged leaf under record.m_parent and swings
+	// the link from record.m_ancestor to that sibling, retiring every node
+	// it cuts off.
+	// preconditions:	a link of record.m_parent is flagged; the calling
+	//					thread is reading the tree.
+	// postconditions:	true is returned if this call did the unlinking.
+	//
+	bool cleanup(const Key &data, const SeekRecord &record);
+
+	// seek: search helper
+	// preconditions:	data must be a valid Key object; the calling thread
+	//					is reading the tree.
+	// postconditions:	record describes the path to the leaf where data is
+	//					or would be. If depth is not nullptr it is set to the
+	//					leaf's depth below m_root's key subtree.
+	//
+	void seek(const Key &data, SeekRecord &record, int *depth = nullptr) const;
+
+	// retire: reclamation helper
+	// preconditions:	node is unlinked and no other thread will retire it.
+	// postconditions:	node is pushed onto m_retired with the current epoch
+	//
+	void retire(Node *node);
+
+	// reclaim: reclamation helper
+	// Starts a new epoch and frees every retired node from an earlier epoch
+	// than the oldest active reader's.
+	// preconditions:	the calling thread is not reading the tree, or what it
+	//					reads is not retired.
+	// postconditions:	the retired nodes no reader can reach are deleted
+	//
+	void reclaim();
+
+	// deleteSubtree: makeEmpty helper
+	// preconditions:	no other thread is using the tree.
+	// postconditions:	every node below link, link's own node included, is
+	//					deleted
+	//
+	static void deleteSubtree(uintptr_t link);
+
+	// nodeOf, linkTo: link helpers
+	// preconditions:	none
+	// postconditions:	the node a link points at, and a clean link to node,
+	//					are returned
+	//
+	static Node* nodeOf(uintptr_t link);
+	static uintptr_t linkTo(const Node *node);
+
+	// isLess: comparison helper
+	// preconditions:	none
+	// postconditions:	true is returned if data orders before the key of
+	//					node, which is always so for a sentinel
+	//
+	bool isLess(const Key &data, const Node *node) const;
+
+	// isEqual: comparison helper
+	// preconditions:	none
+	// postconditions:	true is returned if node holds a key and neither it
+	//					nor data orders before the other
+	//
+	bool isEqual(const Key &data, const Node *node) const;
+
+	// write: output helper
+	// Formats every present key in order into out.
+	// preconditions:	the calling thread is reading the tree.
+	// postconditions:	each key present is appended to out
+	//
+	void write(OutputBuffer &out) const;
+
+	// m_root
+	// the sentinel routing node at the top, over a second sentinel whose
+	// left subtree holds every key
+	//
+	Node *m_root;
+	atomic<int> m_keyCount;
+	atomic<Node*> m_retired;
+	atomic<int> m_retiredCount;
+	mutable RcuEpochs m_epochs;
+	Compare m_compare;
+};
+
+// ConcurrentBSTree
+// the concurrent tree of TreeData objects
+//
+typedef BasicConcurrentBSTree<TreeData> ConcurrentBSTree;
+
+#include "ConcurrentBSTree.cpp"
+#endif
\ No newline at end of file
@@ -0,0 +1,217 @@
+// DenseCharTree.cpp		Author: Sam Hoover
+// contains the definitions for the DenseCharTree class
+//
+#ifndef DENSECHARTREE_CPP
+#define DENSECHARTREE_CPP
+#include "DenseCharTree.h"
+
+// default constructor
+// preconditions:	none
+// postconditions:	Creates an empty tree (every count equal to 0)
+//
+DenseCharTree::DenseCharTree() {
+	makeEmpty();
+}
+
+// constructor(char *data)
+// preconditions:	none
+// postconditions:	If data is not a nullptr, *data is inserted with a
+//					count of one and data is left to the caller.
+//					Otherwise the tree is empty.
+//
+DenseCharTree::DenseCharTree(char *data) {
+	makeEmpty();
+	if(data != nullptr) {
+		insert(*data);
+	}
+}
+
+// copy constructor
+// preconditions:	tree must be a valid DenseCharTree object
+// postconditions:	this holds the same keys and counts as tree
+//
+DenseCharTree::DenseCharTree(const DenseCharTree &tree) {
+	*this = tree;
+}
+
+// destructor
+// preconditions:	none
+// postconditions:	none; the counts are stored inline
+//
+DenseCharTree::~DenseCharTree() {}
+
+// insert(char data)
+// Inserts data into the tree, incrementing its count if already present.
+// preconditions:	none
+// postconditions:	true is returned if data was not already present,
+//					else its count is incremented and false is returned.
+//
+bool DenseCharTree::insert(char data) {
+	return(emplace(data));
+}
+
+// insert(char *data)
+// Deprecated: use insert(char) or emplace. *data is copied in and data is
+// left to the caller.
+// preconditions:	data must not be nullptr.
+// postconditions:	the same as insert(*data).
+//
+bool DenseCharTree::insert(char *data) {
+	return(insert(*data));
+}
+
+// emplace
+// Inserts data into the tree, incrementing its count if already present.
+// preconditions:	none
+// postconditions:	true is returned if data was not already present,
+//					else its count is incremented and false is returned.
+//
+bool DenseCharTree::emplace(char data) {
+	if(m_counts[index(data)]++ == 0) {
+		m_keyCount++;
+		return(true);
+	}
+	return(false);
+}
+
+// remove
+// Removes one occurrence of data from the tree.
+// preconditions:	none
+// postconditions:	If data is not present false is returned. Otherwise
+//					its count is decremented (to zero when it was
+//					MIN_ITEM_COUNT) and true is returned.
+//
+bool DenseCharTree::remove(const char &data) {
+	int &count = m_counts[index(data)];
+	if(count == 0) {
+		return(false);
+	}
+	if(count > MIN_ITEM_COUNT) {
+		count--;
+	} else {
+		count = 0;
+		m_keyCount--;
+	}
+	return(true);
+}
+
+// makeEmpty
+// Removes every key from the tree.
+// preconditions:	none
+// postconditions:	every count is 0
+//
+void DenseCharTree::makeEmpty() {
+	for(int i = 0; i < DENSE_KEY_COUNT; i++) {
+		m_counts[i] = 0;
+	}
+	m_keyCount = 0;
+}
+
+// retrieve
+// Searches the tree for data.
+// preconditions:	none
+// postconditions:	If data is present a const pointer to a char equal to
+//					data is returned, otherwise nullptr is returned.
+//
+const char* DenseCharTree::retrieve(const char &data) const {
+	if(m_counts[index(data)] == 0) {
+		return(nullptr);
+	}
+	return(&keyTable()[index(data)]);
+}
+
+// isEmpty
+// Returns true is tree is empty, else false
+// preconditions:	none
+// postconditions:	If no key is present true is returned, else false
+//
+bool DenseCharTree::isEmpty() const {
+	return(m_keyCount == 0);
+}
+
+// assignment
+// Sets this equal to tree.
+// preconditions:	tree must be a valid DenseCharTree object
+// postconditions:	this holds the same keys and counts as tree
+//
+const DenseCharTree& DenseCharTree::operator=(const DenseCharTree &tree) {
+	if(this != &tree) {
+		for(int i = 0; i < DENSE_KEY_COUNT; i++) {
+			m_counts[i] = tree.m_counts[i];
+		}
+		m_keyCount = tree.m_keyCount;
+	}
+	return(*this);
+}
+
+// equality
+// Returns true only if both trees hold the same keys with the same counts
+// preconditions:	tree must be a valid DenseCharTree object
+// postconditions:	true is returned if every count matches, else false
+//
+bool DenseCharTree::operator==(const DenseCharTree &tree) const {
+	if(m_keyCount != tree.m_keyCount) {
+		return(false);
+	}
+	for(int i = 0; i < DENSE_KEY_COUNT; i++) {
+		if(m_counts[i] != tree.m_counts[i]) {
+			return(false);
+		}
+	}
+	return(true);
+}
+
+// inequality
+// Returns true if the trees differ in any key or count
+// preconditions:	tree must be a valid DenseCharTree object
+// postconditions:	true is returned if any count differs, else false
+//
+bool DenseCharTree::operator!=(const DenseCharTree &tree) const {
+	return(!(*this == tree));
+}
+
+// index: helper
+// Maps a key to its slot in m_counts.
+// preconditions:	none
+// postconditions:	the unsigned value of data is returned
+//
+int DenseCharTree::index(char data) {
+	return(static_cast<unsigned char>(data));
+}
+
+// keyTable: retrieve helper
+// Returns a table holding every char value at its own index, so retrieve
+// can return a stable pointer to a key.
+// preconditions:	none
+// postconditions:	a pointer to the DENSE_KEY_COUNT entry table is returned
+//
+const char* DenseCharTree::keyTable() {
+	struct Table {
+		Table() {
+			for(int i = 0; i < DENSE_KEY_COUNT; i++) {
+				m_keys[i] = static_cast<char>(i);
+			}
+		}
+		char m_keys[DENSE_KEY_COUNT];
+	};
+	static const Table table;
+	return(table.m_keys);
+}
+
+// output
+// Prints the contents of the tree to the ostream
+// preconditions:	this not equal to nullptr.
+// postconditions:	each key present is printed in ascending order, one
+//					per line, in the format: "key count"
+//
+ostream& operator<<(ostream &sout, const DenseCharTree &tree) {
+	// walk in less<char> order, which is signed order when char is signed
+	for(int c = CHAR_MIN; c <= CHAR_MAX; c++) {
+		int count = tree.m_counts[DenseCharTree::index(static_cast<char>(c))];
+		if(count > 0) {
+			sout << static_cast<char>(c) << " " << count << '\n';
+		}
+	}
+	return(sout);
+}
+#endif
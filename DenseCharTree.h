@@ -0,0 +1,170 @@
+// DenseCharTree.h		Author: Sam Hoover
+// contains the declarations for the DenseCharTree class
+//
+#ifndef DENSECHARTREE_H
+#define DENSECHARTREE_H
+#include <climits>
+#include "BSTree.h"
+
+// DENSE_KEY_COUNT
+// the number of distinct values a char key can take
+//
+const int DENSE_KEY_COUNT = UCHAR_MAX + 1;
+
+// DenseCharTree
+// A multiset of char keys for callers that only need counting. A plain char
+// has only DENSE_KEY_COUNT possible values, so instead of a tree the keys are
+// kept in a count array indexed by the key (m_counts). insert, remove and
+// retrieve are O(1) and output is a linear scan of the array in less<char>
+// order.
+//
+// DenseCharTree is its own type rather than a specialization of BasicBSTree,
+// whose full interface (iterators, rank, set operations, snapshots and so
+// on) it does not offer; BasicBSTree<char> is the ordinary tree.
+//
+// Counts follow the same rules as BasicBSTree: inserting a key already
+// present increments its count, and removing a key decrements its count until
+// it reaches MIN_ITEM_COUNT, at which point the key is removed. There are no
+// nodes, so the structural queries depth and descendants are not provided.
+//
+class DenseCharTree {
+
+	// output
+	// Prints the contents of the tree to the ostream
+	// preconditions:	this not equal to nullptr.
+	// postconditions:	each key present is printed in ascending order, one
+	//					per line, in the format: "key count"
+	//
+	friend ostream& operator<<(ostream &sout, const DenseCharTree &tree);
+
+public:
+	// default constructor
+	// preconditions:	none
+	// postconditions:	Creates an empty tree (every count equal to 0)
+	//
+	DenseCharTree();
+
+	// constructor(char *data)
+	// preconditions:	none
+	// postconditions:	If data is not a nullptr, *data is inserted with a
+	//					count of one and data is left to the caller.
+	//					Otherwise the tree is empty.
+	//
+	DenseCharTree(char *data);
+
+	// copy constructor
+	// preconditions:	tree must be a valid DenseCharTree object
+	// postconditions:	this holds the same keys and counts as tree
+	//
+	DenseCharTree(const DenseCharTree &tree);
+
+	// destructor
+	// preconditions:	none
+	// postconditions:	none; the counts are stored inline
+	//
+	~DenseCharTree();
+
+	// insert(char data)
+	// Inserts data into the tree, incrementing its count if already present.
+	// preconditions:	none
+	// postconditions:	true is returned if data was not already present,
+	//					else its count is incremented and false is returned.
+	//
+	bool insert(char data);
+
+	// insert(char *data)
+	// Deprecated: use insert(char) or emplace. *data is copied in and data is
+	// left to the caller.
+	// preconditions:	data must not be nullptr.
+	// postconditions:	the same as insert(*data).
+	//
+	bool insert(char *data);
+
+	// emplace
+	// Inserts data into the tree, incrementing its count if already present.
+	// preconditions:	none
+	// postconditions:	true is returned if data was not already present,
+	//					else its count is incremented and false is returned.
+	//
+	bool emplace(char data);
+
+	// remove
+	// Removes one occurrence of data from the tree.
+	// preconditions:	none
+	// postconditions:	If data is not present false is returned. Otherwise
+	//					its count is decremented (to zero when it was
+	//					MIN_ITEM_COUNT) and true is returned.
+	//
+	bool remove(const char &data);
+
+	// makeEmpty
+	// Removes every key from the tree.
+	// preconditions:	none
+	// postconditions:	every count is 0
+	//
+	void makeEmpty();
+
+	// retrieve
+	// Searches the tree for data.
+	// preconditions:	none
+	// postconditions:	If data is present a const pointer to a char equal to
+	//					data is returned, otherwise nullptr is returned.
+	//
+	const char* retrieve(const char &data) const;
+
+	// isEmpty
+	// Returns true is tree is empty, else false
+	// preconditions:	none
+	// postconditions:	If no key is present true is returned, else false
+	//
+	bool isEmpty() const;
+
+	// assignment
+	// Sets this equal to tree.
+	// preconditions:	tree must be a valid DenseCharTree object
+	// postconditions:	this holds the same keys and counts as tree
+	//
+	const DenseCharTree& operator=(const DenseCharTree &tree);
+
+	// equality
+	// Returns true only if both trees hold the same keys with the same counts
+	// preconditions:	tree must be a valid DenseCharTree object
+	// postconditions:	true is returned if every count matches, else false
+	//
+	bool operator==(const DenseCharTree &tree) const;
+
+	// inequality
+	// Returns true if the trees differ in any key or count
+	// preconditions:	tree must be a valid DenseCharTree object
+	// postconditions:	true is returned if any count differs, else false
+	//
+	bool operator!=(const DenseCharTree &tree) const;
+
+private:
+	// m_counts
+	// the count of each key, indexed by the key's unsigned value
+	//
+	int m_counts[DENSE_KEY_COUNT];
+
+	// m_keyCount
+	// the number of distinct keys present
+	//
+	int m_keyCount;
+
+	// index: helper
+	// Maps a key to its slot in m_counts.
+	// preconditions:	none
+	// postconditions:	the unsigned value of data is returned
+	//
+	static int index(char data);
+
+	// keyTable: retrieve helper
+	// Returns a table holding every char value at its own index, so retrieve
+	// can return a stable pointer to a key.
+	// preconditions:	none
+	// postconditions:	a pointer to the DENSE_KEY_COUNT entry table is returned
+	//
+	static const char* keyTable();
+};
+
+#endif
@@ -0,0 +1,344 @@
+// FrozenIndex.cpp		Author: Sam Hoover
+// contains the definitions for the BasicFrozenIndex class template. This
+// file is included at the bottom of FrozenIndex.h and needs no separate
+// compilation
+//
+#ifndef FROZENINDEX_CPP
+#define FROZENINDEX_CPP
+#include "FrozenIndex.h"
+
+// const_iterator default constructor
+// preconditions:	none
+// postconditions:	creates an iterator that refers to no index
+//
+template<typename Key, typename Compare>
+BasicFrozenIndex<Key, Compare>::const_iterator::const_iterator() : m_index(nullptr), m_position(0) {}
+
+// const_iterator constructor(const BasicFrozenIndex *index, size_t position)
+// preconditions:	position <= index->m_count
+// postconditions:	creates an iterator at position
+//
+template<typename Key, typename Compare>
+BasicFrozenIndex<Key, Compare>::const_iterator::const_iterator(const BasicFrozenIndex *index,
+		size_t position) : m_index(index), m_position(position) {}
+
+// const_iterator dereference
+// preconditions:	this must not be an end iterator.
+// postconditions:	the current key is returned
+//
+template<typename Key, typename Compare>
+typename BasicFrozenIndex<Key, Compare>::const_iterator::reference
+BasicFrozenIndex<Key, Compare>::const_iterator::operator*() const {
+	return(m_index->m_keys[m_position]);
+}
+
+// const_iterator member access
+// preconditions:	this must not be an end iterator.
+// postconditions:	a pointer to the current key is returned
+//
+template<typename Key, typename Compare>
+typename BasicFrozenIndex<Key, Compare>::const_iterator::pointer
+BasicFrozenIndex<Key, Compare>::const_iterator::operator->() const {
+	return(&m_index->m_keys[m_position]);
+}
+
+// const_iterator getCount
+// Returns the number of occurrences of the current key.
+// preconditions:	this must not be an end iterator.
+// postconditions:	the current key's count is returned
+//
+template<typename Key, typename Compare>
+int BasicFrozenIndex<Key, Compare>::const_iterator::getCount() const {
+	return(m_index->m_counts[m_position]);
+}
+
+// const_iterator pre-increment
+// Moves to the next key in ascending order.
+// preconditions:	this must not be an end iterator.
+// postconditions:	this refers to the next key, or is the end iterator if
+//					there is none. this is returned.
+//
+template<typename Key, typename Compare>
+typename BasicFrozenIndex<Key, Compare>::const_iterator&
+BasicFrozenIndex<Key, Compare>::const_iterator::operator++() {
+	m_position = m_index->successor(m_position);
+	return(*this);
+}
+
+// const_iterator post-increment
+// preconditions:	this must not be an end iterator.
+// postconditions:	this is advanced; its old position is returned
+//
+template<typename Key, typename Compare>
+typename BasicFrozenIndex<Key, Compare>::const_iterator
+BasicFrozenIndex<Key, Compare>::const_iterator::operator++(int) {
+	const_iterator old = *this;
+	++(*this);
+	return(old);
+}
+
+// const_iterator equality
+// preconditions:	other must iterate over the same index.
+// postconditions:	true is returned if both refer to the same key or both
+//					are end iterators.
+//
+template<typename Key, typename Compare>
+bool BasicFrozenIndex<Key, Compare>::const_iterator::operator==(const const_iterator &other) const {
+	return(m_position == other.m_position);
+}
+
+// const_iterator inequality
+// preconditions:	other must iterate over the same index.
+// postconditions:	true is returned if the iterators differ.
+//
+template<typename Key, typename Compare>
+bool BasicFrozenIndex<Key, Compare>::const_iterator::operator!=(const const_iterator &other) const {
+	return(!(*this == other));
+}
+
+// BasicFrozenIndex default constructor
+// preconditions:	none
+// postconditions:	creates an empty index
+//
+template<typename Key, typename Compare>
+BasicFrozenIndex<Key, Compare>::BasicFrozenIndex() : m_count(0), m_height(0), m_compare() {}
+
+// retrieve
+// Searches the index for data, if found, a const pointer to that key is
+// returned.
+// preconditions:	data must be a valid Key object (must not reference
+//					a dereferenced nullptr); this not equal to nullptr.
+// postconditions:	If data is found, a const pointer to the key equal to
+//					data is returned; else nullptr is returned.
+//
+template<typename Key, typename Compare>
+const Key* BasicFrozenIndex<Key, Compare>::retrieve(const Key &data) const {
+	size_t position = search(data);
+	if(position == 0 || m_compare(data, m_keys[position])) {
+		return(nullptr);
+	}
+	return(&m_keys[position]);
+}
+
+// depth
+// Finds the depth of data in the complete tree the index is laid out as.
+// Depth of the root is 0; no key is deeper than floor(log2(size())).
+// preconditions:	data must be a valid Key object (must not reference
+//					a dereferenced nullptr); this not equal to nullptr.
+// postconditions:	If data is found, its depth is returned. If data is not
+//					found, -1 is returned.
+//
+template<typename Key, typename Compare>
+int BasicFrozenIndex<Key, Compare>::depth(const Key &data) const {
+	size_t position = search(data);
+	if(position == 0 || m_compare(data, m_keys[position])) {
+		return(VALUE_NOT_FOUND);
+	}
+	return(level(position));
+}
+
+// rank
+// Counts the distinct keys ordered before data. Runs in O(log n) from the
+// shape of the complete tree alone.
+// preconditions:	data must be a valid Key object (must not reference
+//					a dereferenced nullptr); this not equal to nullptr.
+// postconditions:	the number of keys ordered before data is returned,
+//					whether or not data is in the index.
+//
+template<typename Key, typename Compare>
+int BasicFrozenIndex<Key, Compare>::rank(const Key &data) const {
+	size_t position = 1;
+	size_t before = 0;
+	int depth = 0;
+	while(position <= m_count) {
+		// passing a key to its right puts it and its left subtree before data
+		size_t right = static_cast<size_t>(m_compare(m_keys[position], data));
+		depth++;
+		before += right * (subtreeSize(2 * position, depth) + 1);
+		position = 2 * position + right;
+	}
+	return(static_cast<int>(before));
+}
+
+// size
+// Returns the number of distinct keys in the index.
+// preconditions:	this not equal to nullptr.
+// postconditions:	the number of keys is returned
+//
+template<typename Key, typename Compare>
+int BasicFrozenIndex<Key, Compare>::size() const {
+	return(static_cast<int>(m_count));
+}
+
+// isEmpty
+// Returns true if the index holds no keys, else false
+// preconditions:	this not equal to nullptr.
+// postconditions:	true is returned if the index is empty
+//
+template<typename Key, typename Compare>
+bool BasicFrozenIndex<Key, Compare>::isEmpty() const {
+	return(m_count == 0);
+}
+
+// begin
+// preconditions:	this not equal to nullptr.
+// postconditions:	an iterator to the smallest key is returned, or end() if
+//					the index is empty.
+//
+template<typename Key, typename Compare>
+typename BasicFrozenIndex<Key, Compare>::const_iterator BasicFrozenIndex<Key, Compare>::begin() const {
+	if(m_count == 0) {
+		return(end());
+	}
+	size_t position = 1;
+	while(2 * position <= m_count) {
+		position *= 2;
+	}
+	return(const_iterator(this, position));
+}
+
+// end
+// preconditions:	this not equal to nullptr.
+// postconditions:	the iterator one past the largest key is returned.
+//
+template<typename Key, typename Compare>
+typename BasicFrozenIndex<Key, Compare>::const_iterator BasicFrozenIndex<Key, Compare>::end() const {
+	return(const_iterator(this, 0));
+}
+
+// lowerBound
+// Seeks to the first key not ordered before data in O(log n).
+// preconditions:	data must be a valid Key object (must not reference
+//					a dereferenced nullptr); this not equal to nullptr.
+// postconditions:	an iterator to the smallest key >= data is returned, or
+//					end() if there is none.
+//
+template<typename Key, typename Compare>
+typename BasicFrozenIndex<Key, Compare>::const_iterator
+BasicFrozenIndex<Key, Compare>::lowerBound(const Key &data) const {
+	return(const_iterator(this, search(data)));
+}
+
+// build: freeze helper
+// Fills the index with count keys read in ascending order from begin. The
+// positions are visited in the order of an in-order walk of the complete
+// tree, so each key read lands where its rank belongs.
+// preconditions:	[begin, begin + count) must be sorted by compare with no
+//					two keys equal; InputIt must offer getCount().
+// postconditions:	the index holds the keys and counts read from begin
+//
+template<typename Key, typename Compare>
+template<typename InputIt>
+void BasicFrozenIndex<Key, Compare>::build(InputIt begin, int count, const Compare &compare) {
+	m_compare = compare;
+	m_keys.clear();
+	m_counts.clear();
+	m_count = count > 0 ? static_cast<size_t>(count) : 0;
+	m_height = 0;
+	if(m_count == 0) {
+		return;
+	}
+	m_height = level(m_count);
+	m_keys.assign(m_count + 1, *begin);
+	m_counts.assign(m_count + 1, 0);
+	for(const_iterator it = this->begin(); it != end(); ++it, ++begin) {
+		m_keys[it.m_position] = *begin;
+		m_counts[it.m_position] = begin.getCount();
+	}
+}
+
+// search: search helper
+// Descends the index without branching on keys: each step adds the result
+// of one comparison to 2k. When the descent falls off the bottom, the right
+// turns taken since the last left turn are shifted off, leaving the last
+// key that was not ordered before data.
+// preconditions:	none
+// postconditions:	the Eytzinger index of the smallest key >= data is
+//					returned, or 0 if there is none.
+//
+template<typename Key, typename Compare>
+size_t BasicFrozenIndex<Key, Compare>::search(const Key &data) const {
+	const Key *keys = m_keys.data();
+	size_t position = 1;
+	while(position <= m_count) {
+		prefetch(reinterpret_cast<uintptr_t>(keys) + position * PREFETCH_STRIDE * sizeof(Key));
+		position = 2 * position + static_cast<size_t>(m_compare(keys[position], data));
+	}
+	while(position & 1) {
+		position >>= 1;
+	}
+	return(position >> 1);
+}
+
+// subtreeSize: rank helper
+// Every level of the complete tree above the last is full, so only the
+// part of the last level under position has to be measured.
+// preconditions:	depth must be level(position).
+// postconditions:	the number of keys in the subtree under position is
+//					returned, or 0 if position is past the last key.
+//
+template<typename Key, typename Compare>
+size_t BasicFrozenIndex<Key, Compare>::subtreeSize(size_t position, int depth) const {
+	if(position > m_count) {
+		return(0);
+	}
+	int below = m_height - depth;
+	size_t width = static_cast<size_t>(1) << below;
+	size_t first = position << below;
+	size_t size = width - 1;
+	if(first <= m_count) {
+		size_t last = first + width - 1;
+		size += (last < m_count ? last : m_count) - first + 1;
+	}
+	return(size);
+}
+
+// successor: iteration helper
+// preconditions:	1 <= position <= m_count
+// postconditions:	the Eytzinger index of the next key in ascending order is
+//					returned, or 0 if position holds the largest key.
+//
+template<typename Key, typename Compare>
+size_t BasicFrozenIndex<Key, Compare>::successor(size_t position) const {
+	if(2 * position + 1 <= m_count) {
+		position = 2 * position + 1;
+		while(2 * position <= m_count) {
+			position *= 2;
+		}
+		return(position);
+	}
+	while(position & 1) {
+		position >>= 1;
+	}
+	return(position >> 1);
+}
+
+// level: layout helper
+// preconditions:	position > 0
+// postconditions:	floor(log2(position)), the depth of position, is returned
+//
+template<typename Key, typename Compare>
+int BasicFrozenIndex<Key, Compare>::level(size_t position) {
+	int depth = 0;
+	while(position > 1) {
+		position >>= 1;
+		depth++;
+	}
+	return(depth);
+}
+
+// prefetch: search helper
+// Hints the processor to start loading the cache line at address. Has no
+// effect on compilers without a prefetch builtin.
+// preconditions:	none
+// postconditions:	none; address is never dereferenced
+//
+template<typename Key, typename Compare>
+void BasicFrozenIndex<Key, Compare>::prefetch(uintptr_t address) {
+#if defined(__GNUC__)
+	__builtin_prefetch(reinterpret_cast<const void*>(address));
+#else
+	(void)address;
+#endif
+}
+#endif
\ No newline at end of file
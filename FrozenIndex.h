@@ -0,0 +1,297 @@
+// FrozenIndex.h		Author: Sam Hoover
+// contains the declarations for the BasicFrozenIndex class template and the
+// FrozenIndex type, an immutable search index compiled from a BSTree
+//
+#ifndef FROZENINDEX_H
+#define FROZENINDEX_H
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <vector>
+#include "BSTree.h"
+#include "TreeData.h"
+using namespace std;
+
+// FROZEN_CACHE_LINE
+// the size in bytes of the cache line a search prefetches ahead of itself
+//
+const size_t FROZEN_CACHE_LINE = 64;
+
+// BasicFrozenIndex
+// A read-only copy of the keys and counts of a BasicBSTree, made by
+// BasicBSTree::freeze. The keys are kept in one dense array (m_keys) in
+// Eytzinger order: the root is at index 1 and the children of index k are
+// at 2k and 2k + 1, filled level by level, so the index is a complete tree
+// held without any pointers. The counts are kept in a second array
+// (m_counts) at the same indexes, so a search only brings keys into the
+// cache. Index 0 of both arrays is unused.
+//
+// A search moves from k to 2k or 2k + 1 by adding the result of one
+// comparison, with no branch on the key, and prefetches the cache line
+// holding the descendants of k several levels down so the next loads are
+// already on their way. Every search therefore costs about log2(n) + 1
+// comparisons whatever the shape of the tree it was frozen from.
+//
+// The index never changes once built, so any number of threads may read it
+// at once without locking.
+//
+template<typename Key, typename Compare = less<Key> >
+class BasicFrozenIndex {
+	friend class BasicBSTree<Key, Compare>;
+
+public:
+	// const_iterator
+	// A forward iterator that visits the keys of the index in ascending
+	// order. It holds only the index of its current key, so copying and
+	// advancing it are cheap; 0 is the end position.
+	//
+	class const_iterator {
+		friend class BasicFrozenIndex;
+
+	public:
+		typedef forward_iterator_tag iterator_category;
+		typedef Key value_type;
+		typedef ptrdiff_t difference_type;
+		typedef const Key* pointer;
+		typedef const Key& reference;
+
+		// default constructor
+		// preconditions:	none
+		// postconditions:	creates an iterator that refers to no index
+		//
+		const_iterator();
+
+		// dereference
+		// preconditions:	this must not be an end iterator.
+		// postconditions:	the current key is returned
+		//
+		reference operator*() const;
+
+		// member access
+		// preconditions:	this must not be an end iterator.
+		// postconditions:	a pointer to the current key is returned
+		//
+		pointer operator->() const;
+
+		// getCount
+		// Returns the number of occurrences of the current key.
+		// preconditions:	this must not be an end iterator.
+		// postconditions:	the current key's count is returned
+		//
+		int getCount() const;
+
+		// pre-increment
+		// Moves to the next key in ascending order.
+		// preconditions:	this must not be an end iterator.
+		// postconditions:	this refers to the next key, or is the end
+		//					iterator if there is none. this is returned.
+		//
+		const_iterator& operator++();
+
+		// post-increment
+		// preconditions:	this must not be an end iterator.
+		// postconditions:	this is advanced; its old position is returned
+		//
+		const_iterator operator++(int);
+
+		// equality
+		// preconditions:	other must iterate over the same index.
+		// postconditions:	true is returned if both refer to the same key or
+		//					both are end iterators.
+		//
+		bool operator==(const const_iterator &other) const;
+
+		// inequality
+		// preconditions:	other must iterate over the same index.
+		// postconditions:	true is returned if the iterators differ.
+		//
+		bool operator!=(const const_iterator &other) const;
+
+	private:
+		// constructor(const BasicFrozenIndex *index, size_t position)
+		// preconditions:	position <= index->m_count
+		// postconditions:	creates an iterator at position
+		//
+		const_iterator(const BasicFrozenIndex *index, size_t position);
+
+		// m_index
+		// the index being iterated
+		//
+		const BasicFrozenIndex *m_index;
+
+		// m_position
+		// the Eytzinger index of the current key, or 0 at the end
+		//
+		size_t m_position;
+	};
+
+	// CONSTRUCTORS
+
+	// default constructor
+	// preconditions:	none
+	// postconditions:	creates an empty index
+	//
+	BasicFrozenIndex();
+
+	// ACCESSORS
+
+	// retrieve
+	// Searches the index for data, if found, a const pointer to that key is
+	// returned.
+	// preconditions:	data must be a valid Key object (must not reference
+	//					a dereferenced nullptr); this not equal to nullptr.
+	// postconditions:	If data is found, a const pointer to the key equal to
+	//					data is returned; else nullptr is returned.
+	//
+	const Key* retrieve(const Key &data) const;
+
+	// depth
+	// Finds the depth of data in the complete tree the index is laid out as.
+	// Depth of the root is 0; no key is deeper than floor(log2(size())).
+	// preconditions:	data must be a valid Key object (must not reference
+	//					a dereferenced nullptr); this not equal to nullptr.
+	// postconditions:	If data is found, its depth is returned. If data is
+	//					not found, -1 is returned.
+	//
+	int depth(const Key &data) const;
+
+	// rank
+	// Counts the distinct keys ordered before data. Runs in O(log n) from
+	// the shape of the complete tree alone.
+	// preconditions:	data must be a valid Key object (must not reference
+	//					a dereferenced nullptr); this not equal to nullptr.
+	// postconditions:	the number of keys ordered before data is returned,
+	//					whether or not data is in the index.
+	//
+	int rank(const Key &data) const;
+
+	// size
+	// Returns the number of distinct keys in the index.
+	// preconditions:	this not equal to nullptr.
+	// postconditions:	the number of keys is returned
+	//
+	int size() const;
+
+	// isEmpty
+	// Returns true if the index holds no keys, else false
+	// preconditions:	this not equal to nullptr.
+	// postconditions:	true is returned if the index is empty
+	//
+	bool isEmpty() const;
+
+	// ITERATORS
+
+	// begin
+	// preconditions:	this not equal to nullptr.
+	// postconditions:	an iterator to the smallest key is returned, or end()
+	//					if the index is empty.
+	//
+	const_iterator begin() const;
+
+	// end
+	// preconditions:	this not equal to nullptr.
+	// postconditions:	the iterator one past the largest key is returned.
+	//
+	const_iterator end() const;
+
+	// lowerBound
+	// Seeks to the first key not ordered before data in O(log n).
+	// preconditions:	data must be a valid Key object (must not reference
+	//					a dereferenced nullptr); this not equal to nullptr.
+	// postconditions:	an iterator to the smallest key >= data is returned, or
+	//					end() if there is none.
+	//
+	const_iterator lowerBound(const Key &data) const;
+
+private:
+	// HELPER FUNCTIONS
+
+	// build: freeze helper
+	// Fills the index with count keys read in ascending order from begin.
+	// preconditions:	[begin, begin + count) must be sorted by compare with
+	//					no two keys equal; InputIt must offer getCount().
+	// postconditions:	the index holds the keys and counts read from begin
+	//
+	template<typename InputIt>
+	void build(InputIt begin, int count, const Compare &compare);
+
+	// search: search helper
+	// Descends the index without branching on keys, prefetching ahead.
+	// preconditions:	none
+	// postconditions:	the Eytzinger index of the smallest key >= data is
+	//					returned, or 0 if there is none.
+	//
+	size_t search(const Key &data) const;
+
+	// subtreeSize: rank helper
+	// preconditions:	depth must be level(position).
+	// postconditions:	the number of keys in the subtree under position is
+	//					returned, or 0 if position is past the last key.
+	//
+	size_t subtreeSize(size_t position, int depth) const;
+
+	// successor: iteration helper
+	// preconditions:	1 <= position <= m_count
+	// postconditions:	the Eytzinger index of the next key in ascending order
+	//					is returned, or 0 if position holds the largest key.
+	//
+	size_t successor(size_t position) const;
+
+	// level: layout helper
+	// preconditions:	position > 0
+	// postconditions:	floor(log2(position)), the depth of position, is
+	//					returned
+	//
+	static int level(size_t position);
+
+	// prefetch: search helper
+	// Hints the processor to start loading the cache line at address. Has no
+	// effect on compilers without a prefetch builtin.
+	// preconditions:	none
+	// postconditions:	none; address is never dereferenced
+	//
+	static void prefetch(uintptr_t address);
+
+	// DATA
+
+	// PREFETCH_STRIDE
+	// the number of keys in one cache line; the descendants of k that many
+	// positions below it are stored together from k * PREFETCH_STRIDE
+	//
+	static const size_t PREFETCH_STRIDE = sizeof(Key) * 2 > FROZEN_CACHE_LINE ?
+			2 : FROZEN_CACHE_LINE / sizeof(Key);
+
+	// m_keys
+	// the keys in Eytzinger order, from index 1
+	//
+	vector<Key> m_keys;
+
+	// m_counts
+	// the number of occurrences of m_keys[k], at the same index k
+	//
+	vector<int> m_counts;
+
+	// m_count
+	// the number of keys in the index
+	//
+	size_t m_count;
+
+	// m_height
+	// the depth of the last key, floor(log2(m_count)), or 0 when empty
+	//
+	int m_height;
+
+	// m_compare
+	// the ordering the keys are sorted by
+	//
+	Compare m_compare;
+};
+
+// FrozenIndex
+// the index frozen from a BSTree
+//
+typedef BasicFrozenIndex<TreeData> FrozenIndex;
+
+#include "FrozenIndex.cpp"
+#endif
\ No newline at end of file
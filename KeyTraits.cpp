@@ -0,0 +1,176 @@
+// KeyTraits.cpp		Author: Sam Hoover
+// contains the definitions for the KeyTraits class template. This file is
+// included at the bottom of KeyTraits.h and needs no separate compilation
+//
+#ifndef KEYTRAITS_CPP
+#define KEYTRAITS_CPP
+#include <sstream>
+#include "KeyTraits.h"
+
+// format
+// Writes the text form of key to out, matching operator<< (except that
+// signed char and unsigned char are written as numbers).
+// preconditions:	none
+// postconditions:	the text of key is appended to out
+//
+template<typename Key>
+void KeyTraits<Key>::format(OutputBuffer &out, const Key &key) {
+	format(out, key, integral_constant<int, is_integral<Key>::value ? (is_signed<Key>::value ? 0 : 1) : 2>());
+}
+
+// encode
+// Writes the bytes of key to dest.
+// preconditions:	Key must be trivially copyable; dest must have room
+//					for ENCODED_SIZE bytes.
+// postconditions:	ENCODED_SIZE bytes are written to dest
+//
+template<typename Key>
+void KeyTraits<Key>::encode(const Key &key, char *dest) {
+	static_assert(is_trivially_copyable<Key>::value, "KeyTraits must be specialized to encode this Key type");
+	memcpy(dest, &key, sizeof(Key));
+}
+
+// decode
+// Rebuilds a key from bytes written by encode.
+// preconditions:	src must point to ENCODED_SIZE bytes from encode.
+// postconditions:	the decoded key is returned
+//
+template<typename Key>
+Key KeyTraits<Key>::decode(const char *src) {
+	static_assert(is_trivially_copyable<Key>::value, "KeyTraits must be specialized to decode this Key type");
+	Key key;
+	memcpy(&key, src, sizeof(Key));
+	return(key);
+}
+
+// hash
+// Keys that are equal under operator< must hash alike.
+// preconditions:	none
+// postconditions:	a hash of key is returned
+//
+template<typename Key>
+size_t KeyTraits<Key>::hash(const Key &key) {
+	return(hash(key, integral_constant<int, is_arithmetic<Key>::value ? 0 : (is_enum<Key>::value ? 1 : 2)>()));
+}
+
+// format helper: signed integers
+template<typename Key>
+void KeyTraits<Key>::format(OutputBuffer &out, const Key &key, integral_constant<int, 0>) {
+	out.appendInt(key);
+}
+
+// format helper: unsigned integers
+template<typename Key>
+void KeyTraits<Key>::format(OutputBuffer &out, const Key &key, integral_constant<int, 1>) {
+	out.appendUnsigned(key);
+}
+
+// format helper: any other type, through its operator<<
+template<typename Key>
+void KeyTraits<Key>::format(OutputBuffer &out, const Key &key, integral_constant<int, 2>) {
+	ostringstream text;
+	text << key;
+	const string &str = text.str();
+	out.append(str.data(), str.size());
+}
+
+// hash helper: arithmetic keys. std::hash gives 0.0 and -0.0 the same hash.
+template<typename Key>
+size_t KeyTraits<Key>::hash(const Key &key, integral_constant<int, 0>) {
+	return(std::hash<Key>()(key));
+}
+
+// hash helper: enums, through their underlying integer
+template<typename Key>
+size_t KeyTraits<Key>::hash(const Key &key, integral_constant<int, 1>) {
+	typedef typename underlying_type<Key>::type Value;
+	return(std::hash<Value>()(static_cast<Value>(key)));
+}
+
+// hash helper: any other type is not hashed
+template<typename Key>
+size_t KeyTraits<Key>::hash(const Key &key, integral_constant<int, 2>) {
+	(void)key;
+	return(0);
+}
+
+// KeyTraits<TreeData> format
+// preconditions:	none
+// postconditions:	the char held by key is appended to out
+//
+inline void KeyTraits<TreeData>::format(OutputBuffer &out, const TreeData &key) {
+	out.append(key.getData());
+}
+
+// KeyTraits<TreeData> encode
+// preconditions:	dest must have room for one byte
+// postconditions:	the char held by key is written to dest
+//
+inline void KeyTraits<TreeData>::encode(const TreeData &key, char *dest) {
+	*dest = key.getData();
+}
+
+// KeyTraits<TreeData> decode
+// preconditions:	src must point to one byte from encode
+// postconditions:	a TreeData holding that char is returned
+//
+inline TreeData KeyTraits<TreeData>::decode(const char *src) {
+	return(TreeData(*src));
+}
+
+// KeyTraits<TreeData> hash
+// preconditions:	none
+// postconditions:	a hash of the char held by key is returned
+//
+inline size_t KeyTraits<TreeData>::hash(const TreeData &key) {
+	return(std::hash<char>()(key.getData()));
+}
+
+// KeyTraits<char> format
+// preconditions:	none
+// postconditions:	key is appended to out as a character
+//
+inline void KeyTraits<char>::format(OutputBuffer &out, const char &key) {
+	out.append(key);
+}
+
+// KeyTraits<char> encode
+// preconditions:	dest must have room for one byte
+// postconditions:	key is written to dest
+//
+inline void KeyTraits<char>::encode(const char &key, char *dest) {
+	*dest = key;
+}
+
+// KeyTraits<char> decode
+// preconditions:	src must point to one byte from encode
+// postconditions:	the char at src is returned
+//
+inline char KeyTraits<char>::decode(const char *src) {
+	return(*src);
+}
+
+// KeyTraits<char> hash
+// preconditions:	none
+// postconditions:	a hash of key is returned
+//
+inline size_t KeyTraits<char>::hash(const char &key) {
+	return(std::hash<char>()(key));
+}
+
+// KeyTraits<string> format
+// preconditions:	none
+// postconditions:	the characters of key are appended to out
+//
+inline void KeyTraits<string>::format(OutputBuffer &out, const string &key) {
+	out.append(key.data(), key.size());
+}
+
+// KeyTraits<string> hash
+// preconditions:	none
+// postconditions:	a hash of the characters of key is returned
+//
+inline size_t KeyTraits<string>::hash(const string &key) {
+	return(std::hash<string>()(key));
+}
+#endif
@@ -0,0 +1,137 @@
+// KeyTraits.h		Author: Sam Hoover
+// contains the declarations for the KeyTraits class template
+//
+#ifndef KEYTRAITS_H
+#define KEYTRAITS_H
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <type_traits>
+#include "OutputBuffer.h"
+#include "TreeData.h"
+using namespace std;
+
+// KeyTraits
+// Describes how a BasicBSTree formats its Key type without going through
+// iostream formatting, how it encodes a key into the fixed number of bytes
+// (ENCODED_SIZE) used by snapshot files, tagged with KEY_TAG so a snapshot
+// is only read back as the type that wrote it, and how it hashes a key for
+// the subtree hashes of the tree. The primary template writes integral
+// keys with OutputBuffer's integer formatting and falls back to operator<<
+// for any other type; it encodes trivially copyable keys by copying their
+// bytes; it hashes arithmetic and enum keys and hashes every other type to
+// 0 (with HASHED false), which keeps tree hashes correct but lets them
+// tell apart only counts and shapes. Specializations are provided for
+// TreeData, char and string; a new key type can be supported by adding its
+// own specialization, which must at least provide format, hash and HASHED.
+// string has no fixed-width encoding, so trees of strings cannot be saved
+// as snapshots.
+//
+template<typename Key>
+struct KeyTraits {
+	// ENCODED_SIZE
+	// the number of bytes encode writes and decode reads
+	//
+	static const size_t ENCODED_SIZE = sizeof(Key);
+
+	// KEY_TAG
+	// names the encoding in snapshot headers: the kind of key (1 signed
+	// integer, 2 unsigned integer, 3 floating point, 4 enum, 5 anything
+	// else) times 256 plus ENCODED_SIZE. Other types of the same size share
+	// a tag, so such a type should get a specialization with its own.
+	//
+	static const uint32_t KEY_TAG = (is_floating_point<Key>::value ? 3 :
+	                                 is_enum<Key>::value ? 4 :
+	                                 is_integral<Key>::value ? (is_signed<Key>::value ? 1 : 2) : 5) * 256 + sizeof(Key);
+
+	// HASHED
+	// true if hash tells keys apart, false if it hashes every key alike
+	//
+	static const bool HASHED = is_arithmetic<Key>::value || is_enum<Key>::value;
+
+	// encode
+	// Writes the bytes of key to dest.
+	// preconditions:	Key must be trivially copyable; dest must have room
+	//					for ENCODED_SIZE bytes.
+	// postconditions:	ENCODED_SIZE bytes are written to dest
+	//
+	static void encode(const Key &key, char *dest);
+
+	// decode
+	// Rebuilds a key from bytes written by encode.
+	// preconditions:	src must point to ENCODED_SIZE bytes from encode.
+	// postconditions:	the decoded key is returned
+	//
+	static Key decode(const char *src);
+
+	// format
+	// Writes the text form of key to out, matching operator<< (except that
+	// signed char and unsigned char are written as numbers).
+	// preconditions:	none
+	// postconditions:	the text of key is appended to out
+	//
+	static void format(OutputBuffer &out, const Key &key);
+
+	// hash
+	// Keys that are equal under operator< must hash alike.
+	// preconditions:	none
+	// postconditions:	a hash of key is returned
+	//
+	static size_t hash(const Key &key);
+
+private:
+	// format helpers, chosen by whether Key is a signed integer, an unsigned
+	// integer, or anything else
+	static void format(OutputBuffer &out, const Key &key, integral_constant<int, 0>);
+	static void format(OutputBuffer &out, const Key &key, integral_constant<int, 1>);
+	static void format(OutputBuffer &out, const Key &key, integral_constant<int, 2>);
+
+	// hash helpers, chosen by whether Key is arithmetic, an enum, or
+	// anything else
+	static size_t hash(const Key &key, integral_constant<int, 0>);
+	static size_t hash(const Key &key, integral_constant<int, 1>);
+	static size_t hash(const Key &key, integral_constant<int, 2>);
+};
+
+// KeyTraits<TreeData>
+// TreeData wraps a char, which is written as the character itself
+//
+template<>
+struct KeyTraits<TreeData> {
+	static const size_t ENCODED_SIZE = 1;
+	static const uint32_t KEY_TAG = 6 * 256 + 1;
+	static const bool HASHED = true;
+	static void format(OutputBuffer &out, const TreeData &key);
+	static void encode(const TreeData &key, char *dest);
+	static TreeData decode(const char *src);
+	static size_t hash(const TreeData &key);
+};
+
+// KeyTraits<char>
+// char is integral but prints as a character, not a number
+//
+template<>
+struct KeyTraits<char> {
+	static const size_t ENCODED_SIZE = 1;
+	static const uint32_t KEY_TAG = 7 * 256 + 1;
+	static const bool HASHED = true;
+	static void format(OutputBuffer &out, const char &key);
+	static void encode(const char &key, char *dest);
+	static char decode(const char *src);
+	static size_t hash(const char &key);
+};
+
+// KeyTraits<string>
+// strings are copied into the buffer as-is
+//
+template<>
+struct KeyTraits<string> {
+	static const bool HASHED = true;
+	static void format(OutputBuffer &out, const string &key);
+	static size_t hash(const string &key);
+};
+
+#include "KeyTraits.cpp"
+#endif
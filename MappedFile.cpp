@@ -0,0 +1,84 @@
+// MappedFile.cpp		Author: Sam Hoover
+// contains the definitions for the MappedFile class
+//
+#ifndef MAPPEDFILE_CPP
+#define MAPPEDFILE_CPP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "MappedFile.h"
+
+// default constructor
+// preconditions:	none
+// postconditions:	Creates an object with no file mapped
+//
+MappedFile::MappedFile() : m_data(nullptr), m_size(0) {}
+
+// destructor
+// preconditions:	none
+// postconditions:	the mapping, if any, is removed
+//
+MappedFile::~MappedFile() {
+	close();
+}
+
+// open
+// Maps the file at path read-only, replacing any earlier mapping.
+// preconditions:	none
+// postconditions:	true is returned if the file was mapped; false if it
+//					could not be opened, is empty, or could not be mapped.
+//
+bool MappedFile::open(const string &path) {
+	close();
+	int fd = ::open(path.c_str(), O_RDONLY);
+	if(fd < 0) {
+		return(false);
+	}
+
+	struct stat info;
+	if(fstat(fd, &info) != 0 || info.st_size <= 0) {
+		::close(fd);
+		return(false);
+	}
+	void *data = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	// the mapping stays valid after the descriptor is closed
+	::close(fd);
+	if(data == MAP_FAILED) {
+		return(false);
+	}
+
+	m_data = static_cast<const char*>(data);
+	m_size = info.st_size;
+	return(true);
+}
+
+// close
+// Removes the current mapping.
+// preconditions:	none
+// postconditions:	no file is mapped
+//
+void MappedFile::close() {
+	if(m_data != nullptr) {
+		munmap(const_cast<char*>(m_data), m_size);
+		m_data = nullptr;
+		m_size = 0;
+	}
+}
+
+// getData
+// preconditions:	a file must be mapped
+// postconditions:	a pointer to the first byte of the file is returned
+//
+const char* MappedFile::getData() const {
+	return(m_data);
+}
+
+// getSize
+// preconditions:	none
+// postconditions:	the size of the mapped file in bytes is returned, or 0
+//
+size_t MappedFile::getSize() const {
+	return(m_size);
+}
+#endif
@@ -0,0 +1,72 @@
+// MappedFile.h		Author: Sam Hoover
+// contains the declarations for the MappedFile class
+//
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+#include <cstddef>
+#include <string>
+using namespace std;
+
+// MappedFile
+// A read-only memory mapping of a whole file. The file is mapped when the
+// object is opened and unmapped when it is destroyed, so the contents can be
+// read in place through getData() without copying them into the process.
+//
+class MappedFile {
+public:
+	// default constructor
+	// preconditions:	none
+	// postconditions:	Creates an object with no file mapped
+	//
+	MappedFile();
+
+	// destructor
+	// preconditions:	none
+	// postconditions:	the mapping, if any, is removed
+	//
+	~MappedFile();
+
+	// open
+	// Maps the file at path read-only, replacing any earlier mapping.
+	// preconditions:	none
+	// postconditions:	true is returned if the file was mapped; false if it
+	//					could not be opened, is empty, or could not be mapped.
+	//
+	bool open(const string &path);
+
+	// close
+	// Removes the current mapping.
+	// preconditions:	none
+	// postconditions:	no file is mapped
+	//
+	void close();
+
+	// getData
+	// preconditions:	a file must be mapped
+	// postconditions:	a pointer to the first byte of the file is returned
+	//
+	const char* getData() const;
+
+	// getSize
+	// preconditions:	none
+	// postconditions:	the size of the mapped file in bytes is returned, or 0
+	//
+	size_t getSize() const;
+
+private:
+	// copying would unmap the same region twice
+	MappedFile(const MappedFile &file);
+	const MappedFile& operator=(const MappedFile &file);
+
+	// m_data
+	// the start of the mapping, or nullptr
+	//
+	const char *m_data;
+
+	// m_size
+	// the length of the mapping in bytes
+	//
+	size_t m_size;
+};
+
+#endif
@@ -0,0 +1,140 @@
+// MemoryPool.cpp		Author: Sam Hoover
+// contains the definitions for the MemoryPool class
+//
+#ifndef MEMORYPOOL_CPP
+#define MEMORYPOOL_CPP
+#include <functional>
+#include "MemoryPool.h"
+
+// constructor(size_t blockSize, size_t blocksPerChunk)
+// preconditions:	blockSize > 0; blocksPerChunk > 0
+// postconditions:	Creates an empty pool handing out blocks of at least
+//					blockSize bytes, aligned for any fundamental type.
+//
+MemoryPool::MemoryPool(size_t blockSize, size_t blocksPerChunk) : 
+											m_blocksPerChunk(blocksPerChunk),
+											m_reservedBytes(0),
+											m_next(nullptr),
+											m_end(nullptr),
+											m_freeList(nullptr) {
+	const size_t align = alignof(max_align_t);
+	if(blockSize < sizeof(FreeBlock)) {
+		blockSize = sizeof(FreeBlock);
+	}
+	m_blockSize = (blockSize + align - 1) / align * align;
+}
+
+// destructor
+// preconditions:	none
+// postconditions:	All chunks are returned to the system.
+//
+MemoryPool::~MemoryPool() {
+	release();
+}
+
+// allocate
+// Returns a block of memory from the free list, or from the current chunk
+// if the free list is empty. A new chunk is allocated when the current
+// chunk is used up.
+// preconditions:	this not equal to nullptr.
+// postconditions:	a pointer to an unused block of m_blockSize bytes is
+//					returned.
+//
+void* MemoryPool::allocate() {
+	if(m_freeList != nullptr) {
+		FreeBlock *block = m_freeList;
+		m_freeList = block->m_next;
+		return(block);
+	}
+	if(m_next == m_end) {
+		char *chunk = static_cast<char*>(::operator new(m_blockSize * m_blocksPerChunk));
+		m_chunks[chunk] = m_blockSize * m_blocksPerChunk;
+		m_reservedBytes += m_blockSize * m_blocksPerChunk;
+		m_next = chunk;
+		m_end = chunk + m_blockSize * m_blocksPerChunk;
+	}
+	void *block = m_next;
+	m_next += m_blockSize;
+	return(block);
+}
+
+// allocateBulk
+// Returns count adjacent blocks carved from one dedicated chunk. Each
+// block may later be returned individually with deallocate().
+// preconditions:	count > 0
+// postconditions:	a pointer to the first of count contiguous blocks of
+//					m_blockSize bytes is returned.
+//
+void* MemoryPool::allocateBulk(size_t count) {
+	char *chunk = static_cast<char*>(::operator new(m_blockSize * count));
+	m_chunks[chunk] = m_blockSize * count;
+	m_reservedBytes += m_blockSize * count;
+	return(chunk);
+}
+
+// getBlockSize
+// Returns the size in bytes of each block, after alignment padding.
+// preconditions:	none
+// postconditions:	m_blockSize is returned
+//
+size_t MemoryPool::getBlockSize() const {
+	return(m_blockSize);
+}
+
+// getReservedBytes
+// Returns the number of bytes the pool holds from the system, whether or
+// not its blocks are handed out.
+// preconditions:	none
+// postconditions:	the total size of m_chunks is returned
+//
+size_t MemoryPool::getReservedBytes() const {
+	return(m_reservedBytes);
+}
+
+// owns
+// Tells whether block lies in one of the pool's chunks. Runs in
+// O(log chunks).
+// preconditions:	none
+// postconditions:	true is returned if block was carved from this pool and
+//					not yet released, else false.
+//
+bool MemoryPool::owns(const void *block) const {
+	const char *address = static_cast<const char*>(block);
+	map<const char*, size_t>::const_iterator chunk = m_chunks.upper_bound(address);
+	if(chunk == m_chunks.begin()) {
+		return(false);
+	}
+	--chunk;
+	return(less<const char*>()(address, chunk->first + chunk->second));
+}
+
+// deallocate
+// Returns a block to the pool for reuse.
+// preconditions:	block must have been returned by allocate() on this
+//					pool and not already deallocated or released.
+// postconditions:	block is pushed onto the free list.
+//
+void MemoryPool::deallocate(void *block) {
+	if(block != nullptr) {
+		FreeBlock *freed = static_cast<FreeBlock*>(block);
+		freed->m_next = m_freeList;
+		m_freeList = freed;
+	}
+}
+
+// release
+// Returns every chunk to the system, invalidating all blocks handed out.
+// preconditions:	this not equal to nullptr.
+// postconditions:	m_chunks and m_freeList are empty.
+//
+void MemoryPool::release() {
+	for(map<const char*, size_t>::iterator chunk = m_chunks.begin(); chunk != m_chunks.end(); ++chunk) {
+		::operator delete(const_cast<char*>(chunk->first));
+	}
+	m_chunks.clear();
+	m_reservedBytes = 0;
+	m_next = nullptr;
+	m_end = nullptr;
+	m_freeList = nullptr;
+}
+#endif
@@ -0,0 +1,148 @@
+// MemoryPool.h		Author: Sam Hoover
+// contains the declarations for the MemoryPool class
+//
+#ifndef MEMORYPOOL_H
+#define MEMORYPOOL_H
+#include <cstddef>
+#include <map>
+using namespace std;
+
+// DEFAULT_BLOCKS_PER_CHUNK
+// the number of blocks carved from each chunk a MemoryPool allocates
+//
+const size_t DEFAULT_BLOCKS_PER_CHUNK = 256;
+
+// MemoryPool
+// A slab allocator that hands out fixed-size blocks of raw memory. Blocks are
+// carved sequentially from large contiguous chunks (m_chunks), so consecutive
+// allocations are adjacent in memory. A block returned with deallocate() is
+// pushed onto a free list (m_freeList) and reused by the next allocate().
+//
+// release() gives every chunk back to the system at once, which frees all
+// outstanding blocks in O(chunks) rather than one at a time. Objects built in
+// the blocks are not destroyed by the pool; the owner must do that first if
+// their destructors matter.
+//
+class MemoryPool {
+public:
+	// constructor(size_t blockSize, size_t blocksPerChunk)
+	// preconditions:	blockSize > 0; blocksPerChunk > 0
+	// postconditions:	Creates an empty pool handing out blocks of at least
+	//					blockSize bytes, aligned for any fundamental type.
+	//
+	MemoryPool(size_t blockSize, size_t blocksPerChunk = DEFAULT_BLOCKS_PER_CHUNK);
+
+	// destructor
+	// preconditions:	none
+	// postconditions:	All chunks are returned to the system.
+	//
+	~MemoryPool();
+
+	// allocate
+	// Returns a block of memory from the free list, or from the current chunk
+	// if the free list is empty. A new chunk is allocated when the current
+	// chunk is used up.
+	// preconditions:	this not equal to nullptr.
+	// postconditions:	a pointer to an unused block of m_blockSize bytes is
+	//					returned.
+	//
+	void* allocate();
+
+	// allocateBulk
+	// Returns count adjacent blocks carved from one dedicated chunk. Each
+	// block may later be returned individually with deallocate().
+	// preconditions:	count > 0
+	// postconditions:	a pointer to the first of count contiguous blocks of
+	//					m_blockSize bytes is returned.
+	//
+	void* allocateBulk(size_t count);
+
+	// getBlockSize
+	// Returns the size in bytes of each block, after alignment padding.
+	// preconditions:	none
+	// postconditions:	m_blockSize is returned
+	//
+	size_t getBlockSize() const;
+
+	// getReservedBytes
+	// Returns the number of bytes the pool holds from the system, whether
+	// or not its blocks are handed out.
+	// preconditions:	none
+	// postconditions:	the total size of m_chunks is returned
+	//
+	size_t getReservedBytes() const;
+
+	// owns
+	// Tells whether block lies in one of the pool's chunks. Runs in
+	// O(log chunks).
+	// preconditions:	none
+	// postconditions:	true is returned if block was carved from this pool
+	//					and not yet released, else false.
+	//
+	bool owns(const void *block) const;
+
+	// deallocate
+	// Returns a block to the pool for reuse.
+	// preconditions:	block must have been returned by allocate() on this
+	//					pool and not already deallocated or released.
+	// postconditions:	block is pushed onto the free list.
+	//
+	void deallocate(void *block);
+
+	// release
+	// Returns every chunk to the system, invalidating all blocks handed out.
+	// preconditions:	this not equal to nullptr.
+	// postconditions:	m_chunks and m_freeList are empty.
+	//
+	void release();
+
+private:
+	// copying a pool would alias its chunks
+	MemoryPool(const MemoryPool &pool);
+	const MemoryPool& operator=(const MemoryPool &pool);
+
+	// struct FreeBlock
+	// the layout of a block while it sits on the free list
+	//
+	struct FreeBlock {
+		FreeBlock *m_next;
+	};
+
+	// m_blockSize
+	// the size in bytes of each block, rounded up for alignment
+	//
+	size_t m_blockSize;
+
+	// m_blocksPerChunk
+	// the number of blocks in each chunk
+	//
+	size_t m_blocksPerChunk;
+
+	// m_chunks
+	// every chunk allocated by the pool, mapped from its first byte to its
+	// size in bytes so that owns() can find the chunk around a block
+	//
+	map<const char*, size_t> m_chunks;
+
+	// m_reservedBytes
+	// the total size in bytes of m_chunks
+	//
+	size_t m_reservedBytes;
+
+	// m_next
+	// the next unused byte in the most recent chunk
+	//
+	char *m_next;
+
+	// m_end
+	// one past the last byte of the most recent chunk
+	//
+	char *m_end;
+
+	// m_freeList
+	// blocks returned with deallocate(), waiting to be reused
+	//
+	FreeBlock *m_freeList;
+};
+
+#endif
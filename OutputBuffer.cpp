@@ -0,0 +1,146 @@
+// OutputBuffer.cpp		Author: Sam Hoover
+// contains the definitions for the OutputBuffer class
+//
+#ifndef OUTPUTBUFFER_CPP
+#define OUTPUTBUFFER_CPP
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+#include "OutputBuffer.h"
+
+// constructor(ostream &sout, size_t capacity)
+// preconditions:	capacity > 0
+// postconditions:	Creates an empty buffer of capacity bytes that writes
+//					to sout.
+//
+OutputBuffer::OutputBuffer(ostream &sout, size_t capacity) : m_buffer(capacity),
+															 m_used(0),
+															 m_stream(&sout),
+															 m_fd(-1),
+															 m_good(true) {}
+
+// constructor(int fd, size_t capacity)
+// preconditions:	fd must be a file descriptor open for writing;
+//					capacity > 0
+// postconditions:	Creates an empty buffer of capacity bytes that writes
+//					to fd.
+//
+OutputBuffer::OutputBuffer(int fd, size_t capacity) : m_buffer(capacity),
+													  m_used(0),
+													  m_stream(nullptr),
+													  m_fd(fd),
+													  m_good(true) {}
+
+// destructor
+// preconditions:	none
+// postconditions:	Any buffered text is written out.
+//
+OutputBuffer::~OutputBuffer() {
+	flush();
+}
+
+// append(const char *data, size_t length)
+// Adds length bytes of data to the buffer.
+// preconditions:	data must point to at least length bytes.
+// postconditions:	the bytes are buffered; the buffer is written out
+//					first if they do not fit.
+//
+void OutputBuffer::append(const char *data, size_t length) {
+	while(length > 0) {
+		if(m_used == m_buffer.size()) {
+			flush();
+		}
+		size_t room = m_buffer.size() - m_used;
+		size_t chunk = length < room ? length : room;
+		memcpy(&m_buffer[m_used], data, chunk);
+		m_used += chunk;
+		data += chunk;
+		length -= chunk;
+	}
+}
+
+// append(char data)
+// Adds a single character to the buffer.
+// preconditions:	none
+// postconditions:	data is buffered.
+//
+void OutputBuffer::append(char data) {
+	if(m_used == m_buffer.size()) {
+		flush();
+	}
+	m_buffer[m_used++] = data;
+}
+
+// appendInt
+// Adds the decimal text of value to the buffer.
+// preconditions:	none
+// postconditions:	value is buffered as an optional '-' followed by its
+//					digits.
+//
+void OutputBuffer::appendInt(long long value) {
+	if(value < 0) {
+		append('-');
+		// negate in unsigned arithmetic so the most negative value is safe
+		appendUnsigned(0ULL - static_cast<unsigned long long>(value));
+	} else {
+		appendUnsigned(static_cast<unsigned long long>(value));
+	}
+}
+
+// appendUnsigned
+// Adds the decimal text of value to the buffer.
+// preconditions:	none
+// postconditions:	value is buffered as its digits.
+//
+void OutputBuffer::appendUnsigned(unsigned long long value) {
+	// digits are produced last to first into the end of a scratch array
+	char digits[20];
+	int start = sizeof(digits);
+	do {
+		digits[--start] = static_cast<char>('0' + value % 10);
+		value /= 10;
+	} while(value != 0);
+	append(digits + start, sizeof(digits) - start);
+}
+
+// flush
+// Writes out everything buffered so far.
+// preconditions:	none
+// postconditions:	the buffer is empty. false is returned if any write
+//					to the destination has failed.
+//
+bool OutputBuffer::flush() {
+	if(m_used > 0 && m_good) {
+		if(m_stream != nullptr) {
+			m_stream->write(&m_buffer[0], m_used);
+			m_good = !m_stream->fail();
+		} else {
+			const char *next = &m_buffer[0];
+			size_t remaining = m_used;
+			while(remaining > 0) {
+				ssize_t written = ::write(m_fd, next, remaining);
+				if(written < 0) {
+					if(errno == EINTR) {
+						continue;
+					}
+					m_good = false;
+					break;
+				}
+				next += written;
+				remaining -= written;
+			}
+		}
+	}
+	m_used = 0;
+	return(m_good);
+}
+
+// good
+// preconditions:	none
+// postconditions:	false is returned if any write to the destination has
+//					failed, else true.
+//
+bool OutputBuffer::good() const {
+	return(m_good);
+}
+#endif
@@ -0,0 +1,125 @@
+// OutputBuffer.h		Author: Sam Hoover
+// contains the declarations for the OutputBuffer class
+//
+#ifndef OUTPUTBUFFER_H
+#define OUTPUTBUFFER_H
+#include <cstddef>
+#include <iostream>
+#include <vector>
+using namespace std;
+
+// DEFAULT_OUTPUT_BUFFER_SIZE
+// the number of bytes an OutputBuffer collects before writing them out
+//
+const size_t DEFAULT_OUTPUT_BUFFER_SIZE = 1 << 16;
+
+// OutputBuffer
+// Collects formatted text in one large buffer (m_buffer) and hands it to its
+// destination in big chunks, either an ostream or a POSIX file descriptor.
+// Nothing is written until the buffer fills, flush() is called, or the
+// OutputBuffer is destroyed, so dumping a large tree costs a handful of write
+// calls rather than one per line.
+//
+// Integers are formatted by hand into the buffer instead of through iostream
+// formatting.
+//
+class OutputBuffer {
+public:
+	// constructor(ostream &sout, size_t capacity)
+	// preconditions:	capacity > 0
+	// postconditions:	Creates an empty buffer of capacity bytes that writes
+	//					to sout.
+	//
+	OutputBuffer(ostream &sout, size_t capacity = DEFAULT_OUTPUT_BUFFER_SIZE);
+
+	// constructor(int fd, size_t capacity)
+	// preconditions:	fd must be a file descriptor open for writing;
+	//					capacity > 0
+	// postconditions:	Creates an empty buffer of capacity bytes that writes
+	//					to fd.
+	//
+	OutputBuffer(int fd, size_t capacity = DEFAULT_OUTPUT_BUFFER_SIZE);
+
+	// destructor
+	// preconditions:	none
+	// postconditions:	Any buffered text is written out.
+	//
+	~OutputBuffer();
+
+	// append(const char *data, size_t length)
+	// Adds length bytes of data to the buffer.
+	// preconditions:	data must point to at least length bytes.
+	// postconditions:	the bytes are buffered; the buffer is written out
+	//					first if they do not fit.
+	//
+	void append(const char *data, size_t length);
+
+	// append(char data)
+	// Adds a single character to the buffer.
+	// preconditions:	none
+	// postconditions:	data is buffered.
+	//
+	void append(char data);
+
+	// appendInt
+	// Adds the decimal text of value to the buffer.
+	// preconditions:	none
+	// postconditions:	value is buffered as an optional '-' followed by its
+	//					digits.
+	//
+	void appendInt(long long value);
+
+	// appendUnsigned
+	// Adds the decimal text of value to the buffer.
+	// preconditions:	none
+	// postconditions:	value is buffered as its digits.
+	//
+	void appendUnsigned(unsigned long long value);
+
+	// flush
+	// Writes out everything buffered so far.
+	// preconditions:	none
+	// postconditions:	the buffer is empty. false is returned if any write
+	//					to the destination has failed.
+	//
+	bool flush();
+
+	// good
+	// preconditions:	none
+	// postconditions:	false is returned if any write to the destination has
+	//					failed, else true.
+	//
+	bool good() const;
+
+private:
+	// copying a buffer would write its contents twice
+	OutputBuffer(const OutputBuffer &buffer);
+	const OutputBuffer& operator=(const OutputBuffer &buffer);
+
+	// m_buffer
+	// the pending bytes, m_used of which are filled
+	//
+	vector<char> m_buffer;
+
+	// m_used
+	// the number of bytes of m_buffer waiting to be written
+	//
+	size_t m_used;
+
+	// m_stream
+	// the ostream destination, or nullptr when writing to m_fd
+	//
+	ostream *m_stream;
+
+	// m_fd
+	// the file descriptor destination, or -1 when writing to m_stream
+	//
+	int m_fd;
+
+	// m_good
+	// false once any write to the destination has failed
+	//
+	bool m_good;
+};
+
+#endif
@@ -0,0 +1,206 @@
+// PerfCounters.cpp		Author: Sam Hoover
+// contains the definitions for the PerfCounters class
+//
+#ifndef PERFCOUNTERS_CPP
+#define PERFCOUNTERS_CPP
+#include <cerrno>
+#include <cstring>
+#include "PerfCounters.h"
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#if defined(__linux__)
+// openEvent
+// Opens one user-space counter for the calling process and the threads it
+// starts later, stopped.
+// preconditions:	none
+// postconditions:	the descriptor is returned, or -1 with errno set
+//
+static int openEvent(unsigned int type, unsigned long long config) {
+	struct perf_event_attr attr;
+	memset(&attr, 0, sizeof(attr));
+	attr.size = sizeof(attr);
+	attr.type = type;
+	attr.config = config;
+	attr.disabled = 1;
+	attr.inherit = 1;
+	attr.exclude_kernel = 1;
+	attr.exclude_hv = 1;
+	attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+	return(static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0)));
+}
+
+// cacheMissConfig
+// preconditions:	cache is a PERF_COUNT_HW_CACHE_* id
+// postconditions:	the config for read misses in cache is returned
+//
+static unsigned long long cacheMissConfig(unsigned long long cache) {
+	return(cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+}
+#endif
+
+// default constructor
+// preconditions:	none
+// postconditions:	every event that can be counted is opened, stopped
+//
+PerfCounters::PerfCounters() : m_error(0) {
+	for(int i = 0; i < COUNTER_KINDS; i++) {
+		m_fds[i] = -1;
+		m_counts[i] = -1;
+	}
+#if defined(__linux__)
+	m_fds[COUNTER_INSTRUCTIONS] = openEvent(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+	if(m_fds[COUNTER_INSTRUCTIONS] < 0 && m_error == 0) {
+		m_error = errno;
+	}
+	m_fds[COUNTER_L1D_MISSES] = openEvent(PERF_TYPE_HW_CACHE, cacheMissConfig(PERF_COUNT_HW_CACHE_L1D));
+	if(m_fds[COUNTER_L1D_MISSES] < 0 && m_error == 0) {
+		m_error = errno;
+	}
+	m_fds[COUNTER_LLC_MISSES] = openEvent(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+	if(m_fds[COUNTER_LLC_MISSES] < 0 && m_error == 0) {
+		m_error = errno;
+	}
+	m_fds[COUNTER_DTLB_MISSES] = openEvent(PERF_TYPE_HW_CACHE, cacheMissConfig(PERF_COUNT_HW_CACHE_DTLB));
+	if(m_fds[COUNTER_DTLB_MISSES] < 0 && m_error == 0) {
+		m_error = errno;
+	}
+	m_fds[COUNTER_BRANCH_MISSES] = openEvent(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+	if(m_fds[COUNTER_BRANCH_MISSES] < 0 && m_error == 0) {
+		m_error = errno;
+	}
+#else
+	m_error = ENOSYS;
+#endif
+}
+
+// destructor
+// preconditions:	none
+// postconditions:	every open event is closed
+//
+PerfCounters::~PerfCounters() {
+#if defined(__linux__)
+	for(int i = 0; i < COUNTER_KINDS; i++) {
+		if(m_fds[i] >= 0) {
+			::close(m_fds[i]);
+		}
+	}
+#endif
+}
+
+// isAvailable
+// preconditions:	none
+// postconditions:	true is returned if at least one event is open
+//
+bool PerfCounters::isAvailable() const {
+	for(int i = 0; i < COUNTER_KINDS; i++) {
+		if(m_fds[i] >= 0) {
+			return(true);
+		}
+	}
+	return(false);
+}
+
+// isAvailable(PerfEvent event)
+// preconditions:	event < COUNTER_KINDS
+// postconditions:	true is returned if event is open
+//
+bool PerfCounters::isAvailable(PerfEvent event) const {
+	return(m_fds[event] >= 0);
+}
+
+// getError
+// Describes why no event could be opened.
+// preconditions:	none
+// postconditions:	the system error text of the first failure is returned,
+//					or an empty string if nothing failed
+//
+string PerfCounters::getError() const {
+	if(m_error == 0) {
+		return(string());
+	}
+	return(string(strerror(m_error)));
+}
+
+// start
+// preconditions:	none
+// postconditions:	every open event is zeroed and counting
+//
+void PerfCounters::start() {
+#if defined(__linux__)
+	for(int i = 0; i < COUNTER_KINDS; i++) {
+		if(m_fds[i] >= 0) {
+			ioctl(m_fds[i], PERF_EVENT_IOC_RESET, 0);
+		}
+	}
+	for(int i = 0; i < COUNTER_KINDS; i++) {
+		if(m_fds[i] >= 0) {
+			ioctl(m_fds[i], PERF_EVENT_IOC_ENABLE, 0);
+		}
+	}
+#endif
+}
+
+// stop
+// A count whose event only ran for part of the region, because the kernel
+// was sharing the counter hardware, is scaled up to the whole region.
+// preconditions:	start was called.
+// postconditions:	every open event has stopped and its count since start
+//					is read
+//
+void PerfCounters::stop() {
+#if defined(__linux__)
+	for(int i = 0; i < COUNTER_KINDS; i++) {
+		if(m_fds[i] >= 0) {
+			ioctl(m_fds[i], PERF_EVENT_IOC_DISABLE, 0);
+		}
+	}
+	for(int i = 0; i < COUNTER_KINDS; i++) {
+		m_counts[i] = -1;
+		// value, time enabled, time running
+		unsigned long long values[3];
+		if(m_fds[i] < 0 || read(m_fds[i], values, sizeof(values)) != static_cast<ssize_t>(sizeof(values))) {
+			continue;
+		}
+		if(values[2] == 0) {
+			continue;
+		}
+		double scale = values[2] < values[1] ? static_cast<double>(values[1]) / values[2] : 1.0;
+		m_counts[i] = static_cast<long long>(values[0] * scale);
+	}
+#endif
+}
+
+// getCount
+// preconditions:	event < COUNTER_KINDS; stop was called.
+// postconditions:	the count of event between the last start and stop is
+//					returned, or -1 if it was not counted
+//
+long long PerfCounters::getCount(PerfEvent event) const {
+	return(m_counts[event]);
+}
+
+// getName
+// preconditions:	event < COUNTER_KINDS
+// postconditions:	a short name for event, such as "l1d_misses", is
+//					returned
+//
+const char* PerfCounters::getName(PerfEvent event) {
+	switch(event) {
+	case COUNTER_INSTRUCTIONS:
+		return("instructions");
+	case COUNTER_L1D_MISSES:
+		return("l1d_misses");
+	case COUNTER_LLC_MISSES:
+		return("llc_misses");
+	case COUNTER_DTLB_MISSES:
+		return("dtlb_misses");
+	default:
+		return("branch_misses");
+	}
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,124 @@
+// PerfCounters.h		Author: Sam Hoover
+// contains the declarations for the PerfCounters class, which reads the
+// processor's hardware event counters around a region of code
+//
+#ifndef PERFCOUNTERS_H
+#define PERFCOUNTERS_H
+#include <string>
+using namespace std;
+
+// PerfEvent
+// the hardware events a PerfCounters object counts
+//		COUNTER_INSTRUCTIONS:	instructions retired
+//		COUNTER_L1D_MISSES:		level 1 data cache read misses
+//		COUNTER_LLC_MISSES:		last level cache misses
+//		COUNTER_DTLB_MISSES:	data TLB read misses
+//		COUNTER_BRANCH_MISSES:	mispredicted branches
+//		COUNTER_KINDS:			the number of events above
+//
+enum PerfEvent {
+	COUNTER_INSTRUCTIONS,
+	COUNTER_L1D_MISSES,
+	COUNTER_LLC_MISSES,
+	COUNTER_DTLB_MISSES,
+	COUNTER_BRANCH_MISSES,
+	COUNTER_KINDS
+};
+
+// PerfCounters
+// Counts hardware events in the calling process between start() and stop()
+// using Linux perf_event_open. Each event is opened on its own, so an event
+// the processor or kernel does not offer only leaves that one count missing.
+// Where no counter can be opened at all (on other systems, or in a
+// container that forbids perf_event_open), isAvailable() returns false and
+// every count reads -1; the object can still be started and stopped.
+//
+// Only user-space events are counted, so the usual perf_event_paranoid
+// setting of 2 does not block the counters. Threads the process starts
+// after the counters are opened are counted too. When the kernel has to
+// share the hardware between more events than it has counters, each count
+// is scaled up by the fraction of the region its event was running.
+//
+class PerfCounters {
+public:
+	// default constructor
+	// preconditions:	none
+	// postconditions:	every event that can be counted is opened, stopped
+	//
+	PerfCounters();
+
+	// destructor
+	// preconditions:	none
+	// postconditions:	every open event is closed
+	//
+	~PerfCounters();
+
+	// isAvailable
+	// preconditions:	none
+	// postconditions:	true is returned if at least one event is open
+	//
+	bool isAvailable() const;
+
+	// isAvailable(PerfEvent event)
+	// preconditions:	event < COUNTER_KINDS
+	// postconditions:	true is returned if event is open
+	//
+	bool isAvailable(PerfEvent event) const;
+
+	// getError
+	// Describes why no event could be opened.
+	// preconditions:	none
+	// postconditions:	the system error text of the first failure is
+	//					returned, or an empty string if nothing failed
+	//
+	string getError() const;
+
+	// start
+	// preconditions:	none
+	// postconditions:	every open event is zeroed and counting
+	//
+	void start();
+
+	// stop
+	// preconditions:	start was called.
+	// postconditions:	every open event has stopped and its count since
+	//					start is read
+	//
+	void stop();
+
+	// getCount
+	// preconditions:	event < COUNTER_KINDS; stop was called.
+	// postconditions:	the count of event between the last start and stop
+	//					is returned, or -1 if it was not counted
+	//
+	long long getCount(PerfEvent event) const;
+
+	// getName
+	// preconditions:	event < COUNTER_KINDS
+	// postconditions:	a short name for event, such as "l1d_misses", is
+	//					returned
+	//
+	static const char* getName(PerfEvent event);
+
+private:
+	// copying would close the same descriptors twice
+	PerfCounters(const PerfCounters &counters);
+	const PerfCounters& operator=(const PerfCounters &counters);
+
+	// m_fds
+	// the perf_event descriptor of each event, or -1 if it is not open
+	//
+	int m_fds[COUNTER_KINDS];
+
+	// m_counts
+	// the count of each event over the last region, or -1
+	//
+	long long m_counts[COUNTER_KINDS];
+
+	// m_error
+	// the errno of the first event that failed to open, or 0
+	//
+	int m_error;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,657 @@
+// RcuBSTree.cpp		Author: Sam Hoover
+// contains the definitions for the BasicRcuBSTree class template. This file
+// is included at the bottom of RcuBSTree.h and needs no separate compilation
+//
+#ifndef RCUBSTREE_CPP
+#define RCUBSTREE_CPP
+#include <thread>
+#include "RcuBSTree.h"
+
+// BasicRcuBSTree::Node constructor(const Key &data)
+// preconditions:	data must be a valid Key object
+// postconditions:	Creates a leaf holding a copy of data with m_itemCount
+//					equal to MIN_ITEM_COUNT
+//
+template<typename Key, typename Compare>
+BasicRcuBSTree<Key, Compare>::Node::Node(const Key &data) : m_item(data),
+		m_itemCount(MIN_ITEM_COUNT), m_left(nullptr), m_right(nullptr), m_height(0),
+		m_version(0) {
+}
+
+// ReadGuard constructor(const BasicRcuBSTree &tree)
+// preconditions:	tree must outlive the guard.
+// postconditions:	the calling thread is reading tree
+//
+template<typename Key, typename Compare>
+BasicRcuBSTree<Key, Compare>::ReadGuard::ReadGuard(const BasicRcuBSTree &tree) : m_tree(tree) {
+	m_tree.beginRead();
+}
+
+// ReadGuard destructor
+// preconditions:	the guard is destroyed by the thread that made it.
+// postconditions:	the calling thread's read of tree has ended if this was
+//					the outermost guard
+//
+template<typename Key, typename Compare>
+BasicRcuBSTree<Key, Compare>::ReadGuard::~ReadGuard() {
+	m_tree.endRead();
+}
+
+// default constructor
+// preconditions:	none
+// postconditions:	Creates an empty tree (m_root equal to nullptr) that is
+//					never rebalanced
+//
+template<typename Key, typename Compare>
+BasicRcuBSTree<Key, Compare>::BasicRcuBSTree() : m_root(nullptr), m_version(0), m_pool(sizeof(Node)),
+		m_policy(UNBALANCED) {}
+
+// constructor(BalancePolicy policy)
+// preconditions:	none
+// postconditions:	Creates an empty tree that applies policy after every
+//					insert and remove
+//
+template<typename Key, typename Compare>
+BasicRcuBSTree<Key, Compare>::BasicRcuBSTree(BalancePolicy policy) : m_root(nullptr), m_version(0),
+		m_pool(sizeof(Node)), m_policy(policy) {}
+
+// destructor
+// preconditions:	no other thread is using the tree.
+// postconditions:	All nodes removed and deleted, m_root set to nullptr
+//
+template<typename Key, typename Compare>
+BasicRcuBSTree<Key, Compare>::~BasicRcuBSTree() {
+	makeEmpty();
+}
+
+// insert(const Key &data)
+// Inserts a copy of data into the tree. If a node containing an equal
+// object already exists in the tree, its m_itemCount is incremented by
+// one. The change is visible to readers all at once.
+// preconditions:	data must be a valid Key object (must not reference
+//					a dereferenced nullptr); this not equal to nullptr.
+// postconditions:	If data does not already exist in the tree, then a new
+//					node with m_item equal to data is inserted into the
+//					tree and true is returned. If the data already exists,
+//					then m_itemCount is incremented by one and false is
+//					returned.
+//
+template<typename Key, typename Compare>
+bool BasicRcuBSTree<Key, Compare>::insert(const Key &data) {
+	lock_guard<mutex> lock(m_writeLock);
+	return(add(data));
+}
+
+// insert(Key *data)
+// Deprecated: use insert(const Key&) or emplace. Readers only ever see the
+// tree's own copy of *data; data itself is left to the caller.
+// preconditions:	data must be a valid Key object not equal to
+//					nullptr; this not equal to nullptr.
+// postconditions:	the same as insert(*data); data is left to the caller.
+//
+template<typename Key, typename Compare>
+bool BasicRcuBSTree<Key, Compare>::insert(Key *data) {
+	return(insert(*data));
+}
+
+// emplace
+// Constructs a Key from args and inserts it into the tree, following the
+// same rules as insert.
+// preconditions:	args must be valid arguments to a Key constructor;
+//					this not equal to nullptr.
+// postconditions:	If the constructed item does not already exist in the
+//					tree, a node holding it is inserted and true is
+//					returned. Otherwise the matching node's m_itemCount is
+//					incremented by one and false is returned.
+//
+template<typename Key, typename Compare>
+template<typename... Args>
+bool BasicRcuBSTree<Key, Compare>::emplace(Args&&... args) {
+	Key data(std::forward<Args>(args)...);
+	lock_guard<mutex> lock(m_writeLock);
+	return(add(data));
+}
+
+// remove
+// Removes a Key object equal to data from the tree. The change is visible
+// to readers all at once.
+// preconditions:	data must be a valid Key object (must not reference
+//					a dereferenced nullptr); this not equal to nullptr.
+// postconditions:	If data is not found, then false is returned. If data
+//					is found and m_itemCount > 1 then m_itemCount is
+//					decremented by one; if m_itemCount == 1 then the node
+//					is removed from the tree and retired.
+//
+template<typename Key, typename Compare>
+bool BasicRcuBSTree<Key, Compare>::remove(const Key &data) {
+	lock_guard<mutex> lock(m_writeLock);
+	// nothing is copied unless the key is there to remove
+	if(findNode(data) == nullptr) {
+		return(false);
+	}
+
+	m_version++;
+	Node *root = m_root.load(memory_order_relaxed);
+	vector<Node**> path;
+	Node **link = &root;
+	while(true) {
+		Node *node = own(*link);
+		*link = node;
+		path.push_back(link);
+		if(isEqual(data, node->m_item)) {
+			break;
+		}
+		link = isLess(data, node->m_item) ? &node->m_left : &node->m_right;
+	}
+
+	if((*link)->m_itemCount > MIN_ITEM_COUNT) {
+		(*link)->m_itemCount--;
+	} else {
+		deleteNode(link, path);
+	}
+	retrace(path);
+	publish(root);
+	return(true);
+}
+
+// makeEmpty
+// Removes all nodes from the tree, waits for current readers to finish,
+// and deletes every node.
+// preconditions:	the calling thread holds no ReadGuard on this tree.
+// postconditions:	All nodes removed and deleted, m_root set to nullptr
+//
+template<typename Key, typename Compare>
+void BasicRcuBSTree<Key, Compare>::makeEmpty() {
+	lock_guard<mutex> lock(m_writeLock);
+	Node *root = m_root.load(memory_order_relaxed);
+	m_root.store(nullptr, memory_order_release);
+	waitForReaders();
+	destroyAll(root);
+	m_retired.clear();
+	m_pool.release();
+}
+
+// synchronize
+// Waits until every reader that started before the call has finished,
+// then deletes all retired nodes.
+// preconditions:	the calling thread holds no ReadGuard on this tree.
+// postconditions:	no retired nodes remain
+//
+template<typename Key, typename Compare>
+void BasicRcuBSTree<Key, Compare>::synchronize() {
+	lock_guard<mutex> lock(m_writeLock);
+	waitForReaders();
+	reclaim(UINT64_MAX);
+}
+
+// retrieve
+// Searches the tree for data, if found, a const pointer to that object is
+// returned. Never blocks.
+// preconditions:	data must be a valid Key object (must not reference
+//					a dereferenced nullptr); the calling thread must hold a
+//					ReadGuard on this tree for as long as it uses the
+//					result.
+// postconditions:	If data is found in the tree, a const pointer to the
+//					object is returned. If data is not found then nullptr
+//					is returned.
+//
+template<typename Key, typename Compare>
+const Key* BasicRcuBSTree<Key, Compare>::retrieve(const Key &data) const {
+	ReadGuard guard(*this);
+	const Node *node = findNode(data);
+	return(node != nullptr ? &node->m_item : nullptr);
+}
+
+// depth
+// Finds the depth of a node with m_item equal to data. Depth of m_root is
+// equal to zero. Never blocks.
+// preconditions:	data must be a valid Key object (must not reference
+//					a dereferenced nullptr); this not equal to nullptr.
+// postconditions:	If data is found in the tree, the depth of the node
+//					is returned. If data is not found, -1 is returned.
+//
+template<typename Key, typename Compare>
+int BasicRcuBSTree<Key, Compare>::depth(const Key &data) const {
+	ReadGuard guard(*this);
+	int dep = 0;
+	if(findNode(data, &dep) == nullptr) {
+		return(VALUE_NOT_FOUND);
+	}
+	return(dep);
+}
+
+// isEmpty
+// Checks the published version of the tree for any nodes.
+// preconditions:	this not equal to nullptr.
+// postconditions:	true is returned if m_root is nullptr; otherwise
+//					false is returned.
+//
+template<typename Key, typename Compare>
+bool BasicRcuBSTree<Key, Compare>::isEmpty() const {
+	return(m_root.load(memory_order_acquire) == nullptr);
+}
+
+// getPolicy
+// preconditions:	none
+// postconditions:	m_policy is returned
+//
+template<typename Key, typename Compare>
+BalancePolicy BasicRcuBSTree<Key, Compare>::getPolicy() const {
+	return(m_policy);
+}
+
+// write
+// Writes one published version of the tree to sout in the same format
+// as operator<<.
+// preconditions:	this not equal to nullptr.
+// postconditions:	the contents of this are written to sout. false is
+//					returned if sout failed.
+//
+template<typename Key, typename Compare>
+bool BasicRcuBSTree<Key, Compare>::write(ostream &sout) const {
+	OutputBuffer out(sout);
+	write(out);
+	return(out.flush());
+}
+
+// write
+// Writes one published version of the tree to the file descriptor fd in
+// the same format as operator<<.
+// preconditions:	fd must be open for writing; this not equal to nullptr.
+// postconditions:	the contents of this are written to fd. false is
+//					returned if a write failed.
+//
+template<typename Key, typename Compare>
+bool BasicRcuBSTree<Key, Compare>::write(int fd) const {
+	OutputBuffer out(fd);
+	write(out);
+	return(out.flush());
+}
+
+// beginRead: ReadGuard helper
+// The outermost read announces the current epoch in the thread's slot of
+// m_epochs, fenced before the load of m_root: either the writer sees this
+// reader, or this reader sees the writer's new root.
+// preconditions:	none
+// postconditions:	the calling thread's slot announces the current epoch
+//
+template<typename Key, typename Compare>
+void BasicRcuBSTree<Key, Compare>::beginRead() const {
+	m_epochs.beginRead();
+}
+
+// endRead: ReadGuard helper
+// preconditions:	follows a beginRead on the same thread.
+// postconditions:	the calling thread's slot is idle if this ended the
+//					outermost read
+//
+template<typename Key, typename Compare>
+void BasicRcuBSTree<Key, Compare>::endRead() const {
+	m_epochs.endRead();
+}
+
+// add: insert helper
+// Copies the path from m_root down to where data belongs, bumps the count
+// or hangs a new leaf from the copy, rebalances the copies and publishes.
+// preconditions:	m_writeLock is held.
+// postconditions:	a new version holding one more data is published;
+//					true is returned if data was not present before.
+//
+template<typename Key, typename Compare>
+bool BasicRcuBSTree<Key, Compare>::add(const Key &data) {
+	m_version++;
+	Node *root = m_root.load(memory_order_relaxed);
+	vector<Node**> path;
+	Node **link = &root;
+	bool added = true;
+	while(*link != nullptr) {
+		Node *node = own(*link);
+		*link = node;
+		path.push_back(link);
+		if(isEqual(data, node->m_item)) {
+			node->m_itemCount++;
+			added = false;
+			break;
+		}
+		link = isLess(data, node->m_item) ? &node->m_left : &node->m_right;
+	}
+	if(added) {
+		*link = newNode(data);
+	}
+	retrace(path);
+	publish(root);
+	return(added);
+}
+
+// own: copy-on-write helper
+// Returns a node the current write may change: node itself if the write
+// created it, otherwise a copy, with node retired.
+// preconditions:	node not equal to nullptr; m_writeLock is held.
+// postconditions:	a node with node's contents and m_version equal to
+//					m_version is returned.
+//
+template<typename Key, typename Compare>
+typename BasicRcuBSTree<Key, Compare>::Node* BasicRcuBSTree<Key, Compare>::own(Node *node) {
+	if(node->m_version == m_version) {
+		return(node);
+	}
+	Node *copy = new(m_pool.allocate()) Node(*node);
+	copy->m_version = m_version;
+	retire(node);
+	return(copy);
+}
+
+// retire: reclamation helper
+// preconditions:	node is no longer reachable from the next version;
+//					m_writeLock is held.
+// postconditions:	node is queued for deletion after the current epoch
+//
+template<typename Key, typename Compare>
+void BasicRcuBSTree<Key, Compare>::retire(Node *node) {
+	m_retired.push_back(make_pair(m_epochs.getEpoch(), node));
+}
+
+// publish: reclamation helper
+// Makes root the tree seen by new readers, starts a new epoch and deletes
+// the retired nodes no reader can still hold. A reader that announced an
+// epoch after the one a node was retired in loaded m_root after root was
+// published, so it cannot reach that node.
+// preconditions:	m_writeLock is held.
+// postconditions:	m_root equals root
+//
+template<typename Key, typename Compare>
+void BasicRcuBSTree<Key, Compare>::publish(Node *root) {
+	m_root.store(root, memory_order_release);
+	m_epochs.advance();
+	reclaim(m_epochs.oldestReader());
+}
+
+// waitForReaders: reclamation helper
+// Starts a new epoch and waits until no reader is in an earlier one.
+// preconditions:	m_writeLock is held.
+// postconditions:	every retired node may be deleted
+//
+template<typename Key, typename Compare>
+void BasicRcuBSTree<Key, Compare>::waitForReaders() {
+	uint64_t epoch = m_epochs.advance();
+	while(m_epochs.oldestReader() < epoch) {
+		this_thread::yield();
+	}
+}
+
+// reclaim: reclamation helper
+// Retired nodes are queued in epoch order, so the deletable ones are a
+// prefix of m_retired.
+// preconditions:	m_writeLock is held.
+// postconditions:	every retired node from an epoch before limit is
+//					deleted
+//
+template<typename Key, typename Compare>
+void BasicRcuBSTree<Key, Compare>::reclaim(uint64_t limit) {
+	size_t done = 0;
+	while(done < m_retired.size() && m_retired[done].first < limit) {
+		freeNode(m_retired[done].second);
+		done++;
+	}
+	m_retired.erase(m_retired.begin(), m_retired.begin() + done);
+}
+
+// deleteNode: remove helper
+// Removes the owned node at link, moving its in-order successor up when
+// it has two children. Every node changed is owned and added to path.
+// preconditions:	*link is owned by the current write and is the last
+//					entry of path.
+// postconditions:	the node is unlinked and path lists the links whose
+//					nodes must be updated, top down.
+//
+template<typename Key, typename Compare>
+void BasicRcuBSTree<Key, Compare>::deleteNode(Node **link, vector<Node**> &path) {
+	Node *node = *link;
+	if(node->m_left == nullptr || node->m_right == nullptr) {
+		// the remaining child is unchanged, so link needs no update
+		*link = node->m_left != nullptr ? node->m_left : node->m_right;
+		path.pop_back();
+		freeNode(node);
+		return;
+	}
+
+	Node **successor = &node->m_right;
+	while((*successor)->m_left != nullptr) {
+		*successor = own(*successor);
+		path.push_back(successor);
+		successor = &(*successor)->m_left;
+	}
+	Node *smallest = *successor;
+	node->m_item = smallest->m_item;
+	node->m_itemCount = smallest->m_itemCount;
+	*successor = smallest->m_right;
+	retire(smallest);
+}
+
+// rotateLeft: balance helper
+// Rotates the subtree rooted at node to the left, making an owned copy of
+// node's right child the new root of the subtree.
+// preconditions:	node is owned by the current write; node->m_right not
+//					equal to nullptr.
+// postconditions:	node points to the new subtree root, which is owned
+//
+template<typename Key, typename Compare>
+void BasicRcuBSTree<Key, Compare>::rotateLeft(Node *&node) {
+	Node *pivot = own(node->m_right);
+	node->m_right = pivot->m_left;
+	pivot->m_left = node;
+	update(node);
+	update(pivot);
+	node = pivot;
+}
+
+// rotateRight: balance helper
+// Rotates the subtree rooted at node to the right, making an owned copy of
+// node's left child the new root of the subtree.
+// preconditions:	node is owned by the current write; node->m_left not
+//					equal to nullptr.
+// postconditions:	node points to the new subtree root, which is owned
+//
+template<typename Key, typename Compare>
+void BasicRcuBSTree<Key, Compare>::rotateRight(Node *&node) {
+	Node *pivot = own(node->m_left);
+	node->m_left = pivot->m_right;
+	pivot->m_right = node;
+	update(node);
+	update(pivot);
+	node = pivot;
+}
+
+// rebalance: balance helper
+// preconditions:	node is owned by the current write.
+// postconditions:	node's height is current and, under AVL, the subtree
+//					is balanced
+//
+template<typename Key, typename Compare>
+void BasicRcuBSTree<Key, Compare>::rebalance(Node *&node) {
+	update(node);
+	if(m_policy != AVL) {
+		return;
+	}
+
+	int balance = height(node->m_left) - height(node->m_right);
+	if(balance > 1) {
+		// left-right case is reduced to left-left first
+		if(height(node->m_left->m_left) < height(node->m_left->m_right)) {
+			node->m_left = own(node->m_left);
+			rotateLeft(node->m_left);
+		}
+		rotateRight(node);
+	} else if(balance < -1) {
+		// right-left case is reduced to right-right first
+		if(height(node->m_right->m_right) < height(node->m_right->m_left)) {
+			node->m_right = own(node->m_right);
+			rotateRight(node->m_right);
+		}
+		rotateLeft(node);
+	}
+}
+
+// retrace: balance helper
+// preconditions:	path lists owned links top down.
+// postconditions:	every link in path is rebalanced, bottom up
+//
+template<typename Key, typename Compare>
+void BasicRcuBSTree<Key, Compare>::retrace(const vector<Node**> &path) {
+	for(size_t i = path.size(); i > 0; i--) {
+		rebalance(*path[i - 1]);
+	}
+}
+
+// height: balance helper
+// preconditions:	none
+// postconditions:	the height of node is returned, -1 for nullptr
+//
+template<typename Key, typename Compare>
+int BasicRcuBSTree<Key, Compare>::height(const Node *node) {
+	return(node == nullptr ? -1 : node->m_height);
+}
+
+// update: balance helper
+// preconditions:	node not equal to nullptr
+// postconditions:	node->m_height is recomputed from its children
+//
+template<typename Key, typename Compare>
+void BasicRcuBSTree<Key, Compare>::update(Node *node) {
+	int left = height(node->m_left);
+	int right = height(node->m_right);
+	node->m_height = 1 + (left > right ? left : right);
+}
+
+// newNode: node allocation helper
+// preconditions:	m_writeLock is held.
+// postconditions:	a leaf holding data, owned by the current write, is
+//					returned
+//
+template<typename Key, typename Compare>
+typename BasicRcuBSTree<Key, Compare>::Node* BasicRcuBSTree<Key, Compare>::newNode(const Key &data) {
+	Node *node = new(m_pool.allocate()) Node(data);
+	node->m_version = m_version;
+	return(node);
+}
+
+// freeNode: node allocation helper
+// preconditions:	no reader can reach node; m_writeLock is held.
+// postconditions:	node is destroyed and its block returned to m_pool
+//
+template<typename Key, typename Compare>
+void BasicRcuBSTree<Key, Compare>::freeNode(Node *node) {
+	node->~Node();
+	m_pool.deallocate(node);
+}
+
+// destroyAll: makeEmpty helper
+// Runs the destructor of every node reachable from root and of every
+// retired node. Skipped when Key needs no destruction.
+// preconditions:	no reader can reach any of the nodes.
+// postconditions:	the nodes' blocks may be released
+//
+template<typename Key, typename Compare>
+void BasicRcuBSTree<Key, Compare>::destroyAll(Node *root) {
+	if(is_trivially_destructible<Key>::value) {
+		return;
+	}
+	vector<Node*> stack;
+	if(root != nullptr) {
+		stack.push_back(root);
+	}
+	while(!stack.empty()) {
+		Node *node = stack.back();
+		stack.pop_back();
+		if(node->m_left != nullptr) {
+			stack.push_back(node->m_left);
+		}
+		if(node->m_right != nullptr) {
+			stack.push_back(node->m_right);
+		}
+		node->~Node();
+	}
+	for(size_t i = 0; i < m_retired.size(); i++) {
+		m_retired[i].second->~Node();
+	}
+}
+
+// findNode: search helper
+// preconditions:	the caller is reading the tree or holds m_writeLock.
+// postconditions:	the node holding data in the published version is
+//					returned, or nullptr. If depth is not nullptr it is
+//					set to the node's depth.
+//
+template<typename Key, typename Compare>
+const typename BasicRcuBSTree<Key, Compare>::Node*
+BasicRcuBSTree<Key, Compare>::findNode(const Key &data, int *depth) const {
+	int dep = 0;
+	const Node *node = m_root.load(memory_order_acquire);
+	while(node != nullptr && !isEqual(data, node->m_item)) {
+		node = isLess(data, node->m_item) ? node->m_left : node->m_right;
+		dep++;
+	}
+	if(depth != nullptr) {
+		*depth = dep;
+	}
+	return(node);
+}
+
+// isLess: comparison helper
+// preconditions:	none
+// postconditions:	true is returned if lhs orders before rhs
+//
+template<typename Key, typename Compare>
+bool BasicRcuBSTree<Key, Compare>::isLess(const Key &lhs, const Key &rhs) const {
+	return(m_compare(lhs, rhs));
+}
+
+// isEqual: comparison helper
+// preconditions:	none
+// postconditions:	true is returned if neither key orders before the
+//					other
+//
+template<typename Key, typename Compare>
+bool BasicRcuBSTree<Key, Compare>::isEqual(const Key &lhs, const Key &rhs) const {
+	return(!m_compare(lhs, rhs) && !m_compare(rhs, lhs));
+}
+
+// write: output helper
+// preconditions:	none
+// postconditions:	each node of one published version is appended to out
+//					in order
+//
+template<typename Key, typename Compare>
+void BasicRcuBSTree<Key, Compare>::write(OutputBuffer &out) const {
+	ReadGuard guard(*this);
+	vector<const Node*> stack;
+	const Node *node = m_root.load(memory_order_acquire);
+	while(node != nullptr || !stack.empty()) {
+		while(node != nullptr) {
+			stack.push_back(node);
+			node = node->m_left;
+		}
+		node = stack.back();
+		stack.pop_back();
+		KeyTraits<Key>::format(out, node->m_item);
+		out.append(' ');
+		out.appendInt(node->m_itemCount);
+		out.append('\n');
+		node = node->m_right;
+	}
+}
+
+// output
+// Prints the contents of the tree to the ostream
+// preconditions:	tree must be a valid BasicRcuBSTree object (must not
+//					reference a dereferenced nullptr).
+// postconditions:	the contents of tree are printed to the ostream. Each
+//					line contains a Node in the format:
+//						"m_item m_itemCount"
+//
+template<typename Key, typename Compare>
+ostream& operator<<(ostream &sout, const BasicRcuBSTree<Key, Compare> &tree) {
+	tree.write(sout);
+	return(sout);
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,403 @@
+// RcuBSTree.h		Author: Sam Hoover
+// contains the declarations for the BasicRcuBSTree class template and the
+// RcuBSTree type, a read-copy-update tree for read-heavy sharing
+//
+#ifndef RCUBSTREE_H
+#define RCUBSTREE_H
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "BSTree.h"
+#include "KeyTraits.h"
+#include "MemoryPool.h"
+#include "OutputBuffer.h"
+#include "RcuReaders.h"
+#include "TreeData.h"
+using namespace std;
+
+// BasicRcuBSTree
+// A binary search tree class template for trees that are read far more often
+// than they are written. It stores Key objects ordered by Compare with the
+// same duplicate-count rules and BalancePolicy as BasicBSTree.
+//
+// Published nodes are never changed. A writer copies every node on the path
+// it modifies (and any node a rotation moves), links the copies into a new
+// version of the tree, and publishes the new root with a release store.
+// Readers load the root and walk it without taking a lock or performing any
+// atomic read-modify-write, so a lookup never waits and never sees a
+// half-finished insert, remove or rotation.
+//
+// Nodes replaced by a write are retired rather than freed. Each reader
+// announces the epoch it started in, in its own slot of m_epochs; a retired
+// node is returned to m_pool once every reader that could still hold it has
+// finished. Writers are serialized by m_writeLock.
+//
+// A pointer returned by retrieve stays valid only while the calling thread
+// holds a ReadGuard on the tree.
+//
+template<typename Key, typename Compare = less<Key> >
+class BasicRcuBSTree {
+
+	// output
+	// Prints the contents of the tree to the ostream
+	// preconditions:	this not equal to nullptr.
+	// postconditions:	each node is printed in order, one per line, in the
+	//					format: "m_item m_itemCount"
+	//
+	template<typename K, typename C>
+	friend ostream& operator<<(ostream &sout, const BasicRcuBSTree<K, C> &tree);
+
+	struct Node;
+
+public:
+	// ReadGuard
+	// Marks a read-side critical section on a tree. Nodes seen while a guard
+	// is held, and pointers returned by retrieve, are not reclaimed until the
+	// guard is destroyed. Guards may be nested.
+	//
+	class ReadGuard {
+	public:
+		// constructor(const BasicRcuBSTree &tree)
+		// preconditions:	tree must outlive the guard.
+		// postconditions:	the calling thread is reading tree
+		//
+		explicit ReadGuard(const BasicRcuBSTree &tree);
+
+		// destructor
+		// preconditions:	the guard is destroyed by the thread that made it.
+		// postconditions:	the calling thread's read of tree has ended if
+		//					this was the outermost guard
+		//
+		~ReadGuard();
+
+	private:
+		// copying a guard is not supported
+		ReadGuard(const ReadGuard &guard);
+		const ReadGuard& operator=(const ReadGuard &guard);
+
+		const BasicRcuBSTree &m_tree;
+	};
+
+	// CONSTRUCTORS/DESTRUCTOR
+
+	// default constructor
+	// preconditions:	none
+	// postconditions:	Creates an empty tree (m_root equal to nullptr)
+	//					that is never rebalanced
+	//
+	BasicRcuBSTree();
+
+	// constructor(BalancePolicy policy)
+	// preconditions:	none
+	// postconditions:	Creates an empty tree that applies policy after every
+	//					insert and remove
+	//
+	BasicRcuBSTree(BalancePolicy policy);
+
+	// destructor
+	// preconditions:	no other thread is using the tree.
+	// postconditions:	All nodes removed and deleted, m_root set to nullptr
+	//
+	~BasicRcuBSTree();
+
+	// MUTATORS
+
+	// insert(const Key &data)
+	// Inserts a copy of data into the tree. If a node containing an equal
+	// object already exists in the tree, its m_itemCount is incremented by
+	// one. The change is visible to readers all at once.
+	// preconditions:	data must be a valid Key object (must not reference
+	//					a dereferenced nullptr); this not equal to nullptr.
+	// postconditions:	If data does not already exist in the tree, then a new
+	//					node with m_item equal to data is inserted into the
+	//					tree and true is returned. If the data already exists,
+	//					then m_itemCount is incremented by one and false is
+	//					returned.
+	//
+	bool insert(const Key &data);
+
+	// insert(Key *data)
+	// Deprecated: use insert(const Key&) or emplace. Readers only ever see the
+	// tree's own copy of *data; data itself is left to the caller.
+	// preconditions:	data must be a valid Key object not equal to
+	//					nullptr; this not equal to nullptr.
+	// postconditions:	the same as insert(*data); data is left to the caller.
+	//
+	bool insert(Key *data);
+
+	// emplace
+	// Constructs a Key from args and inserts it into the tree, following the
+	// same rules as insert.
+	// preconditions:	args must be valid arguments to a Key constructor;
+	//					this not equal to nullptr.
+	// postconditions:	If the constructed item does not already exist in the
+	//					tree, a node holding it is inserted and true is
+	//					returned. Otherwise the matching node's m_itemCount is
+	//					incremented by one and false is returned.
+	//
+	template<typename... Args>
+	bool emplace(Args&&... args);
+
+	// remove
+	// Removes a Key object equal to data from the tree. The change is visible
+	// to readers all at once.
+	// preconditions:	data must be a valid Key object (must not reference
+	//					a dereferenced nullptr); this not equal to nullptr.
+	// postconditions:	If data is not found, then false is returned. If data
+	//					is found and m_itemCount > 1 then m_itemCount is
+	//					decremented by one; if m_itemCount == 1 then the node
+	//					is removed from the tree and retired.
+	//
+	bool remove(const Key &data);
+
+	// makeEmpty
+	// Removes all nodes from the tree, waits for current readers to finish,
+	// and deletes every node.
+	// preconditions:	the calling thread holds no ReadGuard on this tree.
+	// postconditions:	All nodes removed and deleted, m_root set to nullptr
+	//
+	void makeEmpty();
+
+	// synchronize
+	// Waits until every reader that started before the call has finished,
+	// then deletes all retired nodes.
+	// preconditions:	the calling thread holds no ReadGuard on this tree.
+	// postconditions:	no retired nodes remain
+	//
+	void synchronize();
+
+	// ACCESSORS
+
+	// retrieve
+	// Searches the tree for data, if found, a const pointer to that object is
+	// returned. Never blocks.
+	// preconditions:	data must be a valid Key object (must not reference
+	//					a dereferenced nullptr); the calling thread must hold a
+	//					ReadGuard on this tree for as long as it uses the
+	//					result.
+	// postconditions:	If data is found in the tree, a const pointer to the
+	//					object is returned. If data is not found then nullptr
+	//					is returned.
+	//
+	const Key* retrieve(const Key &data) const;
+
+	// depth
+	// Finds the depth of a node with m_item equal to data. Depth of m_root is
+	// equal to zero. Never blocks.
+	// preconditions:	data must be a valid Key object (must not reference
+	//					a dereferenced nullptr); this not equal to nullptr.
+	// postconditions:	If data is found in the tree, the depth of the node
+	//					is returned. If data is not found, -1 is returned.
+	//
+	int depth(const Key &data) const;
+
+	// isEmpty
+	// Checks the published version of the tree for any nodes.
+	// preconditions:	this not equal to nullptr.
+	// postconditions:	true is returned if m_root is nullptr; otherwise
+	//					false is returned.
+	//
+	bool isEmpty() const;
+
+	// getPolicy
+	// preconditions:	none
+	// postconditions:	m_policy is returned
+	//
+	BalancePolicy getPolicy() const;
+
+	// write
+	// Writes one published version of the tree to sout in the same format
+	// as operator<<.
+	// preconditions:	this not equal to nullptr.
+	// postconditions:	the contents of this are written to sout. false is
+	//					returned if sout failed.
+	//
+	bool write(ostream &sout) const;
+
+	// write
+	// Writes one published version of the tree to the file descriptor fd in
+	// the same format as operator<<.
+	// preconditions:	fd must be open for writing; this not equal to nullptr.
+	// postconditions:	the contents of this are written to fd. false is
+	//					returned if a write failed.
+	//
+	bool write(int fd) const;
+
+private:
+	// Node
+	// Fields are only written before a node is published, or on a copy
+	// private to the writer. m_version is the write that created the node.
+	//
+	struct Node {
+		// constructor(const Key &data)
+		// preconditions:	data must be a valid Key object
+		// postconditions:	Creates a leaf holding a copy of data with
+		//					m_itemCount equal to MIN_ITEM_COUNT
+		//
+		Node(const Key &data);
+
+		Key m_item;
+		int m_itemCount;
+		Node *m_left;
+		Node *m_right;
+		int m_height;
+		uint64_t m_version;
+	};
+
+	// copying a shared tree is not supported
+	BasicRcuBSTree(const BasicRcuBSTree &tree);
+	const BasicRcuBSTree& operator=(const BasicRcuBSTree &tree);
+
+	// beginRead / endRead: ReadGuard helpers
+	// preconditions:	endRead follows a beginRead on the same thread.
+	// postconditions:	the calling thread's slot announces the current epoch
+	//					while at least one read is open, and 0 otherwise
+	//
+	void beginRead() const;
+	void endRead() const;
+
+	// add: insert helper
+	// preconditions:	m_writeLock is held.
+	// postconditions:	a new version holding one more data is published;
+	//					true is returned if data was not present before.
+	//
+	bool add(const Key &data);
+
+	// own: copy-on-write helper
+	// Returns a node the current write may change: node itself if the write
+	// created it, otherwise a copy, with node retired.
+	// preconditions:	node not equal to nullptr; m_writeLock is held.
+	// postconditions:	a node with node's contents and m_version equal to
+	//					m_version is returned.
+	//
+	Node* own(Node *node);
+
+	// retire: reclamation helper
+	// preconditions:	node is no longer reachable from the next version;
+	//					m_writeLock is held.
+	// postconditions:	node is queued for deletion after the current epoch
+	//
+	void retire(Node *node);
+
+	// publish: reclamation helper
+	// Makes root the tree seen by new readers, starts a new epoch and deletes
+	// the retired nodes no reader can still hold.
+	// preconditions:	m_writeLock is held.
+	// postconditions:	m_root equals root
+	//
+	void publish(Node *root);
+
+	// waitForReaders: reclamation helper
+	// Starts a new epoch and waits until no reader is in an earlier one.
+	// preconditions:	m_writeLock is held.
+	// postconditions:	every retired node may be deleted
+	//
+	void waitForReaders();
+
+	// reclaim: reclamation helper
+	// preconditions:	m_writeLock is held.
+	// postconditions:	every retired node from an epoch before limit is
+	//					deleted
+	//
+	void reclaim(uint64_t limit);
+
+	// deleteNode: remove helper
+	// Removes the owned node at link, moving its in-order successor up when
+	// it has two children. Every node changed is owned and added to path.
+	// preconditions:	*link is owned by the current write and is the last
+	//					entry of path.
+	// postconditions:	the node is unlinked and path lists the links whose
+	//					nodes must be updated, top down.
+	//
+	void deleteNode(Node **link, vector<Node**> &path);
+
+	// rotateLeft / rotateRight: balance helpers
+	// preconditions:	node is owned by the current write; the child moved up
+	//					is not nullptr.
+	// postconditions:	node points to the new subtree root, which is owned
+	//
+	void rotateLeft(Node *&node);
+	void rotateRight(Node *&node);
+
+	// rebalance: balance helper
+	// preconditions:	node is owned by the current write.
+	// postconditions:	node's height is current and, under AVL, the subtree
+	//					is balanced
+	//
+	void rebalance(Node *&node);
+
+	// retrace: balance helper
+	// preconditions:	path lists owned links top down.
+	// postconditions:	every link in path is rebalanced, bottom up
+	//
+	void retrace(const vector<Node**> &path);
+
+	// height / update: balance helpers
+	// preconditions:	none / node not equal to nullptr
+	// postconditions:	the height of node (-1 for nullptr) is returned /
+	//					node->m_height is recomputed from its children
+	//
+	static int height(const Node *node);
+	static void update(Node *node);
+
+	// newNode / freeNode: node allocation helpers
+	// preconditions:	m_writeLock is held (or the tree is not shared).
+	// postconditions:	a node built in m_pool is returned / node is
+	//					destroyed and its block returned to m_pool
+	//
+	Node* newNode(const Key &data);
+	void freeNode(Node *node);
+
+	// destroyAll: makeEmpty helper
+	// Runs the destructor of every node reachable from root and of every
+	// retired node. Skipped when Key needs no destruction.
+	// preconditions:	no reader can reach any of the nodes.
+	// postconditions:	the nodes' blocks may be released
+	//
+	void destroyAll(Node *root);
+
+	// findNode: search helper
+	// preconditions:	the caller is reading the tree or holds m_writeLock.
+	// postconditions:	the node holding data in the published version is
+	//					returned, or nullptr. If depth is not nullptr it is
+	//					set to the node's depth.
+	//
+	const Node* findNode(const Key &data, int *depth = nullptr) const;
+
+	// isLess / isEqual: comparison helpers
+	// preconditions:	none
+	// postconditions:	true is returned if lhs orders before rhs / if
+	//					neither key orders before the other
+	//
+	bool isLess(const Key &lhs, const Key &rhs) const;
+	bool isEqual(const Key &lhs, const Key &rhs) const;
+
+	// write: output helper
+	// preconditions:	none
+	// postconditions:	each node of one published version is appended to
+	//					out in order
+	//
+	void write(OutputBuffer &out) const;
+
+	atomic<Node*> m_root;
+	mutable RcuEpochs m_epochs;
+	mutex m_writeLock;
+	uint64_t m_version;
+	vector<pair<uint64_t, Node*> > m_retired;
+	MemoryPool m_pool;
+	BalancePolicy m_policy;
+	Compare m_compare;
+};
+
+// RcuBSTree
+// the read-copy-update tree of TreeData objects
+//
+typedef BasicRcuBSTree<TreeData> RcuBSTree;
+
+#include "RcuBSTree.cpp"
+#endif
\ No newline at end of file
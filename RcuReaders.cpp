@@ -0,0 +1,213 @@
+// RcuReaders.cpp		Author: Sam Hoover
+// contains the definitions for reader thread identification and the
+// RcuEpochs class
+//
+#ifndef RCUREADERS_CPP
+#define RCUREADERS_CPP
+#include "RcuReaders.h"
+
+// IndexBlock
+// RCU_READER_BLOCK reader indices, each free or taken, and the block after
+// them. Block k of the list holds the indices from k * RCU_READER_BLOCK.
+// The struct has no constructor so that the first block is zero-initialized
+// before any thread can run, and new IndexBlock() zero-initializes the rest.
+//
+struct IndexBlock {
+	atomic<bool> m_taken[RCU_READER_BLOCK];
+	atomic<IndexBlock*> m_next;
+};
+
+// g_indices
+// the first block of reader indices, shared by every thread
+//
+static IndexBlock g_indices;
+
+// ReaderIndex
+// Holds one thread's index for as long as the thread lives.
+//
+struct ReaderIndex {
+	// default constructor
+	// Claims the first free index with a compare-and-swap, appending a new
+	// block to the list when every index is taken.
+	// preconditions:	none
+	// postconditions:	an index no other live thread holds is taken
+	//
+	ReaderIndex() {
+		IndexBlock *block = &g_indices;
+		int first = 0;
+		for(;;) {
+			for(int i = 0; i < RCU_READER_BLOCK; i++) {
+				bool taken = false;
+				if(!block->m_taken[i].load(memory_order_relaxed) &&
+						block->m_taken[i].compare_exchange_strong(taken, true, memory_order_acquire)) {
+					m_taken = &block->m_taken[i];
+					m_index = first + i;
+					return;
+				}
+			}
+			IndexBlock *next = block->m_next.load(memory_order_acquire);
+			if(next == nullptr) {
+				IndexBlock *grown = new IndexBlock();
+				if(block->m_next.compare_exchange_strong(next, grown, memory_order_acq_rel)) {
+					next = grown;
+				} else {
+					delete grown;
+				}
+			}
+			block = next;
+			first += RCU_READER_BLOCK;
+		}
+	}
+
+	// destructor
+	// preconditions:	none
+	// postconditions:	m_index is free for another thread
+	//
+	~ReaderIndex() {
+		m_taken->store(false, memory_order_release);
+	}
+
+	atomic<bool> *m_taken;
+	int m_index;
+};
+
+// rcuReaderIndex
+// Returns the calling thread's reader index. An index is assigned the first
+// time a thread calls this and is given back when the thread exits, so it is
+// stable for the life of the thread. Taking an index never waits: a thread
+// that finds every index taken adds a block of new ones.
+// preconditions:	none
+// postconditions:	a value >= 0 that no other live thread holds is returned.
+//					Indices are reused, so they stay below the largest
+//					number of threads ever alive at once, rounded up to a
+//					multiple of RCU_READER_BLOCK.
+//
+int rcuReaderIndex() {
+	static thread_local ReaderIndex index;
+	return(index.m_index);
+}
+
+// ReaderBlock default constructor
+// preconditions:	none
+// postconditions:	every slot is idle and there is no next block
+//
+RcuEpochs::ReaderBlock::ReaderBlock() : m_next(nullptr) {
+	for(int i = 0; i < RCU_READER_BLOCK; i++) {
+		m_slots[i].m_epoch.store(0, memory_order_relaxed);
+		m_slots[i].m_nesting = 0;
+	}
+}
+
+// default constructor
+// preconditions:	none
+// postconditions:	the epoch is 1 and every slot is idle
+//
+RcuEpochs::RcuEpochs() : m_epoch(1) {}
+
+// destructor
+// preconditions:	no thread is reading
+// postconditions:	every added block is deleted
+//
+RcuEpochs::~RcuEpochs() {
+	ReaderBlock *block = m_readers.m_next.load(memory_order_acquire);
+	while(block != nullptr) {
+		ReaderBlock *next = block->m_next.load(memory_order_relaxed);
+		delete block;
+		block = next;
+	}
+}
+
+// beginRead
+// The outermost read of the calling thread stores the current epoch in its
+// slot. A full fence follows, pairing with the one in advance(): either the
+// writer sees this reader, or this reader sees everything the writer
+// published before advancing.
+// preconditions:	none
+// postconditions:	the calling thread's slot announces the current epoch
+//
+void RcuEpochs::beginRead() {
+	ReaderSlot &reader = slot(rcuReaderIndex());
+	if(reader.m_nesting++ == 0) {
+		reader.m_epoch.store(m_epoch.load(memory_order_acquire), memory_order_relaxed);
+		atomic_thread_fence(memory_order_seq_cst);
+	}
+}
+
+// endRead
+// preconditions:	follows a beginRead on the same thread.
+// postconditions:	the calling thread's slot is idle if this ended the
+//					outermost read
+//
+void RcuEpochs::endRead() {
+	ReaderSlot &reader = slot(rcuReaderIndex());
+	if(--reader.m_nesting == 0) {
+		reader.m_epoch.store(0, memory_order_release);
+	}
+}
+
+// getEpoch
+// preconditions:	none
+// postconditions:	the current epoch is returned
+//
+uint64_t RcuEpochs::getEpoch() const {
+	return(m_epoch.load(memory_order_acquire));
+}
+
+// advance
+// Starts a new epoch, then issues a full fence so that the readers seen by a
+// later oldestReader() include every reader that could have missed the
+// writes made before this call.
+// preconditions:	none
+// postconditions:	the new epoch is returned
+//
+uint64_t RcuEpochs::advance() {
+	uint64_t epoch = m_epoch.fetch_add(1, memory_order_acq_rel) + 1;
+	atomic_thread_fence(memory_order_seq_cst);
+	return(epoch);
+}
+
+// oldestReader
+// A block appended by a reader before its fence in beginRead is seen here,
+// as the reader's slot is, by the fence argument in beginRead.
+// preconditions:	none
+// postconditions:	the smallest epoch announced by an active reader is
+//					returned, or UINT64_MAX if no reader is active
+//
+uint64_t RcuEpochs::oldestReader() const {
+	uint64_t oldest = UINT64_MAX;
+	for(const ReaderBlock *block = &m_readers; block != nullptr; block = block->m_next.load(memory_order_acquire)) {
+		for(int i = 0; i < RCU_READER_BLOCK; i++) {
+			uint64_t epoch = block->m_slots[i].m_epoch.load(memory_order_acquire);
+			if(epoch != 0 && epoch < oldest) {
+				oldest = epoch;
+			}
+		}
+	}
+	return(oldest);
+}
+
+// slot: reader helper
+// Finds the slot for a reader index, adding blocks up to it if needed. A
+// block lost in a race to append is deleted and the winner's is used.
+// preconditions:	index >= 0
+// postconditions:	the slot of index is returned
+//
+RcuEpochs::ReaderSlot& RcuEpochs::slot(int index) {
+	ReaderBlock *block = &m_readers;
+	while(index >= RCU_READER_BLOCK) {
+		ReaderBlock *next = block->m_next.load(memory_order_acquire);
+		if(next == nullptr) {
+			ReaderBlock *grown = new ReaderBlock();
+			if(block->m_next.compare_exchange_strong(next, grown, memory_order_acq_rel)) {
+				next = grown;
+			} else {
+				delete grown;
+			}
+		}
+		block = next;
+		index -= RCU_READER_BLOCK;
+	}
+	return(block->m_slots[index]);
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,139 @@
+// RcuReaders.h		Author: Sam Hoover
+// contains the declarations shared by every read-copy-update tree for
+// identifying reader threads and tracking the epochs they read in
+//
+#ifndef RCUREADERS_H
+#define RCUREADERS_H
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+using namespace std;
+
+// RCU_READER_BLOCK
+// the number of reader indices, and of reader slots, in each block. Blocks
+// are added as more threads read at once, so this is not a limit on readers.
+//
+const int RCU_READER_BLOCK = 128;
+
+// RCU_CACHE_LINE
+// the size in bytes that each reader's slot is padded to, so that readers
+// announcing themselves do not share cache lines
+//
+const size_t RCU_CACHE_LINE = 64;
+
+// rcuReaderIndex
+// Returns the calling thread's reader index. An index is assigned the first
+// time a thread calls this and is given back when the thread exits, so it is
+// stable for the life of the thread. Taking an index never waits: a thread
+// that finds every index taken adds a block of new ones.
+// preconditions:	none
+// postconditions:	a value >= 0 that no other live thread holds is returned.
+//					Indices are reused, so they stay below the largest
+//					number of threads ever alive at once, rounded up to a
+//					multiple of RCU_READER_BLOCK.
+//
+int rcuReaderIndex();
+
+// RcuEpochs
+// The epoch bookkeeping of one read-copy-update structure. Each reader
+// thread announces the epoch it started reading in, in the slot for its
+// rcuReaderIndex(); a writer advances the epoch after unlinking memory and
+// asks for the oldest epoch still announced to learn which retired memory
+// no reader can reach.
+//
+// Slots come in blocks of RCU_READER_BLOCK, one of them held inline. A reader
+// whose index lies past the last block appends a new block with a
+// compare-and-swap, so neither readers nor writers ever wait on a lock here.
+// Blocks are freed with the RcuEpochs.
+//
+class RcuEpochs {
+public:
+	// default constructor
+	// preconditions:	none
+	// postconditions:	the epoch is 1 and every slot is idle
+	//
+	RcuEpochs();
+
+	// destructor
+	// preconditions:	no thread is reading
+	// postconditions:	every added block is deleted
+	//
+	~RcuEpochs();
+
+	// beginRead
+	// The outermost read of the calling thread stores the current epoch in
+	// its slot. A full fence follows, pairing with the one in advance():
+	// either the writer sees this reader, or this reader sees everything the
+	// writer published before advancing.
+	// preconditions:	none
+	// postconditions:	the calling thread's slot announces the current epoch
+	//
+	void beginRead();
+
+	// endRead
+	// preconditions:	follows a beginRead on the same thread.
+	// postconditions:	the calling thread's slot is idle if this ended the
+	//					outermost read
+	//
+	void endRead();
+
+	// getEpoch
+	// preconditions:	none
+	// postconditions:	the current epoch is returned
+	//
+	uint64_t getEpoch() const;
+
+	// advance
+	// Starts a new epoch, then issues a full fence so that the readers seen
+	// by a later oldestReader() include every reader that could have missed
+	// the writes made before this call.
+	// preconditions:	none
+	// postconditions:	the new epoch is returned
+	//
+	uint64_t advance();
+
+	// oldestReader
+	// preconditions:	none
+	// postconditions:	the smallest epoch announced by an active reader is
+	//					returned, or UINT64_MAX if no reader is active
+	//
+	uint64_t oldestReader() const;
+
+private:
+	// copying would duplicate the slots of live readers
+	RcuEpochs(const RcuEpochs &epochs);
+	const RcuEpochs& operator=(const RcuEpochs &epochs);
+
+	// ReaderSlot
+	// The epoch a reader started in (0 when idle) and its read nesting
+	// depth, padded to its own cache line. Only the owning thread writes
+	// a slot.
+	//
+	struct ReaderSlot {
+		atomic<uint64_t> m_epoch;
+		int m_nesting;
+		char m_padding[RCU_CACHE_LINE - sizeof(atomic<uint64_t>) - sizeof(int)];
+	};
+
+	// ReaderBlock
+	// RCU_READER_BLOCK slots and the block after them, if any
+	//
+	struct ReaderBlock {
+		ReaderBlock();
+
+		ReaderSlot m_slots[RCU_READER_BLOCK];
+		atomic<ReaderBlock*> m_next;
+	};
+
+	// slot: reader helper
+	// Finds the slot for a reader index, adding blocks up to it if needed.
+	// preconditions:	index >= 0
+	// postconditions:	the slot of index is returned
+	//
+	ReaderSlot& slot(int index);
+
+	atomic<uint64_t> m_epoch;
+	ReaderBlock m_readers;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,515 @@
+// ShardedBSTree.cpp		Author: Sam Hoover
+// contains the definitions for the BasicShardedBSTree class template. This
+// file is included at the bottom of ShardedBSTree.h and needs no separate
+// compilation
+//
+#ifndef SHARDEDBSTREE_CPP
+#define SHARDEDBSTREE_CPP
+#include "ShardedBSTree.h"
+
+// BasicShardedBSTree::Shard constructor(BalancePolicy policy)
+// preconditions:	none
+// postconditions:	creates an empty shard applying policy
+//
+template<typename Key, typename Compare>
+BasicShardedBSTree<Key, Compare>::Shard::Shard(BalancePolicy policy) : m_tree(policy) {}
+
+// const_iterator default constructor
+// preconditions:	none
+// postconditions:	creates an iterator that refers to no container
+//
+template<typename Key, typename Compare>
+BasicShardedBSTree<Key, Compare>::const_iterator::const_iterator() : m_owner(nullptr), m_shard(0) {}
+
+// const_iterator constructor(const BasicShardedBSTree *owner, size_t shard)
+// preconditions:	shard <= the number of shards
+// postconditions:	creates an iterator at the first key at or after the
+//					start of shard
+//
+template<typename Key, typename Compare>
+BasicShardedBSTree<Key, Compare>::const_iterator::const_iterator(const BasicShardedBSTree *owner,
+		size_t shard) : m_owner(owner), m_shard(shard) {
+	if(m_shard < m_owner->m_shards.size()) {
+		m_current = m_owner->m_shards[m_shard]->m_tree.begin();
+	}
+	skipEmpty();
+}
+
+// const_iterator dereference
+// preconditions:	this must not be an end iterator.
+// postconditions:	the current key is returned
+//
+template<typename Key, typename Compare>
+const Key& BasicShardedBSTree<Key, Compare>::const_iterator::operator*() const {
+	return(*m_current);
+}
+
+// const_iterator member access
+// preconditions:	this must not be an end iterator.
+// postconditions:	a pointer to the current key is returned
+//
+template<typename Key, typename Compare>
+const Key* BasicShardedBSTree<Key, Compare>::const_iterator::operator->() const {
+	return(&*m_current);
+}
+
+// const_iterator getCount
+// preconditions:	this must not be an end iterator.
+// postconditions:	the number of occurrences of the current key is returned
+//
+template<typename Key, typename Compare>
+int BasicShardedBSTree<Key, Compare>::const_iterator::getCount() const {
+	return(m_current.getCount());
+}
+
+// const_iterator pre-increment
+// Moves to the next key, crossing into the next non-empty shard when the
+// current one is finished.
+// preconditions:	this must not be an end iterator.
+// postconditions:	this refers to the next key or is the end iterator. this
+//					is returned.
+//
+template<typename Key, typename Compare>
+typename BasicShardedBSTree<Key, Compare>::const_iterator&
+BasicShardedBSTree<Key, Compare>::const_iterator::operator++() {
+	++m_current;
+	skipEmpty();
+	return(*this);
+}
+
+// const_iterator post-increment
+// preconditions:	this must not be an end iterator.
+// postconditions:	this is advanced; its old position is returned
+//
+template<typename Key, typename Compare>
+typename BasicShardedBSTree<Key, Compare>::const_iterator
+BasicShardedBSTree<Key, Compare>::const_iterator::operator++(int) {
+	const_iterator old = *this;
+	++(*this);
+	return(old);
+}
+
+// const_iterator equality
+// preconditions:	other must iterate over the same container.
+// postconditions:	true is returned if both refer to the same key or both
+//					are end iterators.
+//
+template<typename Key, typename Compare>
+bool BasicShardedBSTree<Key, Compare>::const_iterator::operator==(const const_iterator &other) const {
+	if(m_shard != other.m_shard) {
+		return(false);
+	}
+	return(m_owner == nullptr || m_shard == m_owner->m_shards.size() || m_current == other.m_current);
+}
+
+// const_iterator inequality
+// preconditions:	other must iterate over the same container.
+// postconditions:	true is returned if the iterators differ.
+//
+template<typename Key, typename Compare>
+bool BasicShardedBSTree<Key, Compare>::const_iterator::operator!=(const const_iterator &other) const {
+	return(!(*this == other));
+}
+
+// const_iterator skipEmpty: traversal helper
+// preconditions:	none
+// postconditions:	this refers to a key, or is the end iterator
+//
+template<typename Key, typename Compare>
+void BasicShardedBSTree<Key, Compare>::const_iterator::skipEmpty() {
+	const vector<Shard*> &shards = m_owner->m_shards;
+	while(m_shard < shards.size() && m_current == shards[m_shard]->m_tree.end()) {
+		m_shard++;
+		if(m_shard < shards.size()) {
+			m_current = shards[m_shard]->m_tree.begin();
+		}
+	}
+}
+
+// constructor(int shardCount, BalancePolicy policy)
+// Until boundaries are chosen every key goes to the first shard.
+// preconditions:	shardCount > 0
+// postconditions:	Creates shardCount empty shards that apply policy
+//
+template<typename Key, typename Compare>
+BasicShardedBSTree<Key, Compare>::BasicShardedBSTree(int shardCount, BalancePolicy policy) {
+	makeShards(shardCount, policy);
+}
+
+// constructor(InputIt begin, InputIt end, int shardCount, BalancePolicy)
+// Chooses the boundaries so that the sample keys in [begin, end) would be
+// spread evenly over the shards. The sample is not inserted.
+// preconditions:	shardCount > 0; InputIt dereferences to Key
+// postconditions:	Creates shardCount empty shards that apply policy
+//
+template<typename Key, typename Compare>
+template<typename InputIt>
+BasicShardedBSTree<Key, Compare>::BasicShardedBSTree(InputIt begin, InputIt end, int shardCount,
+		BalancePolicy policy) {
+	makeShards(shardCount, policy);
+	vector<Key> sample(begin, end);
+	sort(sample.begin(), sample.end(), m_compare);
+	chooseBoundaries(sample);
+}
+
+// destructor
+// preconditions:	no other thread is using the container.
+// postconditions:	every shard and its nodes are deleted
+//
+template<typename Key, typename Compare>
+BasicShardedBSTree<Key, Compare>::~BasicShardedBSTree() {
+	for(size_t i = 0; i < m_shards.size(); i++) {
+		delete m_shards[i];
+		m_shards[i] = nullptr;
+	}
+}
+
+// insert(const Key &data)
+// Inserts a copy of data into the shard that owns its range, following
+// the rules of BasicBSTree::insert. Safe to call from any number of
+// threads.
+// preconditions:	data must be a valid Key object (must not reference
+//					a dereferenced nullptr); this not equal to nullptr.
+// postconditions:	If data does not already exist, a new node is inserted
+//					and true is returned. Otherwise m_itemCount is
+//					incremented by one and false is returned.
+//
+template<typename Key, typename Compare>
+bool BasicShardedBSTree<Key, Compare>::insert(const Key &data) {
+	Shard *shard = m_shards[shardOf(data)];
+	lock_guard<mutex> lock(shard->m_lock);
+	return(shard->m_tree.insert(data));
+}
+
+// insert(Key *data)
+// Deprecated: use insert(const Key&) or emplace. The shard stores a copy of
+// *data and data is never deleted by the tree.
+// preconditions:	data must be a valid Key object not equal to nullptr;
+//					this not equal to nullptr.
+// postconditions:	the same as insert(*data); data is left to the caller.
+//
+template<typename Key, typename Compare>
+bool BasicShardedBSTree<Key, Compare>::insert(Key *data) {
+	return(insert(*data));
+}
+
+// emplace
+// Constructs a Key from args and inserts it, following the same rules as
+// insert. Safe to call from any number of threads.
+// preconditions:	args must be valid arguments to a Key constructor;
+//					this not equal to nullptr.
+// postconditions:	true is returned if a new node was inserted, false if an
+//					existing count was incremented.
+//
+template<typename Key, typename Compare>
+template<typename... Args>
+bool BasicShardedBSTree<Key, Compare>::emplace(Args&&... args) {
+	Key data(std::forward<Args>(args)...);
+	Shard *shard = m_shards[shardOf(data)];
+	lock_guard<mutex> lock(shard->m_lock);
+	return(shard->m_tree.emplace(std::move(data)));
+}
+
+// remove
+// Removes a Key object equal to data from the shard that owns its range,
+// following the rules of BasicBSTree::remove. Safe to call from any number
+// of threads.
+// preconditions:	data must be a valid Key object (must not reference
+//					a dereferenced nullptr); this not equal to nullptr.
+// postconditions:	false is returned if data is not found; otherwise its
+//					count is decremented or its node removed and true is
+//					returned.
+//
+template<typename Key, typename Compare>
+bool BasicShardedBSTree<Key, Compare>::remove(const Key &data) {
+	Shard *shard = m_shards[shardOf(data)];
+	lock_guard<mutex> lock(shard->m_lock);
+	return(shard->m_tree.remove(data));
+}
+
+// makeEmpty
+// Removes and deletes all nodes from every shard. The boundaries are kept.
+// preconditions:	this not equal to nullptr.
+// postconditions:	every shard is empty
+//
+template<typename Key, typename Compare>
+void BasicShardedBSTree<Key, Compare>::makeEmpty() {
+	for(size_t i = 0; i < m_shards.size(); i++) {
+		lock_guard<mutex> lock(m_shards[i]->m_lock);
+		m_shards[i]->m_tree.makeEmpty();
+	}
+}
+
+// rebalanceShards
+// Recomputes the boundaries so that each shard holds about the same number
+// of distinct keys, and moves every key to its new shard. Each new shard is
+// built in one linear pass by assignSorted.
+// preconditions:	no other thread is using the container.
+// postconditions:	the container holds the same keys and counts, spread
+//					evenly over the shards
+//
+template<typename Key, typename Compare>
+void BasicShardedBSTree<Key, Compare>::rebalanceShards() {
+	vector<Key> keys;
+	vector<int> counts;
+	for(const_iterator it = begin(); it != end(); ++it) {
+		keys.push_back(*it);
+		counts.push_back(it.getCount());
+	}
+	chooseBoundaries(keys);
+
+	size_t next = 0;
+	for(size_t i = 0; i < m_shards.size(); i++) {
+		// repeat each key by its count so assignSorted folds it back
+		vector<Key> run;
+		while(next < keys.size() && (i == m_boundaries.size() ||
+				m_compare(keys[next], m_boundaries[i]))) {
+			run.insert(run.end(), counts[next], keys[next]);
+			next++;
+		}
+		m_shards[i]->m_tree.assignSorted(run.begin(), run.end());
+	}
+}
+
+// retrieve
+// Searches the shard that owns data's range.
+// preconditions:	data must be a valid Key object (must not reference
+//					a dereferenced nullptr); this not equal to nullptr.
+// postconditions:	If data is found, a const pointer to the stored object
+//					is returned, valid until that key is removed. If data is
+//					not found then nullptr is returned.
+//
+template<typename Key, typename Compare>
+const Key* BasicShardedBSTree<Key, Compare>::retrieve(const Key &data) const {
+	const Shard *shard = m_shards[shardOf(data)];
+	lock_guard<mutex> lock(shard->m_lock);
+	return(shard->m_tree.retrieve(data));
+}
+
+// depth
+// Finds the depth of data within the tree of its shard.
+// preconditions:	data must be a valid Key object (must not reference
+//					a dereferenced nullptr); this not equal to nullptr.
+// postconditions:	the depth of data's node in its shard is returned, or
+//					-1 if data is not found.
+//
+template<typename Key, typename Compare>
+int BasicShardedBSTree<Key, Compare>::depth(const Key &data) const {
+	const Shard *shard = m_shards[shardOf(data)];
+	lock_guard<mutex> lock(shard->m_lock);
+	return(shard->m_tree.depth(data));
+}
+
+// descendants
+// Finds the number of descendants of data's node within the tree of its
+// shard.
+// preconditions:	data must be a valid Key object (must not reference
+//					a dereferenced nullptr); this not equal to nullptr.
+// postconditions:	the number of descendants is returned, or -1 if data is
+//					not found.
+//
+template<typename Key, typename Compare>
+int BasicShardedBSTree<Key, Compare>::descendants(const Key &data) const {
+	const Shard *shard = m_shards[shardOf(data)];
+	lock_guard<mutex> lock(shard->m_lock);
+	return(shard->m_tree.descendants(data));
+}
+
+// size
+// preconditions:	this not equal to nullptr.
+// postconditions:	the number of distinct keys in all shards is returned
+//
+template<typename Key, typename Compare>
+int BasicShardedBSTree<Key, Compare>::size() const {
+	int total = 0;
+	for(size_t i = 0; i < m_shards.size(); i++) {
+		lock_guard<mutex> lock(m_shards[i]->m_lock);
+		total += m_shards[i]->m_tree.size();
+	}
+	return(total);
+}
+
+// rank
+// Counts the distinct keys ordered before data across all shards: every
+// key of the shards before data's, plus data's rank within its shard.
+// preconditions:	data must be a valid Key object (must not reference
+//					a dereferenced nullptr); this not equal to nullptr.
+// postconditions:	the number of keys less than data is returned
+//
+template<typename Key, typename Compare>
+int BasicShardedBSTree<Key, Compare>::rank(const Key &data) const {
+	size_t owner = shardOf(data);
+	int total = 0;
+	for(size_t i = 0; i < owner; i++) {
+		lock_guard<mutex> lock(m_shards[i]->m_lock);
+		total += m_shards[i]->m_tree.size();
+	}
+	lock_guard<mutex> lock(m_shards[owner]->m_lock);
+	return(total + m_shards[owner]->m_tree.rank(data));
+}
+
+// select
+// Finds the key with the given rank across all shards (0 is the smallest).
+// preconditions:	this not equal to nullptr.
+// postconditions:	If 0 <= index < size(), a const pointer to the key of
+//					that rank is returned, else nullptr is returned.
+//
+template<typename Key, typename Compare>
+const Key* BasicShardedBSTree<Key, Compare>::select(int index) const {
+	if(index < 0) {
+		return(nullptr);
+	}
+	for(size_t i = 0; i < m_shards.size(); i++) {
+		lock_guard<mutex> lock(m_shards[i]->m_lock);
+		int count = m_shards[i]->m_tree.size();
+		if(index < count) {
+			return(m_shards[i]->m_tree.select(index));
+		}
+		index -= count;
+	}
+	return(nullptr);
+}
+
+// isEmpty
+// preconditions:	this not equal to nullptr.
+// postconditions:	true is returned if every shard is empty, else false
+//
+template<typename Key, typename Compare>
+bool BasicShardedBSTree<Key, Compare>::isEmpty() const {
+	for(size_t i = 0; i < m_shards.size(); i++) {
+		lock_guard<mutex> lock(m_shards[i]->m_lock);
+		if(!m_shards[i]->m_tree.isEmpty()) {
+			return(false);
+		}
+	}
+	return(true);
+}
+
+// getShardCount
+// preconditions:	none
+// postconditions:	the number of shards is returned
+//
+template<typename Key, typename Compare>
+int BasicShardedBSTree<Key, Compare>::getShardCount() const {
+	return(static_cast<int>(m_shards.size()));
+}
+
+// write
+// Writes every shard in order to sout in the same format as operator<<.
+// Each shard is locked while it is written.
+// preconditions:	this not equal to nullptr.
+// postconditions:	the contents of this are written to sout. false is
+//					returned if sout failed.
+//
+template<typename Key, typename Compare>
+bool BasicShardedBSTree<Key, Compare>::write(ostream &sout) const {
+	bool good = true;
+	for(size_t i = 0; i < m_shards.size() && good; i++) {
+		lock_guard<mutex> lock(m_shards[i]->m_lock);
+		good = m_shards[i]->m_tree.write(sout);
+	}
+	return(good);
+}
+
+// begin
+// preconditions:	no other thread is writing to the container.
+// postconditions:	an iterator to the smallest key is returned, or end() if
+//					the container is empty.
+//
+template<typename Key, typename Compare>
+typename BasicShardedBSTree<Key, Compare>::const_iterator BasicShardedBSTree<Key, Compare>::begin() const {
+	return(const_iterator(this, 0));
+}
+
+// end
+// preconditions:	none
+// postconditions:	the iterator one past the largest key is returned.
+//
+template<typename Key, typename Compare>
+typename BasicShardedBSTree<Key, Compare>::const_iterator BasicShardedBSTree<Key, Compare>::end() const {
+	return(const_iterator(this, m_shards.size()));
+}
+
+// equality
+// Compares the keys and counts of both containers in order, regardless of
+// how each is split into shards.
+// preconditions:	no other thread is writing to either container.
+// postconditions:	true is returned if both hold the same keys with the same
+//					counts, else false.
+//
+template<typename Key, typename Compare>
+bool BasicShardedBSTree<Key, Compare>::operator==(const BasicShardedBSTree &tree) const {
+	const_iterator mine = begin();
+	const_iterator theirs = tree.begin();
+	while(mine != end() && theirs != tree.end()) {
+		if(m_compare(*mine, *theirs) || m_compare(*theirs, *mine) ||
+		   mine.getCount() != theirs.getCount()) {
+			return(false);
+		}
+		++mine;
+		++theirs;
+	}
+	return(mine == end() && theirs == tree.end());
+}
+
+// inequality
+// preconditions:	no other thread is writing to either container.
+// postconditions:	the negation of operator== is returned
+//
+template<typename Key, typename Compare>
+bool BasicShardedBSTree<Key, Compare>::operator!=(const BasicShardedBSTree &tree) const {
+	return(!(*this == tree));
+}
+
+// shardOf: routing helper
+// preconditions:	none
+// postconditions:	the index of the shard owning data's range is returned
+//
+template<typename Key, typename Compare>
+size_t BasicShardedBSTree<Key, Compare>::shardOf(const Key &data) const {
+	return(upper_bound(m_boundaries.begin(), m_boundaries.end(), data, m_compare) - m_boundaries.begin());
+}
+
+// chooseBoundaries: construction helper
+// Picks shardCount - 1 evenly spaced keys from sorted as boundaries,
+// skipping repeats. With a small or repetitive sample some of the last
+// shards are left without a range.
+// preconditions:	sorted is in ascending order.
+// postconditions:	m_boundaries is replaced
+//
+template<typename Key, typename Compare>
+void BasicShardedBSTree<Key, Compare>::chooseBoundaries(const vector<Key> &sorted) {
+	m_boundaries.clear();
+	size_t shardCount = m_shards.size();
+	for(size_t i = 1; i < shardCount && !sorted.empty(); i++) {
+		const Key &candidate = sorted[i * sorted.size() / shardCount];
+		if(m_boundaries.empty() || m_compare(m_boundaries.back(), candidate)) {
+			m_boundaries.push_back(candidate);
+		}
+	}
+}
+
+// makeShards: construction helper
+// preconditions:	shardCount > 0
+// postconditions:	m_shards holds shardCount empty shards
+//
+template<typename Key, typename Compare>
+void BasicShardedBSTree<Key, Compare>::makeShards(int shardCount, BalancePolicy policy) {
+	for(int i = 0; i < shardCount; i++) {
+		m_shards.push_back(new Shard(policy));
+	}
+}
+
+// output
+// Prints the contents of the container to the ostream
+// preconditions:	tree must be a valid BasicShardedBSTree object (must not
+//					reference a dereferenced nullptr).
+// postconditions:	every key is printed in order, one per line, in the
+//					format: "m_item m_itemCount"
+//
+template<typename Key, typename Compare>
+ostream& operator<<(ostream &sout, const BasicShardedBSTree<Key, Compare> &tree) {
+	tree.write(sout);
+	return(sout);
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,389 @@
+// ShardedBSTree.h		Author: Sam Hoover
+// contains the declarations for the BasicShardedBSTree class template and the
+// ShardedBSTree type, a tree split by key range for parallel writers
+//
+#ifndef SHARDEDBSTREE_H
+#define SHARDEDBSTREE_H
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <mutex>
+#include <utility>
+#include <vector>
+#include "BSTree.h"
+#include "OutputBuffer.h"
+#include "TreeData.h"
+using namespace std;
+
+// BasicShardedBSTree
+// A container that splits the key space into key ranges and keeps each range
+// in its own BasicBSTree (a shard) guarded by its own mutex. The ranges are
+// given by m_boundaries: shard i holds the keys k with
+//			m_boundaries[i - 1] <= k < m_boundaries[i]
+// so point operations on keys in different shards never touch the same
+// nodes or lock and can run in parallel. Duplicate counts follow the rules
+// of BasicBSTree.
+//
+// Boundaries are chosen from a sample of expected keys when the container
+// is built, and can be recomputed from the actual contents by
+// rebalanceShards. Operations over the whole container (size, rank, select,
+// output, iteration and equality) visit the shards in key order, so their
+// results read as if from one tree.
+//
+template<typename Key, typename Compare = less<Key> >
+class BasicShardedBSTree {
+
+	// output
+	// Prints the contents of the container to the ostream
+	// preconditions:	this not equal to nullptr.
+	// postconditions:	every key is printed in order, one per line, in the
+	//					format: "m_item m_itemCount"
+	//
+	template<typename K, typename C>
+	friend ostream& operator<<(ostream &sout, const BasicShardedBSTree<K, C> &tree);
+
+	struct Shard;
+
+public:
+	// const_iterator
+	// A forward iterator that visits every key of every shard in ascending
+	// order. Any insert or remove invalidates it.
+	//
+	class const_iterator {
+		friend class BasicShardedBSTree;
+
+	public:
+		typedef forward_iterator_tag iterator_category;
+		typedef Key value_type;
+		typedef ptrdiff_t difference_type;
+		typedef const Key* pointer;
+		typedef const Key& reference;
+
+		// default constructor
+		// preconditions:	none
+		// postconditions:	creates an iterator that refers to no container
+		//
+		const_iterator();
+
+		// dereference
+		// preconditions:	this must not be an end iterator.
+		// postconditions:	the current key is returned
+		//
+		reference operator*() const;
+
+		// member access
+		// preconditions:	this must not be an end iterator.
+		// postconditions:	a pointer to the current key is returned
+		//
+		pointer operator->() const;
+
+		// getCount
+		// preconditions:	this must not be an end iterator.
+		// postconditions:	the number of occurrences of the current key is
+		//					returned
+		//
+		int getCount() const;
+
+		// pre-increment
+		// Moves to the next key, crossing into the next non-empty shard when
+		// the current one is finished.
+		// preconditions:	this must not be an end iterator.
+		// postconditions:	this refers to the next key or is the end iterator.
+		//					this is returned.
+		//
+		const_iterator& operator++();
+
+		// post-increment
+		// preconditions:	this must not be an end iterator.
+		// postconditions:	this is advanced; its old position is returned
+		//
+		const_iterator operator++(int);
+
+		// equality
+		// preconditions:	other must iterate over the same container.
+		// postconditions:	true is returned if both refer to the same key or
+		//					both are end iterators.
+		//
+		bool operator==(const const_iterator &other) const;
+
+		// inequality
+		// preconditions:	other must iterate over the same container.
+		// postconditions:	true is returned if the iterators differ.
+		//
+		bool operator!=(const const_iterator &other) const;
+
+	private:
+		// constructor(const BasicShardedBSTree *owner, size_t shard)
+		// preconditions:	shard <= the number of shards
+		// postconditions:	creates an iterator at the first key at or after
+		//					the start of shard
+		//
+		const_iterator(const BasicShardedBSTree *owner, size_t shard);
+
+		// skipEmpty: traversal helper
+		// preconditions:	none
+		// postconditions:	this refers to a key, or is the end iterator
+		//
+		void skipEmpty();
+
+		// m_owner
+		// the container being iterated
+		//
+		const BasicShardedBSTree *m_owner;
+
+		// m_shard
+		// the index of the current shard; the shard count at the end
+		//
+		size_t m_shard;
+
+		// m_current
+		// the position inside the current shard
+		//
+		typename BasicBSTree<Key, Compare>::const_iterator m_current;
+	};
+
+	// CONSTRUCTORS/DESTRUCTOR
+
+	// constructor(int shardCount, BalancePolicy policy)
+	// Until boundaries are chosen every key goes to the first shard.
+	// preconditions:	shardCount > 0
+	// postconditions:	Creates shardCount empty shards that apply policy
+	//
+	BasicShardedBSTree(int shardCount, BalancePolicy policy = UNBALANCED);
+
+	// constructor(InputIt begin, InputIt end, int shardCount, BalancePolicy)
+	// Chooses the boundaries so that the sample keys in [begin, end) would
+	// be spread evenly over the shards. The sample is not inserted.
+	// preconditions:	shardCount > 0; InputIt dereferences to Key
+	// postconditions:	Creates shardCount empty shards that apply policy
+	//
+	template<typename InputIt>
+	BasicShardedBSTree(InputIt begin, InputIt end, int shardCount, BalancePolicy policy = UNBALANCED);
+
+	// destructor
+	// preconditions:	no other thread is using the container.
+	// postconditions:	every shard and its nodes are deleted
+	//
+	~BasicShardedBSTree();
+
+	// MUTATORS
+
+	// insert(const Key &data)
+	// Inserts a copy of data into the shard that owns its range, following
+	// the rules of BasicBSTree::insert. Safe to call from any number of
+	// threads.
+	// preconditions:	data must be a valid Key object (must not reference
+	//					a dereferenced nullptr); this not equal to nullptr.
+	// postconditions:	If data does not already exist, a new node is inserted
+	//					and true is returned. Otherwise m_itemCount is
+	//					incremented by one and false is returned.
+	//
+	bool insert(const Key &data);
+
+	// insert(Key *data)
+	// Deprecated: use insert(const Key&) or emplace. The shard stores a copy of
+	// *data and data is never deleted by the tree.
+	// preconditions:	data must be a valid Key object not equal to nullptr;
+	//					this not equal to nullptr.
+	// postconditions:	the same as insert(*data); data is left to the caller.
+	//
+	bool insert(Key *data);
+
+	// emplace
+	// Constructs a Key from args and inserts it, following the same rules as
+	// insert. Safe to call from any number of threads.
+	// preconditions:	args must be valid arguments to a Key constructor;
+	//					this not equal to nullptr.
+	// postconditions:	true is returned if a new node was inserted, false if
+	//					an existing count was incremented.
+	//
+	template<typename... Args>
+	bool emplace(Args&&... args);
+
+	// remove
+	// Removes a Key object equal to data from the shard that owns its range,
+	// following the rules of BasicBSTree::remove. Safe to call from any number
+	// of threads.
+	// preconditions:	data must be a valid Key object (must not reference
+	//					a dereferenced nullptr); this not equal to nullptr.
+	// postconditions:	false is returned if data is not found; otherwise its
+	//					count is decremented or its node removed and true is
+	//					returned.
+	//
+	bool remove(const Key &data);
+
+	// makeEmpty
+	// Removes and deletes all nodes from every shard. The boundaries are
+	// kept.
+	// preconditions:	this not equal to nullptr.
+	// postconditions:	every shard is empty
+	//
+	void makeEmpty();
+
+	// rebalanceShards
+	// Recomputes the boundaries so that each shard holds about the same
+	// number of distinct keys, and moves every key to its new shard.
+	// preconditions:	no other thread is using the container.
+	// postconditions:	the container holds the same keys and counts, spread
+	//					evenly over the shards
+	//
+	void rebalanceShards();
+
+	// ACCESSORS
+
+	// retrieve
+	// Searches the shard that owns data's range.
+	// preconditions:	data must be a valid Key object (must not reference
+	//					a dereferenced nullptr); this not equal to nullptr.
+	// postconditions:	If data is found, a const pointer to the stored object
+	//					is returned, valid until that key is removed. If data
+	//					is not found then nullptr is returned.
+	//
+	const Key* retrieve(const Key &data) const;
+
+	// depth
+	// Finds the depth of data within the tree of its shard.
+	// preconditions:	data must be a valid Key object (must not reference
+	//					a dereferenced nullptr); this not equal to nullptr.
+	// postconditions:	the depth of data's node in its shard is returned, or
+	//					-1 if data is not found.
+	//
+	int depth(const Key &data) const;
+
+	// descendants
+	// Finds the number of descendants of data's node within the tree of its
+	// shard.
+	// preconditions:	data must be a valid Key object (must not reference
+	//					a dereferenced nullptr); this not equal to nullptr.
+	// postconditions:	the number of descendants is returned, or -1 if data
+	//					is not found.
+	//
+	int descendants(const Key &data) const;
+
+	// size
+	// preconditions:	this not equal to nullptr.
+	// postconditions:	the number of distinct keys in all shards is returned
+	//
+	int size() const;
+
+	// rank
+	// Counts the distinct keys ordered before data across all shards.
+	// preconditions:	data must be a valid Key object (must not reference
+	//					a dereferenced nullptr); this not equal to nullptr.
+	// postconditions:	the number of keys less than data is returned
+	//
+	int rank(const Key &data) const;
+
+	// select
+	// Finds the key with the given rank across all shards (0 is the
+	// smallest).
+	// preconditions:	this not equal to nullptr.
+	// postconditions:	If 0 <= index < size(), a const pointer to the key of
+	//					that rank is returned, else nullptr is returned.
+	//
+	const Key* select(int index) const;
+
+	// isEmpty
+	// preconditions:	this not equal to nullptr.
+	// postconditions:	true is returned if every shard is empty, else false
+	//
+	bool isEmpty() const;
+
+	// getShardCount
+	// preconditions:	none
+	// postconditions:	the number of shards is returned
+	//
+	int getShardCount() const;
+
+	// write
+	// Writes every shard in order to sout in the same format as operator<<.
+	// preconditions:	this not equal to nullptr.
+	// postconditions:	the contents of this are written to sout. false is
+	//					returned if sout failed.
+	//
+	bool write(ostream &sout) const;
+
+	// begin
+	// preconditions:	no other thread is writing to the container.
+	// postconditions:	an iterator to the smallest key is returned, or end()
+	//					if the container is empty.
+	//
+	const_iterator begin() const;
+
+	// end
+	// preconditions:	none
+	// postconditions:	the iterator one past the largest key is returned.
+	//
+	const_iterator end() const;
+
+	// OVERLOADED OPERATORS
+
+	// equality
+	// Compares the keys and counts of both containers in order, regardless
+	// of how each is split into shards.
+	// preconditions:	no other thread is writing to either container.
+	// postconditions:	true is returned if both hold the same keys with the
+	//					same counts, else false.
+	//
+	bool operator==(const BasicShardedBSTree &tree) const;
+
+	// inequality
+	// preconditions:	no other thread is writing to either container.
+	// postconditions:	the negation of operator== is returned
+	//
+	bool operator!=(const BasicShardedBSTree &tree) const;
+
+private:
+	// Shard
+	// One key range: its tree and the mutex that guards it.
+	//
+	struct Shard {
+		// constructor(BalancePolicy policy)
+		// preconditions:	none
+		// postconditions:	creates an empty shard applying policy
+		//
+		Shard(BalancePolicy policy);
+
+		mutable mutex m_lock;
+		BasicBSTree<Key, Compare> m_tree;
+	};
+
+	// copying a shared container is not supported
+	BasicShardedBSTree(const BasicShardedBSTree &tree);
+	const BasicShardedBSTree& operator=(const BasicShardedBSTree &tree);
+
+	// shardOf: routing helper
+	// preconditions:	none
+	// postconditions:	the index of the shard owning data's range is
+	//					returned
+	//
+	size_t shardOf(const Key &data) const;
+
+	// chooseBoundaries: construction helper
+	// Picks shardCount - 1 evenly spaced keys from sorted as boundaries,
+	// skipping repeats.
+	// preconditions:	sorted is in ascending order.
+	// postconditions:	m_boundaries is replaced
+	//
+	void chooseBoundaries(const vector<Key> &sorted);
+
+	// makeShards: construction helper
+	// preconditions:	shardCount > 0
+	// postconditions:	m_shards holds shardCount empty shards
+	//
+	void makeShards(int shardCount, BalancePolicy policy);
+
+	vector<Shard*> m_shards;
+	vector<Key> m_boundaries;
+	Compare m_compare;
+};
+
+// ShardedBSTree
+// the sharded container of TreeData objects
+//
+typedef BasicShardedBSTree<TreeData> ShardedBSTree;
+
+#include "ShardedBSTree.cpp"
+#endif
\ No newline at end of file
@@ -0,0 +1,30 @@
+// SnapshotHeader.cpp		Author: Sam Hoover
+// contains the definitions for the SnapshotHeader struct
+//
+#ifndef SNAPSHOTHEADER_CPP
+#define SNAPSHOTHEADER_CPP
+#include "SnapshotHeader.h"
+
+// checksum
+// Computes the 64-bit FNV-1a hash of length bytes at data.
+// preconditions:	data must point to at least length bytes.
+// postconditions:	the hash is returned
+//
+uint64_t SnapshotHeader::checksum(const char *data, size_t length) {
+	uint64_t hash = 14695981039346656037ULL;
+	for(size_t i = 0; i < length; i++) {
+		hash ^= static_cast<unsigned char>(data[i]);
+		hash *= 1099511628211ULL;
+	}
+	return(hash);
+}
+
+// payloadSize
+// preconditions:	none
+// postconditions:	the number of bytes that must follow the header is
+//					returned
+//
+uint64_t SnapshotHeader::payloadSize() const {
+	return(m_nodeCount * (m_keySize + sizeof(int32_t) + 1));
+}
+#endif
@@ -0,0 +1,98 @@
+// SnapshotHeader.h		Author: Sam Hoover
+// contains the declarations for the SnapshotHeader struct
+//
+#ifndef SNAPSHOTHEADER_H
+#define SNAPSHOTHEADER_H
+#include <cstddef>
+#include <cstdint>
+using namespace std;
+
+// SNAPSHOT_MAGIC
+// the first eight bytes of every snapshot file
+//
+const char SNAPSHOT_MAGIC[8] = { 'B', 'S', 'T', 'S', 'N', 'A', 'P', '\0' };
+
+// SNAPSHOT_VERSION
+// the layout version written by this code
+//
+const uint32_t SNAPSHOT_VERSION = 2;
+
+// SNAPSHOT_BYTE_ORDER
+// written in native byte order; a file from a machine of the other
+// endianness reads back a different value and is rejected
+//
+const uint32_t SNAPSHOT_BYTE_ORDER = 0x01020304;
+
+// SNAPSHOT_HAS_LEFT, SNAPSHOT_HAS_RIGHT
+// the bits of a node's shape byte
+//
+const unsigned char SNAPSHOT_HAS_LEFT = 1;
+const unsigned char SNAPSHOT_HAS_RIGHT = 2;
+
+// SnapshotHeader
+// The fixed-size header at the start of a BasicBSTree snapshot file. The
+// header is followed by three pointer-free arrays, each with m_nodeCount
+// entries in preorder:
+//		keys:	m_keySize bytes per node, as encoded by KeyTraits
+//		counts:	one int32_t m_itemCount per node
+//		shape:	one byte per node of SNAPSHOT_HAS_LEFT | SNAPSHOT_HAS_RIGHT
+// m_checksum covers every byte after the header. The header has padding
+// after m_policy, so writers value-initialize it to keep the bytes defined.
+//
+struct SnapshotHeader {
+	// checksum
+	// Computes the 64-bit FNV-1a hash of length bytes at data.
+	// preconditions:	data must point to at least length bytes.
+	// postconditions:	the hash is returned
+	//
+	static uint64_t checksum(const char *data, size_t length);
+
+	// payloadSize
+	// preconditions:	none
+	// postconditions:	the number of bytes that must follow the header is
+	//					returned
+	//
+	uint64_t payloadSize() const;
+
+	// m_magic
+	// always SNAPSHOT_MAGIC
+	//
+	char m_magic[8];
+
+	// m_version
+	// the layout version, SNAPSHOT_VERSION
+	//
+	uint32_t m_version;
+
+	// m_byteOrder
+	// SNAPSHOT_BYTE_ORDER as stored by the writer
+	//
+	uint32_t m_byteOrder;
+
+	// m_keySize
+	// the number of bytes each encoded key occupies
+	//
+	uint32_t m_keySize;
+
+	// m_keyTag
+	// KeyTraits<Key>::KEY_TAG of the saved tree's Key type
+	//
+	uint32_t m_keyTag;
+
+	// m_policy
+	// the BalancePolicy of the saved tree
+	//
+	uint32_t m_policy;
+
+	// m_nodeCount
+	// the number of nodes saved
+	//
+	uint64_t m_nodeCount;
+
+	// m_checksum
+	// checksum() of the payload
+	//
+	uint64_t m_checksum;
+};
+
+#endif